@@ -0,0 +1,534 @@
+#include "Advisor.h"
+
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+constexpr std::string_view degreeQuestions[degreeQuestionCount] = {
+    "Are you interested in learning multiple programming languages like Python, Java, or C++?",
+    "Do you want to design and implement algorithms to solve specific problems?",
+    "Are you inclined towards understanding the theory behind how computers process information?",
+    "Would you enjoy working on software that improves the performance of computer systems?",
+    "Are you more interested in developing apps or software rather than maintaining network systems?",
+    "Do you want to explore the mathematical foundations of computing, such as discrete mathematics and logic?",
+    "Are you interested in cybersecurity from a software development perspective rather than a network management one?",
+    "Do you want to research and innovate in fields like quantum computing or blockchain technology?",
+    "Are you less interested in tasks like configuring servers or managing databases?",
+    "Would you prefer to write code for developing new technologies rather than setting up existing ones?"
+};
+
+std::string_view GetDegreeQuestion(int question)
+{
+    return degreeQuestions[question];
+}
+
+QuestionnaireLogic::QuestionnaireLogic() : currentQuestion(0), answeredCount(0), answers(0)
+{
+}
+
+std::string_view QuestionnaireLogic::GetCurrentQuestion() const
+{
+    return IsFinished() ? std::string_view() : degreeQuestions[currentQuestion];
+}
+
+int QuestionnaireLogic::GetCurrentIndex() const
+{
+    return currentQuestion;
+}
+
+void QuestionnaireLogic::AnswerYes()
+{
+    Answer(true);
+}
+
+void QuestionnaireLogic::AnswerNo()
+{
+    Answer(false);
+}
+
+void QuestionnaireLogic::Answer(bool yes)
+{
+    const AnswerMask bit = static_cast<AnswerMask>(1u << currentQuestion);
+    answers = yes ? (answers | bit) : (answers & ~bit);
+    currentQuestion++;
+    // A fresh answer replaces whatever was waiting to be redone.
+    answeredCount = currentQuestion;
+}
+
+// Undo and redo only move the cursor: answers past it stay in the mask until overwritten.
+bool QuestionnaireLogic::Undo()
+{
+    if (!CanUndo()) {
+        return false;
+    }
+    currentQuestion--;
+    return true;
+}
+
+bool QuestionnaireLogic::Redo()
+{
+    if (!CanRedo()) {
+        return false;
+    }
+    currentQuestion++;
+    return true;
+}
+
+bool QuestionnaireLogic::CanUndo() const
+{
+    return currentQuestion > 0;
+}
+
+bool QuestionnaireLogic::CanRedo() const
+{
+    return currentQuestion < answeredCount;
+}
+
+bool QuestionnaireLogic::IsFinished() const
+{
+    return currentQuestion >= degreeQuestionCount;
+}
+
+// Only the answers before the cursor count; bits kept for redo are masked off.
+AnswerMask QuestionnaireLogic::GetAnswerMask() const
+{
+    return static_cast<AnswerMask>(answers & ((1u << currentQuestion) - 1));
+}
+
+
+const DegreeWeights* activeDegreeWeights = nullptr;
+
+// The built-in weights' outcome tables, worked out by the compiler from csWeights and
+// ctWeights by the same rules as ScoreDegreeOutcome. --check-tables compares the two.
+struct BuiltinDegreeTables
+{
+    DegreeOutcome outcomes[degreeAnswerCount];
+    double percentages[degreeAnswerCount * 2];
+};
+
+constexpr BuiltinDegreeTables BuildBuiltinDegreeTables()
+{
+    BuiltinDegreeTables tables{};
+    for (std::size_t mask = 0; mask < degreeAnswerCount; ++mask) {
+        int cs = 0;
+        int ct = 0;
+        for (int k = 0; k < degreeQuestionCount; ++k) {
+            if ((mask >> k) & 1) {
+                cs += csWeights[k];
+                ct += ctWeights[k];
+            }
+        }
+        // 0.0 / 0 is not a constant expression; x86 computes it as a NaN with the sign bit
+        // set, which prints as "-nan".
+        const int total = cs + ct;
+        const double noScore = -std::numeric_limits<double>::quiet_NaN();
+        const double csPercent = total == 0 ? noScore : static_cast<double>(cs) / total * 100;
+        const double ctPercent = total == 0 ? noScore : static_cast<double>(ct) / total * 100;
+        tables.percentages[mask * 2] = csPercent;
+        tables.percentages[mask * 2 + 1] = ctPercent;
+        tables.outcomes[mask].recommended = ct >= cs ? 1 : 0;
+        if ((total == 0 || cs == 0) && (total == 0 || ct == 0)) {
+            tables.outcomes[mask].fallback = OutcomeFallback::AllNo;
+        }
+        else if (csPercent == 100 && ctPercent == 100) {
+            tables.outcomes[mask].fallback = OutcomeFallback::AllYes;
+        }
+    }
+    return tables;
+}
+
+constexpr BuiltinDegreeTables builtinDegreeTables = BuildBuiltinDegreeTables();
+static_assert(builtinDegreeTables.outcomes[0].fallback == OutcomeFallback::AllNo, "no answers leaves nothing to recommend");
+
+DegreeWeights::DegreeWeights()
+    : names(std::begin(degreeNames), std::end(degreeNames)),
+      catalogIds{ DegreeId::ComputerScience, DegreeId::ComputerTechnology },
+      stride(degreeLaneCount)
+{
+    rows.assign(degreeQuestionCount * stride, 0);
+    for (int k = 0; k < degreeQuestionCount; ++k) {
+        rows[k * stride] = csWeights[k];
+        rows[k * stride + 1] = ctWeights[k];
+    }
+    outcomes.assign(std::begin(builtinDegreeTables.outcomes), std::end(builtinDegreeTables.outcomes));
+    percentages.assign(std::begin(builtinDegreeTables.percentages), std::end(builtinDegreeTables.percentages));
+}
+
+bool DegreeWeights::Load(const std::string& path, std::string& error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::vector<std::string> loadedNames;
+    std::vector<std::vector<int>> loadedRows;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        const std::string where = path + ": line " + std::to_string(lineNumber) + ": ";
+        if (loadedNames.empty()) {
+            std::size_t start = 0;
+            while (true) {
+                const std::size_t tab = line.find('\t', start);
+                loadedNames.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+                if (loadedNames.back().empty()) {
+                    error = where + "degree names must not be empty";
+                    return false;
+                }
+                if (tab == std::string::npos) {
+                    break;
+                }
+                start = tab + 1;
+            }
+            if (loadedNames.size() > maxDegreeCount) {
+                error = where + "at most " + std::to_string(maxDegreeCount) + " degrees are supported";
+                return false;
+            }
+            continue;
+        }
+        if (loadedRows.size() == degreeQuestionCount) {
+            error = where + "expected " + std::to_string(degreeQuestionCount) + " rows of weights, one per question";
+            return false;
+        }
+        std::istringstream fields(line);
+        std::vector<int> row;
+        int weight;
+        while (fields >> weight) {
+            row.push_back(weight);
+        }
+        if (!fields.eof() || row.size() != loadedNames.size()) {
+            error = where + "expected " + std::to_string(loadedNames.size()) + " integer weights";
+            return false;
+        }
+        loadedRows.push_back(std::move(row));
+    }
+    if (loadedRows.size() != degreeQuestionCount) {
+        error = path + ": expected degree names and " + std::to_string(degreeQuestionCount) + " rows of weights, one per question";
+        return false;
+    }
+
+    names = std::move(loadedNames);
+    catalogIds.assign(names.size(), DegreeId::Unlisted);
+    for (std::size_t d = 0; d < names.size(); ++d) {
+        FindDegreeId(names[d], catalogIds[d]);
+    }
+    stride = (names.size() + degreeLaneCount - 1) / degreeLaneCount * degreeLaneCount;
+    rows.assign(degreeQuestionCount * stride, 0);
+    for (int k = 0; k < degreeQuestionCount; ++k) {
+        std::copy(loadedRows[k].begin(), loadedRows[k].end(), rows.begin() + k * stride);
+    }
+    BuildOutcomes();
+    return true;
+}
+
+void DegreeWeights::BuildOutcomes()
+{
+    outcomes.resize(degreeAnswerCount);
+    percentages.resize(degreeAnswerCount * names.size());
+    for (std::size_t mask = 0; mask < degreeAnswerCount; ++mask) {
+        outcomes[mask] = ScoreDegreeOutcome(static_cast<AnswerMask>(mask), *this, percentages.data() + mask * names.size());
+    }
+}
+
+std::size_t DegreeWeights::DegreeCount() const
+{
+    return names.size();
+}
+
+const std::string& DegreeWeights::DegreeName(std::size_t degree) const
+{
+    return names[degree];
+}
+
+DegreeId DegreeWeights::CatalogId(std::size_t degree) const
+{
+    return catalogIds[degree];
+}
+
+int DegreeWeights::Weight(int question, std::size_t degree) const
+{
+    return rows[question * stride + degree];
+}
+
+std::size_t DegreeWeights::Stride() const
+{
+    return stride;
+}
+
+// The dot product of the answer bits with each degree's column, computed as a sum of the
+// rows of the questions answered "yes". A row is masked rather than skipped, so there is
+// no branch on the answers and each row is added a full vector at a time.
+void DegreeWeights::Score(AnswerMask answers, int* scores) const
+{
+    std::fill(scores, scores + stride, 0);
+    const int* row = rows.data();
+    for (int k = 0; k < degreeQuestionCount; ++k, row += stride) {
+        const int select = -((answers >> k) & 1);
+        for (std::size_t d = 0; d < stride; ++d) {
+            scores[d] += row[d] & select;
+        }
+    }
+}
+
+const DegreeOutcome& DegreeWeights::Outcome(AnswerMask answers) const
+{
+    return outcomes[answers & (degreeAnswerCount - 1)];
+}
+
+const double* DegreeWeights::Percentages(AnswerMask answers) const
+{
+    return percentages.data() + (answers & (degreeAnswerCount - 1)) * names.size();
+}
+
+// Each percentage is the degree's share of the total score; ties go to the later degree.
+DegreeOutcome ScoreDegreeOutcome(AnswerMask answers, const DegreeWeights& weights, double* percentages)
+{
+    std::vector<int> scores(weights.Stride());
+    weights.Score(answers, scores.data());
+    DegreeOutcome outcome{ 0, OutcomeFallback::None };
+    int totalScore = 0;
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        totalScore += scores[d];
+        if (scores[d] >= scores[outcome.recommended]) {
+            outcome.recommended = static_cast<std::uint8_t>(d);
+        }
+    }
+    bool allNo = true;
+    bool allYes = true;
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        percentages[d] = static_cast<double>(scores[d]) / totalScore * 100;
+        allNo = allNo && (std::isnan(percentages[d]) || percentages[d] == 0);
+        allYes = allYes && percentages[d] == 100;
+    }
+    outcome.fallback = allNo ? OutcomeFallback::AllNo : allYes ? OutcomeFallback::AllYes : OutcomeFallback::None;
+    return outcome;
+}
+
+const DegreeWeights& ActiveDegreeWeights()
+{
+    static const DegreeWeights builtin;
+    return activeDegreeWeights ? *activeDegreeWeights : builtin;
+}
+
+DegreeRecommendation::DegreeRecommendation(const std::vector<bool>& answers, const DegreeWeights& weights)
+    : DegreeRecommendation(PackAnswers(answers), weights)
+{
+}
+
+DegreeRecommendation::DegreeRecommendation(AnswerMask answers, const DegreeWeights& weights)
+    : weights(weights), answers(answers), outcome(weights.Outcome(answers))
+{
+}
+
+const std::string& DegreeRecommendation::GetRecommendedDegree() const
+{
+    return weights.DegreeName(outcome.recommended);
+}
+
+std::size_t DegreeRecommendation::GetRecommendedIndex() const
+{
+    return outcome.recommended;
+}
+
+OutcomeFallback DegreeRecommendation::GetFallback() const
+{
+    return outcome.fallback;
+}
+
+std::vector<int> DegreeRecommendation::GetScores() const
+{
+    std::vector<int> scores(weights.Stride());
+    weights.Score(answers, scores.data());
+    scores.resize(weights.DegreeCount());
+    return scores;
+}
+
+std::vector<double> DegreeRecommendation::GetDegreePercentages() const
+{
+    const double* percentages = weights.Percentages(answers);
+    return std::vector<double>(percentages, percentages + weights.DegreeCount());
+}
+
+AnswerMask PackAnswers(const std::vector<bool>& answers)
+{
+    AnswerMask mask = 0;
+    for (std::size_t k = 0; k < answers.size() && k < degreeQuestionCount; ++k) {
+        mask |= static_cast<AnswerMask>(answers[k]) << k;
+    }
+    return mask;
+}
+
+// Scores a whole cohort without going through main(). Each degree's column is filled for
+// every student before the next, and each question contributes bit * weight, so the loops
+// have no data-dependent branches and the compiler can vectorize them across students.
+// Output vectors are only ever grown, so callers that reuse one DegreeScoreBatch across
+// calls do not allocate after the first batch.
+void ScoreDegreeBatch(const AnswerMask* masks, std::size_t count, DegreeScoreBatch& results, const DegreeWeights& weights)
+{
+    const std::size_t degreeCount = weights.DegreeCount();
+    if (results.scores.size() < degreeCount) {
+        results.scores.resize(degreeCount);
+        results.percentages.resize(degreeCount);
+    }
+    for (std::size_t d = 0; d < degreeCount; ++d) {
+        if (results.scores[d].size() < count) {
+            results.scores[d].resize(count);
+            results.percentages[d].resize(count);
+        }
+    }
+    if (results.totals.size() < count) {
+        results.totals.resize(count);
+        results.recommended.resize(count);
+    }
+
+    // Students go in blocks small enough that the best score so far stays on the stack.
+    const std::size_t blockSize = 256;
+    int best[blockSize];
+    for (std::size_t first = 0; first < count; first += blockSize) {
+        const std::size_t blockCount = std::min(blockSize, count - first);
+        const AnswerMask* blockMasks = masks + first;
+        int* totals = results.totals.data() + first;
+        std::uint8_t* recommended = results.recommended.data() + first;
+        for (std::size_t d = 0; d < degreeCount; ++d) {
+            int weightColumn[degreeQuestionCount];
+            for (int k = 0; k < degreeQuestionCount; ++k) {
+                weightColumn[k] = weights.Weight(k, d);
+            }
+            int* scores = results.scores[d].data() + first;
+            for (std::size_t n = 0; n < blockCount; ++n) {
+                const int mask = blockMasks[n];
+                int total = 0;
+                for (int k = 0; k < degreeQuestionCount; ++k) {
+                    total += ((mask >> k) & 1) * weightColumn[k];
+                }
+                scores[n] = total;
+            }
+            if (d == 0) {
+                for (std::size_t n = 0; n < blockCount; ++n) {
+                    totals[n] = scores[n];
+                    best[n] = scores[n];
+                    recommended[n] = 0;
+                }
+                continue;
+            }
+            // Ties go to the later degree, as in DegreeRecommendation.
+            for (std::size_t n = 0; n < blockCount; ++n) {
+                const bool better = scores[n] >= best[n];
+                totals[n] += scores[n];
+                best[n] = better ? scores[n] : best[n];
+                recommended[n] = better ? static_cast<std::uint8_t>(d) : recommended[n];
+            }
+        }
+    }
+
+    // Same arithmetic as DegreeRecommendation::GetDegreePercentages, including NaN when
+    // every answer was "no".
+    const int* totals = results.totals.data();
+    for (std::size_t d = 0; d < degreeCount; ++d) {
+        const int* scores = results.scores[d].data();
+        double* percentages = results.percentages[d].data();
+        for (std::size_t n = 0; n < count; ++n) {
+            percentages[n] = static_cast<double>(scores[n]) / totals[n] * 100;
+        }
+    }
+}
+
+MajorSelectionLogic::MajorSelectionLogic(DegreeId degree) : degree(degree)
+{
+    auto set = [this](MajorId major, std::vector<MajorQuestion> questions) {
+        majors.push_back(major);
+        majorQuestions[Index(major)] = std::move(questions);
+    };
+    if (degree == DegreeId::ComputerScience) {
+        set(MajorId::SoftwareEngineering, {{"Are you interested in developing and maintaining software applications?", 1}, {"Do you enjoy working in teams to solve complex problems?", 1}});
+        set(MajorId::BusinessInformationSystems, {{"Are you interested in the intersection of technology and business processes?", 1}, {"Do you like analyzing data to improve business strategies?", 1}});
+        set(MajorId::KnowledgeEngineering, {{"Are you interested in designing systems that can mimic human decision-making?", 1}, {"Do you enjoy working with AI and machine learning technologies?", 1}});
+        set(MajorId::HighPerformanceComputing, {{"Are you interested in optimizing software to run efficiently on powerful computer systems?", 1}, {"Do you like solving computational challenges?", 1}});
+    }
+    else if (degree == DegreeId::ComputerTechnology) {
+        set(MajorId::EmbeddedSystems, {{"Do you enjoy working with both hardware and software components?", 1}, {"Are you interested in building devices that interact with the physical world?", 1}});
+        set(MajorId::CommunicationAndNetworking, {{"Are you interested in understanding how data is transmitted over networks?", 1}, {"Do you enjoy configuring and managing network systems?", 1}});
+        set(MajorId::CyberSecurity, {{"Are you interested in learning how to protect systems from cyber threats and attacks?", 1}, {"Do you enjoy problem-solving and critical thinking in high-pressure situations?", 1}});
+    }
+}
+
+const std::vector<MajorId>& MajorSelectionLogic::GetMajors() const
+{
+    return majors;
+}
+
+const std::vector<MajorQuestion>& MajorSelectionLogic::GetMajorQuestions(MajorId major) const
+{
+    return majorQuestions[Index(major)];
+}
+
+
+// The two degrees' majors never change, so every session shares one MajorSelectionLogic per degree.
+const MajorSelectionLogic& GetMajorSelection(DegreeId degree)
+{
+    StageTimer timer(Stage::MajorSelection);
+    static const MajorSelectionLogic selections[degreeIdCount + 1] = { MajorSelectionLogic(DegreeId::ComputerScience),
+        MajorSelectionLogic(DegreeId::ComputerTechnology), MajorSelectionLogic(DegreeId::Unlisted) };
+    return selections[Index(degree)];
+}
+
+// Whether `input` is `lowercase` in any mix of cases; `lowercase` must be lowercase ASCII letters.
+bool EqualsIgnoringCase(std::string_view input, std::string_view lowercase)
+{
+    if (input.size() != lowercase.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        if ((input[i] | 0x20) != lowercase[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Answer ClassifyAnswer(std::string_view input)
+{
+    if (EqualsIgnoringCase(input, "y") || EqualsIgnoringCase(input, "yes")) {
+        return Answer::Yes;
+    }
+    if (EqualsIgnoringCase(input, "n") || EqualsIgnoringCase(input, "no")) {
+        return Answer::No;
+    }
+    return EqualsIgnoringCase(input, "back") ? Answer::Back : Answer::Invalid;
+}
+
+bool isValidInput(std::string_view input) {
+    return ClassifyAnswer(input) != Answer::Invalid;
+}
+bool isPositiveAnswer(std::string_view input) {
+    return ClassifyAnswer(input) == Answer::Yes;
+}
+
+
+int getValidIntInput(int min, int max) {
+    int choice;
+    while (true) {
+        if (std::cin >> choice && choice >= min && choice <= max) {
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            return choice;
+        }
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        std::cout << "Invalid input. Please enter a number between " << min << " and " << max << ": ";
+    }
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "CatalogIds.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Degree questionnaire answers packed one bit per question: bit k holds the answer to question k.
+typedef std::uint16_t AnswerMask;
+
+const int degreeQuestionCount = 10;
+// Every possible AnswerMask of a finished questionnaire.
+const std::size_t degreeAnswerCount = std::size_t(1) << degreeQuestionCount;
+
+// One questionnaire in progress. The question text is shared by every session, and the
+// answers so far live in a single AnswerMask, so a session is a few bytes and never
+// touches std::cin; the caller decides where answers come from.
+class QuestionnaireLogic
+{
+public:
+    QuestionnaireLogic();
+    std::string_view GetCurrentQuestion() const;
+    int GetCurrentIndex() const;
+    void AnswerYes();
+    void AnswerNo();
+    bool Undo();
+    bool Redo();
+    bool CanUndo() const;
+    bool CanRedo() const;
+    bool IsFinished() const;
+    AnswerMask GetAnswerMask() const;
+
+private:
+    void Answer(bool yes);
+
+    std::uint8_t currentQuestion;
+    std::uint8_t answeredCount; // answers recorded, including ones undone but still redoable
+    AnswerMask answers;
+};
+
+std::string_view GetDegreeQuestion(int question);
+
+// Points a "yes" to each degree question adds to the Computer Science and Computer Technology
+// scores; these are the built-in weights used when no weight file is loaded.
+const int csWeights[degreeQuestionCount] = { 2, 2, 0, 2, 1, 1, 0, 0, 0, 2 };
+const int ctWeights[degreeQuestionCount] = { 0, 0, 2, 0, 0, 1, 2, 2, 2, 0 };
+
+// The fallback the advisor offers after a questionnaire: every score came to nothing, or
+// every one came to the most it could.
+enum class OutcomeFallback : std::uint8_t
+{
+    None,
+    AllNo,
+    AllYes
+};
+
+// Everything the advisor does with a finished degree questionnaire besides printing the
+// percentages.
+struct DegreeOutcome
+{
+    std::uint8_t recommended;  // degree index
+    OutcomeFallback fallback;
+};
+
+// Degree scores are added a row at a time, with each row padded to a whole number of
+// these lanes so the additions vectorize.
+const std::size_t degreeLaneCount = 8;
+const std::size_t maxDegreeCount = 255;
+
+// A questions x degrees weight matrix: a "yes" to question k adds Weight(k, d) to degree d.
+// The file form is a tab-separated header of degree names followed by one row of weights
+// per question; blank lines and lines starting with '#' are skipped.
+//
+// With only degreeAnswerCount possible answer masks, the outcome and percentages of every
+// one are worked out up front: at compile time for the built-in weights, on Load for a
+// weight file. Outcome and Percentages are then a single indexed load.
+class DegreeWeights
+{
+public:
+    DegreeWeights();
+    bool Load(const std::string& path, std::string& error);
+
+    std::size_t DegreeCount() const;
+    const std::string& DegreeName(std::size_t degree) const;
+    // Unlisted for a degree from a weight file that is not in the catalog table.
+    DegreeId CatalogId(std::size_t degree) const;
+    int Weight(int question, std::size_t degree) const;
+    // Scores are written to Stride() entries; the ones past DegreeCount() are zero.
+    std::size_t Stride() const;
+    void Score(AnswerMask answers, int* scores) const;
+
+    const DegreeOutcome& Outcome(AnswerMask answers) const;
+    // DegreeCount() percentages; NaN for every degree when no answer scored.
+    const double* Percentages(AnswerMask answers) const;
+
+private:
+    void BuildOutcomes();
+
+    std::vector<std::string> names;
+    std::vector<DegreeId> catalogIds;
+    std::size_t stride;
+    std::vector<int> rows;  // degreeQuestionCount rows of `stride` weights
+    std::vector<DegreeOutcome> outcomes;  // one per answer mask
+    std::vector<double> percentages;      // DegreeCount() per answer mask
+};
+
+// Scores `answers` from the weight matrix itself rather than the precomputed tables,
+// writing DegreeCount() percentages; the tables are built from, and checked against, this.
+DegreeOutcome ScoreDegreeOutcome(AnswerMask answers, const DegreeWeights& weights, double* percentages);
+
+// The weights loaded at startup, or the built-in ones.
+extern const DegreeWeights* activeDegreeWeights;
+const DegreeWeights& ActiveDegreeWeights();
+
+// Ties go to the later degree, as they always went to Computer Technology over Computer Science.
+class DegreeRecommendation
+{
+public:
+    DegreeRecommendation(AnswerMask answers, const DegreeWeights& weights = ActiveDegreeWeights());
+    DegreeRecommendation(const std::vector<bool>& answers, const DegreeWeights& weights = ActiveDegreeWeights());
+    const std::string& GetRecommendedDegree() const;
+    std::size_t GetRecommendedIndex() const;
+    OutcomeFallback GetFallback() const;
+    std::vector<int> GetScores() const;
+    // One per degree; NaN for every degree when no answer scored.
+    std::vector<double> GetDegreePercentages() const;
+
+private:
+    const DegreeWeights& weights;
+    AnswerMask answers;
+    const DegreeOutcome& outcome;
+};
+
+// Results of scoring many answer masks at once: one column per degree, one entry per
+// student in input order.
+struct DegreeScoreBatch
+{
+    std::vector<std::vector<int>> scores;
+    std::vector<std::vector<double>> percentages;
+    std::vector<int> totals;
+    std::vector<std::uint8_t> recommended;  // degree index
+};
+
+AnswerMask PackAnswers(const std::vector<bool>& answers);
+void ScoreDegreeBatch(const AnswerMask* masks, std::size_t count, DegreeScoreBatch& results,
+    const DegreeWeights& weights = ActiveDegreeWeights());
+
+// A "yes" adds `weight` to its major's score.
+struct MajorQuestion
+{
+    std::string text;
+    int weight;
+};
+
+class MajorSelectionLogic
+{
+public:
+    explicit MajorSelectionLogic(DegreeId degree);
+    const std::vector<MajorId>& GetMajors() const;
+    // Empty for a major of another degree.
+    const std::vector<MajorQuestion>& GetMajorQuestions(MajorId major) const;
+
+private:
+    DegreeId degree;
+    std::vector<MajorId> majors;
+    std::vector<MajorQuestion> majorQuestions[majorIdCount];
+};
+
+// An Unlisted degree has no majors.
+const MajorSelectionLogic& GetMajorSelection(DegreeId degree);
+
+// A reply to a y/n/back question. Matching ignores case and copies nothing.
+enum class Answer : std::uint8_t
+{
+    Invalid,
+    Yes,   // "y" or "yes"
+    No,    // "n" or "no"
+    Back
+};
+
+Answer ClassifyAnswer(std::string_view input);
+bool isValidInput(std::string_view input);
+bool isPositiveAnswer(std::string_view input);
+int getValidIntInput(int min, int max);
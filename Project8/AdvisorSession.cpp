@@ -0,0 +1,689 @@
+#include "AdvisorSession.h"
+
+#include "Analytics.h"
+#include "Catalog.h"
+#include "Display.h"
+#include "Instrumentation.h"
+#include "MajorRanking.h"
+#include "Messages.h"
+#include "Screen.h"
+#include "SessionExport.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <ostream>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+AdvisorSession::AdvisorSession()
+    : state(State::MainMenu), recommendedDegree(0), chosenDegree(0), scholarshipMajor(0),
+      majorQuestion(0), recommendedMajor(0), foundScholarships(false), rerunningMajors(false),
+      restarted(false), majorAnswers(0), result()
+{
+    result.startTime = SessionClock();
+}
+
+void AdvisorSession::Start(std::ostream& out)
+{
+    PromptMainMenu(out);
+}
+
+bool AdvisorSession::IsFinished() const
+{
+    return state == State::Finished;
+}
+
+bool AdvisorSession::ExpectsAnswer() const
+{
+    return state == State::DegreeQuestion || state == State::MajorQuestion;
+}
+
+std::uint32_t AdvisorSession::CheckpointLayout()
+{
+    const AdvisorSession session;
+    const char* base = reinterpret_cast<const char*>(&session);
+    std::uint32_t hash = 2166136261u;  // FNV-1a over each value's four bytes
+    const auto mix = [&hash](std::size_t value) {
+        for (int k = 0; k < 4; ++k) {
+            hash = (hash ^ ((value >> (8 * k)) & 0xFF)) * 16777619u;
+        }
+    };
+    const auto member = [&](const auto& field) {
+        mix(static_cast<std::size_t>(reinterpret_cast<const char*>(&field) - base));
+        mix(sizeof(field));
+    };
+    mix(checkpointLayoutVersion);
+    mix(sizeof(AdvisorSession));
+    mix(static_cast<std::size_t>(State::Finished));
+    member(session.state);
+    member(session.questionnaire);
+    member(session.recommendedDegree);
+    member(session.chosenDegree);
+    member(session.scholarshipMajor);
+    member(session.majorQuestion);
+    member(session.recommendedMajor);
+    member(session.foundScholarships);
+    member(session.rerunningMajors);
+    member(session.restarted);
+    member(session.majorAnswers);
+    const SessionResult& result = session.result;
+    member(result.startTime);
+    member(result.endTime);
+    member(result.majorAnswers);
+    member(result.degreeAnswers);
+    member(result.finalMajor);
+    member(result.recommendedDegree);
+    member(result.chosenDegree);
+    member(result.degreeFallback);
+    member(result.majorFallback);
+    member(result.degreeAnswered);
+    member(result.degreeRecommended);
+    member(result.degreeChosen);
+    member(result.majorsAnswered);
+    member(result.majorChosen);
+    member(result.scholarshipQueryCount);
+    member(result.scholarshipMajors);
+    member(result.scholarshipYears);
+    return hash;
+}
+
+bool AdvisorSession::Restarted() const
+{
+    return restarted;
+}
+
+const SessionResult& AdvisorSession::Result() const
+{
+    return result;
+}
+
+void AdvisorSession::Finish()
+{
+    if (state != State::Finished) {
+        state = State::Finished;
+        Complete();
+    }
+}
+
+void AdvisorSession::Complete()
+{
+    result.endTime = SessionClock();
+    RecordSessionResult(result);
+}
+
+// Mirrors getValidIntInput: a leading integer in range is accepted and the rest is ignored.
+bool AdvisorSession::ReadChoice(std::string_view token, int min, int max, int& choice, std::ostream& out) const
+{
+    const char* first = token.data();
+    const char* last = token.data() + token.size();
+    if (first != last && *first == '+') {
+        first++;
+    }
+    if (std::from_chars(first, last, choice).ec == std::errc() && choice >= min && choice <= max) {
+        return true;
+    }
+    WriteMessage(out, MessageId::InvalidNumber, { min, max });
+    return false;
+}
+
+const MajorSelectionLogic& AdvisorSession::Majors() const
+{
+    return GetMajorSelection(ActiveDegreeWeights().CatalogId(chosenDegree));
+}
+
+MajorId AdvisorSession::RecommendedMajor() const
+{
+    return Majors().GetMajors()[recommendedMajor];
+}
+
+void AdvisorSession::HandleLine(std::string_view line, std::ostream& out)
+{
+    StageTimer lineTimer(Stage::SessionLine);
+    restarted = false;
+    // Like std::cin >> answer, only the first word counts and blank lines are skipped.
+    const std::size_t begin = line.find_first_not_of(" \t\r\n");
+    if (begin == std::string_view::npos || state == State::Finished) {
+        return;
+    }
+    const std::size_t end = line.find_first_of(" \t\r\n", begin);
+    const std::string_view token = line.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+
+    StageTimer stepTimer(state == State::DegreeQuestion ? Stage::Questionnaire
+        : state == State::MajorQuestion ? Stage::MajorQuestions : Stage::Menu);
+    int choice = 0;
+    Answer answer = Answer::Invalid;
+    switch (state) {
+    case State::MainMenu:
+        if (!ReadChoice(token, 1, 4, choice, out)) {
+            return;
+        }
+        if (choice == 1) {
+            displayBachelorDegrees(out);
+            PromptMainMenu(out);
+        }
+        else if (choice == 2) {
+            questionnaire = QuestionnaireLogic();
+            state = State::DegreeQuestion;
+            PromptDegreeQuestion(out);
+        }
+        else if (choice == 3) {
+            WriteMessage(out, MessageId::DegreeInfoMenu);
+            state = State::DegreeInfoChoice;
+        }
+        else {
+            WriteMessage(out, MessageId::Goodbye);
+            Finish();
+        }
+        break;
+
+    case State::DegreeInfoChoice:
+        if (!ReadChoice(token, 1, 2, choice, out)) {
+            return;
+        }
+        WriteMessage(out, MessageId::DegreeInfoTitle, { Name(static_cast<DegreeId>(choice - 1)) });
+        DisplayDegreeInfo(static_cast<DegreeId>(choice - 1), out);
+        PromptMainMenu(out);
+        break;
+
+    case State::DegreeQuestion:
+        answer = ClassifyAnswer(token);
+        if (answer == Answer::Invalid) {
+            WriteMessage(out, MessageId::InvalidAnswer);
+            return;
+        }
+        if (answer == Answer::Back) {
+            if (questionnaire.Undo()) {
+                CountDegreeUndo(questionnaire.GetCurrentIndex());
+            }
+        }
+        else if (answer == Answer::Yes) {
+            questionnaire.AnswerYes();
+        }
+        else {
+            questionnaire.AnswerNo();
+        }
+        if (questionnaire.IsFinished()) {
+            FinishDegreeQuestions(out);
+        }
+        else {
+            PromptDegreeQuestion(out);
+        }
+        break;
+
+    case State::DegreeFallbackChoice:
+        if (!ReadChoice(token, 1, static_cast<int>(ActiveDegreeWeights().DegreeCount()), choice, out)) {
+            return;
+        }
+        recommendedDegree = static_cast<std::uint8_t>(choice - 1);
+        PromptExplore(out);
+        break;
+
+    case State::ExploreChoice:
+        if (!ReadChoice(token, 1, 2, choice, out)) {
+            return;
+        }
+        if (choice == 1) {
+            chosenDegree = recommendedDegree;
+            result.chosenDegree = chosenDegree;
+            result.degreeChosen = true;
+            ShowMajors(out);
+        }
+        else {
+            WriteMessage(out, MessageId::OtherDegreePrompt);
+            PromptDegreeList(out);
+            state = State::OtherDegreeChoice;
+        }
+        break;
+
+    case State::OtherDegreeChoice:
+        if (!ReadChoice(token, 1, static_cast<int>(ActiveDegreeWeights().DegreeCount()), choice, out)) {
+            return;
+        }
+        chosenDegree = static_cast<std::uint8_t>(choice - 1);
+        result.chosenDegree = chosenDegree;
+        result.degreeChosen = true;
+        ShowMajors(out);
+        break;
+
+    case State::ScholarshipMenu:
+        if (!ReadChoice(token, 1, 2, choice, out)) {
+            return;
+        }
+        if (choice == 1) {
+            WriteMessage(out, MessageId::ScholarshipMajorPrompt);
+            state = State::ScholarshipMajorChoice;
+        }
+        else {
+            if (foundScholarships) {
+                WriteMessage(out, MessageId::ProceedingToMajors);
+            }
+            StartMajorQuestions(false, out);
+        }
+        break;
+
+    case State::ScholarshipMajorChoice:
+        if (!ReadChoice(token, 1, static_cast<int>(Majors().GetMajors().size()), choice, out)) {
+            return;
+        }
+        scholarshipMajor = static_cast<std::uint8_t>(choice - 1);
+        WriteMessage(out, MessageId::ScholarshipYearPrompt);
+        state = State::ScholarshipYearChoice;
+        break;
+
+    case State::ScholarshipYearChoice: {
+        if (!ReadChoice(token, 1, 4, choice, out)) {
+            return;
+        }
+        const MajorId major = Majors().GetMajors()[scholarshipMajor];
+        DisplayScholarships(major, choice, out);
+        if (result.scholarshipQueryCount < sessionScholarshipQueryLimit) {
+            result.scholarshipMajors[result.scholarshipQueryCount] = static_cast<std::uint8_t>(Index(major));
+            result.scholarshipYears[result.scholarshipQueryCount] = static_cast<std::uint8_t>(choice);
+        }
+        if (result.scholarshipQueryCount < UINT8_MAX) {
+            result.scholarshipQueryCount++;
+        }
+        foundScholarships = true;
+        PromptScholarshipMenu(out);
+        break;
+    }
+
+    case State::MajorQuestion:
+        answer = ClassifyAnswer(token);
+        if (answer == Answer::Invalid) {
+            WriteMessage(out, MessageId::InvalidAnswer);
+            return;
+        }
+        if (answer == Answer::Back) {
+            if (majorQuestion > 0) {
+                majorQuestion--;
+                CountMajorUndo(MajorQuestionRange().first + majorQuestion);
+            }
+            PromptMajorQuestion(out);
+            return;
+        }
+        if (answer == Answer::Yes) {
+            majorAnswers |= std::uint64_t(1) << majorQuestion;
+        }
+        else {
+            majorAnswers &= ~(std::uint64_t(1) << majorQuestion);
+        }
+        majorQuestion++;
+        if (majorQuestion == MajorQuestionRange().second - MajorQuestionRange().first) {
+            FinishMajorQuestions(out);
+        }
+        else {
+            PromptMajorQuestion(out);
+        }
+        break;
+
+    case State::MajorFallbackChoice:
+        if (!ReadChoice(token, 1, static_cast<int>(Majors().GetMajors().size()), choice, out)) {
+            return;
+        }
+        recommendedMajor = static_cast<std::uint8_t>(choice - 1);
+        result.finalMajor = static_cast<std::uint16_t>(GetMajorRanking().DegreeMajors(
+            ActiveDegreeWeights().CatalogId(chosenDegree)).first + recommendedMajor);
+        result.majorChosen = true;
+        CountMajorRecommended(result.finalMajor);
+        PromptNextStep(out);
+        break;
+
+    case State::NextStepMenu:
+        if (!ReadChoice(token, 1, 7, choice, out)) {
+            return;
+        }
+        if (choice == 1) {
+            WriteMessage(out, MessageId::MajorInfoTitle, { Name(RecommendedMajor()) });
+            DisplayMajorInfo(RecommendedMajor(), out);
+            PromptNextStep(out);
+        }
+        else if (choice == 2) {
+            WriteMessage(out, MessageId::RoadmapTitle, { Name(RecommendedMajor()) });
+            out << GetMajorRoadmap(RecommendedMajor()) << "\n";
+            WriteMessage(out, MessageId::CareerGuide, { Name(RecommendedMajor()) });
+            PromptNextStep(out);
+        }
+        else if (choice == 3) {
+            StartMajorQuestions(true, out);
+        }
+        else if (choice == 4) {
+            // Starting over reuses this session instead of growing the stack like main() does.
+            Complete();
+            *this = AdvisorSession();
+            restarted = true;
+            PromptMainMenu(out);
+        }
+        else if (choice == 5) {
+            WriteMessage(out, MessageId::Opportunity, { GetMajorOpportunity(RecommendedMajor()) });
+            PromptNextStep(out);
+        }
+        else if (choice == 6) {
+            WriteMessage(out, MessageId::SubjectYearMenu, { Name(RecommendedMajor()) });
+            state = State::SubjectYearChoice;
+        }
+        else {
+            WriteMessage(out, MessageId::Goodbye);
+            Finish();
+        }
+        break;
+
+    case State::SubjectYearChoice:
+        if (!ReadChoice(token, 1, 4, choice, out)) {
+            return;
+        }
+        WriteMessage(out, MessageId::SubjectsTitle, { Name(RecommendedMajor()), choice });
+        for (const auto& subject : getSubjects(RecommendedMajor(), choice)) {
+            out << "- " << subject << "\n";
+        }
+        PromptNextStep(out);
+        break;
+
+    case State::Finished:
+        break;
+    }
+}
+
+void AdvisorSession::Reprompt(std::ostream& out)
+{
+    switch (state) {
+    case State::MainMenu:
+        WriteMessage(out, MessageId::MainMenu);
+        break;
+    case State::DegreeInfoChoice:
+        WriteMessage(out, MessageId::DegreeInfoMenu);
+        break;
+    case State::DegreeQuestion:
+        PromptDegreeQuestion(out);
+        break;
+    case State::DegreeFallbackChoice:
+        WriteMessage(out, MessageId::DegreeFallbackPrompt);
+        PromptDegreeList(out);
+        break;
+    case State::ExploreChoice:
+        WriteMessage(out, MessageId::RecommendedDegree, { ActiveDegreeWeights().DegreeName(recommendedDegree) });
+        break;
+    case State::OtherDegreeChoice:
+        WriteMessage(out, MessageId::OtherDegreePrompt);
+        PromptDegreeList(out);
+        break;
+    case State::ScholarshipMenu:
+        WriteMessage(out, MessageId::ScholarshipMenu);
+        break;
+    case State::ScholarshipMajorChoice:
+        WriteMessage(out, MessageId::ScholarshipMajorPrompt);
+        break;
+    case State::ScholarshipYearChoice:
+        WriteMessage(out, MessageId::ScholarshipYearPrompt);
+        break;
+    case State::MajorQuestion:
+        PromptMajorQuestion(out);
+        break;
+    case State::MajorFallbackChoice:
+        PromptMajorFallback(out);
+        break;
+    case State::NextStepMenu:
+        PromptNextStep(out);
+        break;
+    case State::SubjectYearChoice:
+        WriteMessage(out, MessageId::SubjectYearMenu, { Name(RecommendedMajor()) });
+        break;
+    case State::Finished:
+        break;
+    }
+}
+
+void AdvisorSession::PromptMainMenu(std::ostream& out)
+{
+    WriteMessage(out, MessageId::MainMenu);
+    state = State::MainMenu;
+}
+
+void AdvisorSession::PromptDegreeQuestion(std::ostream& out)
+{
+    WriteMessage(out, MessageId::DegreeQuestionPrompt,
+        { MessageText(DegreeQuestionMessage(questionnaire.GetCurrentIndex())) });
+}
+
+void AdvisorSession::FinishDegreeQuestions(std::ostream& out)
+{
+    StageTimer scoringTimer(Stage::DegreeScoring);
+    const DegreeWeights& weights = ActiveDegreeWeights();
+    const DegreeOutcome& outcome = weights.Outcome(questionnaire.GetAnswerMask());
+    const double* percentages = weights.Percentages(questionnaire.GetAnswerMask());
+    recommendedDegree = outcome.recommended;
+    result.degreeAnswers = questionnaire.GetAnswerMask();
+    result.degreeAnswered = true;
+    result.degreeFallback = outcome.fallback;
+    result.recommendedDegree = recommendedDegree;
+    result.degreeRecommended = outcome.fallback == OutcomeFallback::None;
+    scoringTimer.Stop();
+    CountEvent(AnalyticsEvent::DegreeQuestionnaire);
+    CountDegreePercentages(percentages, weights.DegreeCount());
+
+    WriteMessage(out, MessageId::DegreeResultsTitle);
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        out << std::fixed << std::setprecision(1);
+        WriteMessage(out, MessageId::DegreePercentage, { weights.DegreeName(d), percentages[d] });
+    }
+
+    if (outcome.fallback == OutcomeFallback::AllNo) {
+        CountEvent(AnalyticsEvent::DegreeAllNo);
+        WriteMessage(out, MessageId::DegreeAllNo);
+    }
+    else if (outcome.fallback == OutcomeFallback::AllYes) {
+        CountEvent(AnalyticsEvent::DegreeAllYes);
+        WriteMessage(out, MessageId::DegreeAllYes);
+    }
+    else {
+        PromptExplore(out);
+        return;
+    }
+    WriteMessage(out, MessageId::DegreeFallbackPrompt);
+    PromptDegreeList(out);
+    state = State::DegreeFallbackChoice;
+}
+
+void AdvisorSession::PromptDegreeList(std::ostream& out)
+{
+    const DegreeWeights& weights = ActiveDegreeWeights();
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        out << d + 1 << ". " << weights.DegreeName(d) << "\n";
+    }
+    WriteMessage(out, MessageId::ChoicePrompt, { weights.DegreeCount() });
+}
+
+void AdvisorSession::PromptExplore(std::ostream& out)
+{
+    const std::string& degree = ActiveDegreeWeights().DegreeName(recommendedDegree);
+    CountDegreeRecommended(recommendedDegree);
+    WriteMessage(out, MessageId::RecommendedDegree, { degree });
+    state = State::ExploreChoice;
+}
+
+void AdvisorSession::ShowMajors(std::ostream& out)
+{
+    if (Majors().GetMajors().empty()) {
+        WriteMessage(out, MessageId::NoMajorsListed, { ActiveDegreeWeights().DegreeName(chosenDegree) });
+        PromptDegreeList(out);
+        state = State::OtherDegreeChoice;
+        return;
+    }
+    WriteMessage(out, MessageId::PossibleMajorsTitle, { ActiveDegreeWeights().DegreeName(chosenDegree) });
+    for (const auto& major : Majors().GetMajors()) {
+        out << "- " << Name(major) << "\n";
+    }
+    foundScholarships = false;
+    PromptScholarshipMenu(out);
+}
+
+void AdvisorSession::PromptScholarshipMenu(std::ostream& out)
+{
+    WriteMessage(out, MessageId::ScholarshipMenu);
+    state = State::ScholarshipMenu;
+}
+
+void AdvisorSession::StartMajorQuestions(bool rerun, std::ostream& out)
+{
+    majorQuestion = 0;
+    majorAnswers = 0;
+    rerunningMajors = rerun;
+    state = State::MajorQuestion;
+    PromptMajorQuestion(out);
+}
+
+// The chosen degree's major questions, as question ids in GetMajorRanking().
+std::pair<std::uint32_t, std::uint32_t> AdvisorSession::MajorQuestionRange() const
+{
+    const MajorRanking& ranking = GetMajorRanking();
+    const auto majors = ranking.DegreeMajors(ActiveDegreeWeights().CatalogId(chosenDegree));
+    if (majors.first == majors.second) {
+        return { 0, 0 };
+    }
+    return { ranking.MajorQuestions(majors.first).first, ranking.MajorQuestions(majors.second - 1).second };
+}
+
+void AdvisorSession::PromptMajorQuestion(std::ostream& out)
+{
+    const std::uint32_t question = MajorQuestionRange().first + majorQuestion;
+    const MessageId message = MajorQuestionMessage(question);
+    WriteMessage(out, MessageId::MajorQuestionPrompt,
+        { message == MessageId::Count ? GetMajorRanking().QuestionText(question) : MessageText(message) });
+}
+
+void AdvisorSession::FinishMajorQuestions(std::ostream& out)
+{
+    StageTimer scoringTimer(Stage::MajorScoring);
+    const MajorRanking& ranking = GetMajorRanking();
+    const auto majors = ranking.DegreeMajors(ActiveDegreeWeights().CatalogId(chosenDegree));
+    const MajorOutcome outcome = ranking.Outcome(majors, majorAnswers);
+    recommendedMajor = static_cast<std::uint8_t>(outcome.major - majors.first);
+    result.majorAnswers = majorAnswers;
+    result.majorsAnswered = true;
+    result.majorFallback = rerunningMajors ? OutcomeFallback::None : outcome.fallback;
+    scoringTimer.Stop();
+    CountEvent(AnalyticsEvent::MajorQuestionnaire);
+
+    if (!rerunningMajors && outcome.fallback == OutcomeFallback::AllNo) {
+        CountEvent(AnalyticsEvent::MajorAllNo);
+        WriteMessage(out, MessageId::MajorAllNo, { ActiveDegreeWeights().DegreeName(chosenDegree) });
+        PromptMajorFallback(out);
+    }
+    else if (!rerunningMajors && outcome.fallback == OutcomeFallback::AllYes) {
+        CountEvent(AnalyticsEvent::MajorAllYes);
+        WriteMessage(out, MessageId::MajorAllYes, { ActiveDegreeWeights().DegreeName(chosenDegree) });
+        PromptMajorFallback(out);
+    }
+    else {
+        result.finalMajor = outcome.major;
+        result.majorChosen = true;
+        CountMajorRecommended(outcome.major);
+        WriteMessage(out, MessageId::RecommendedMajor, { Name(RecommendedMajor()) });
+        PromptNextStep(out);
+    }
+}
+
+void AdvisorSession::PromptMajorFallback(std::ostream& out)
+{
+    const auto& majors = Majors().GetMajors();
+    for (std::size_t i = 0; i < majors.size(); ++i) {
+        out << i + 1 << ". " << Name(majors[i]) << "\n";
+    }
+    WriteMessage(out, MessageId::ChoicePrompt, { majors.size() });
+    state = State::MajorFallbackChoice;
+}
+
+void AdvisorSession::PromptNextStep(std::ostream& out)
+{
+    WriteMessage(out, MessageId::NextStepMenu, { Name(RecommendedMajor()) });
+    state = State::NextStepMenu;
+}
+
+// The resident set size of this process in bytes, or 0 where it cannot be read.
+std::size_t ResidentBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    const bool read = std::fscanf(file, "%lu %lu", &size, &resident) == 2;
+    std::fclose(file);
+    return read ? resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#endif
+}
+
+// Allocator and page-cache noise stays well under this; a leak of even a few bytes a round
+// does not, over a soak of any length.
+const std::size_t soakGrowthLimit = 1024 * 1024;
+
+int SoakRestarts(std::uint64_t cycles)
+{
+    // Menu choices in the order one round meets them: take the questionnaire, explore the
+    // recommended degree, go on to the major questions, then go back to the degree questions.
+    // Each questionnaire gets one "yes", to its first question, so neither ties and falls
+    // back to a list.
+    static const std::string_view choices[] = { "2", "1", "2", "4" };
+    const std::string_view menu = MessageText(MessageId::MainMenu);
+    const std::uint64_t warmup = std::min<std::uint64_t>(cycles, std::max<std::uint64_t>(1000, cycles / 100));
+    const std::uint64_t reportEvery = std::max<std::uint64_t>(1, cycles / 10);
+
+    ScreenStream screen;
+    AdvisorSession session;
+    session.Start(screen);
+    std::size_t settled = 0;
+    std::size_t peak = 0;
+    for (std::uint64_t cycle = 1; cycle <= cycles; ++cycle) {
+        std::size_t choice = 0;
+        bool yes = true;
+        while (choice < std::size(choices)) {
+            screen.Clear();
+            if (session.ExpectsAnswer()) {
+                session.HandleLine(yes ? "y" : "n", screen);
+                yes = false;
+            }
+            else {
+                session.HandleLine(choices[choice++], screen);
+                yes = true;
+            }
+        }
+        const std::string_view view = screen.View();
+        if (view.size() < menu.size() || view.substr(view.size() - menu.size()) != menu) {
+            std::cerr << "Round " << cycle << " did not end at the main menu.\n";
+            return 1;
+        }
+        if (cycle == warmup) {
+            settled = ResidentBytes();
+        }
+        if (cycle >= warmup && (cycle % reportEvery == 0 || cycle == cycles)) {
+            const std::size_t resident = ResidentBytes();
+            peak = std::max(peak, resident);
+            std::cout << "cycles=" << cycle << " rss_kb=" << resident / 1024 << "\n";
+        }
+    }
+    // Once the first rounds have touched every page they need, a round should cost nothing.
+    const std::size_t growth = peak > settled ? peak - settled : 0;
+    std::cout << "settled_rss_kb=" << settled / 1024 << " peak_rss_kb=" << peak / 1024 << " growth_kb=" << growth / 1024 << "\n";
+    return growth > soakGrowthLimit ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Advisor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Scholarship lookups past this many in one pass are counted but not kept.
+const std::size_t sessionScholarshipQueryLimit = 4;
+
+// What one pass through the advisor decided, kept as the session goes and handed to
+// RecordSessionResult when the student exits or starts over. Fields not reached yet keep
+// their zero values, with the flags saying which are set.
+struct SessionResult
+{
+    std::int64_t startTime;      // nanoseconds since the Unix epoch
+    std::int64_t endTime;
+    std::uint64_t majorAnswers;  // bit q is the answer to the chosen degree's q-th major question
+    AnswerMask degreeAnswers;
+    std::uint16_t finalMajor;    // id in GetMajorRanking()
+    std::uint8_t recommendedDegree;  // index into ActiveDegreeWeights()
+    std::uint8_t chosenDegree;
+    OutcomeFallback degreeFallback;
+    OutcomeFallback majorFallback;
+    bool degreeAnswered;
+    bool degreeRecommended;
+    bool degreeChosen;
+    bool majorsAnswered;
+    bool majorChosen;
+    std::uint8_t scholarshipQueryCount;  // every lookup, including ones past the limit
+    std::uint8_t scholarshipMajors[sessionScholarshipQueryLimit];  // MajorId
+    std::uint8_t scholarshipYears[sessionScholarshipQueryLimit];
+};
+
+// Bumped when a member of AdvisorSession, SessionResult or QuestionnaireLogic changes what
+// it means without changing the layout, so journals checkpointed under the old meaning
+// are refused.
+const std::uint32_t checkpointLayoutVersion = 1;
+
+// The advisor flow from main() as a non-blocking state machine, so one process can run
+// many sessions side by side. HandleLine consumes one line of input and writes the whole
+// reply, ending with the next prompt, to `out`. A session owns no heap memory.
+class AdvisorSession
+{
+public:
+    AdvisorSession();
+    void Start(std::ostream& out);
+    void HandleLine(std::string_view line, std::ostream& out);
+    // Writes the prompt waiting for input again, as when a session is restored from a
+    // checkpoint; nothing is counted and the state is unchanged.
+    void Reprompt(std::ostream& out);
+    // Ends the session where it stands, as exiting does, so what it got to is recorded once.
+    void Finish();
+    bool IsFinished() const;
+    // Whether the prompt waiting for input asks for a y/n/back answer rather than a menu number.
+    bool ExpectsAnswer() const;
+    // Whether the last line went back to the degree questions, which finishes this session
+    // and starts the next one in its place.
+    bool Restarted() const;
+    const SessionResult& Result() const;
+    // Changes whenever the bytes a checkpoint copies would be read differently: with
+    // checkpointLayoutVersion, the offset and size of every member, and the number of states.
+    static std::uint32_t CheckpointLayout();
+
+private:
+    enum class State : std::uint8_t
+    {
+        MainMenu,
+        DegreeInfoChoice,
+        DegreeQuestion,
+        DegreeFallbackChoice,
+        ExploreChoice,
+        OtherDegreeChoice,
+        ScholarshipMenu,
+        ScholarshipMajorChoice,
+        ScholarshipYearChoice,
+        MajorQuestion,
+        MajorFallbackChoice,
+        NextStepMenu,
+        SubjectYearChoice,
+        Finished
+    };
+
+    bool ReadChoice(std::string_view token, int min, int max, int& choice, std::ostream& out) const;
+    const MajorSelectionLogic& Majors() const;
+    MajorId RecommendedMajor() const;
+    void PromptMainMenu(std::ostream& out);
+    void PromptDegreeQuestion(std::ostream& out);
+    void FinishDegreeQuestions(std::ostream& out);
+    void PromptDegreeList(std::ostream& out);
+    void PromptExplore(std::ostream& out);
+    void ShowMajors(std::ostream& out);
+    void PromptScholarshipMenu(std::ostream& out);
+    void StartMajorQuestions(bool rerun, std::ostream& out);
+    std::pair<std::uint32_t, std::uint32_t> MajorQuestionRange() const;
+    void PromptMajorQuestion(std::ostream& out);
+    void FinishMajorQuestions(std::ostream& out);
+    void PromptMajorFallback(std::ostream& out);
+    void PromptNextStep(std::ostream& out);
+    void Complete();
+
+    State state;
+    QuestionnaireLogic questionnaire;
+    std::uint8_t recommendedDegree;  // index into ActiveDegreeWeights()
+    std::uint8_t chosenDegree;
+    std::uint8_t scholarshipMajor;
+    std::uint8_t majorQuestion;      // next major question, counted from the degree's first
+    std::uint8_t recommendedMajor;
+    bool foundScholarships;
+    bool rerunningMajors;
+    bool restarted;
+    std::uint64_t majorAnswers;      // bit q is the answer to major question q; a degree has at most 64
+    SessionResult result;
+};
+
+// Goes round the whole flow `cycles` times in one session, from the main menu through both
+// questionnaires to "Go back to degree question", and reports the resident set size as it
+// goes. Returns 1 if a round goes astray or memory keeps growing after the first rounds.
+int SoakRestarts(std::uint64_t cycles);
@@ -0,0 +1,234 @@
+#include "Analytics.h"
+
+#include "Advisor.h"
+#include "MajorRanking.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <ostream>
+
+const std::uint32_t analyticsVersion = 1;
+
+// One thread's counts. Only its own thread writes to it, so a count is a relaxed load and
+// store rather than a locked add; the atomics are there so a snapshot may read them
+// while they change. Blocks are aligned to cache lines, so two threads counting never
+// fight over a line.
+struct alignas(64) AnalyticsBlock
+{
+    std::atomic<std::uint64_t> events[static_cast<std::size_t>(AnalyticsEvent::Count)];
+    std::atomic<std::uint64_t> degreeRecommended[maxDegreeCount];
+    std::atomic<std::uint64_t> degreePercentages[maxDegreeCount][analyticsPercentBuckets];
+    std::atomic<std::uint64_t> degreeUndone[degreeQuestionCount];
+    std::atomic<std::uint64_t> majorRecommended[analyticsMajorSlots];
+    std::atomic<std::uint64_t> majorUndone[analyticsQuestionSlots];
+    AnalyticsBlock* next;
+};
+
+// Every block ever made. Blocks are pushed on the front and never freed, so the counts
+// of a thread that has finished still show up in later snapshots.
+std::atomic<AnalyticsBlock*> analyticsBlocks{ nullptr };
+
+thread_local AnalyticsBlock* localAnalytics = nullptr;
+thread_local bool analyticsPaused = false;
+
+std::string analyticsPath;
+volatile std::sig_atomic_t analyticsSnapshotRequested = 0;
+
+AnalyticsBlock* LocalAnalytics()
+{
+    if (analyticsPaused) {
+        return nullptr;
+    }
+    if (!localAnalytics) {
+        AnalyticsBlock* block = new AnalyticsBlock();
+        block->next = analyticsBlocks.load(std::memory_order_relaxed);
+        while (!analyticsBlocks.compare_exchange_weak(block->next, block, std::memory_order_release,
+            std::memory_order_relaxed)) {
+        }
+        localAnalytics = block;
+    }
+    return localAnalytics;
+}
+
+void Bump(std::atomic<std::uint64_t>& counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void CountEvent(AnalyticsEvent event)
+{
+    if (AnalyticsBlock* block = LocalAnalytics()) {
+        Bump(block->events[static_cast<std::size_t>(event)]);
+    }
+}
+
+void CountDegreePercentages(const double* percentages, std::size_t count)
+{
+    AnalyticsBlock* block = LocalAnalytics();
+    if (!block) {
+        return;
+    }
+    for (std::size_t d = 0; d < count && d < maxDegreeCount; ++d) {
+        if (std::isnan(percentages[d])) {
+            continue;
+        }
+        const int bucket = std::min(static_cast<int>(analyticsPercentBuckets) - 1,
+            std::max(0, static_cast<int>(percentages[d] / 10)));
+        Bump(block->degreePercentages[d][bucket]);
+    }
+}
+
+void CountDegreeRecommended(std::size_t degree)
+{
+    AnalyticsBlock* block = LocalAnalytics();
+    if (block && degree < maxDegreeCount) {
+        Bump(block->degreeRecommended[degree]);
+    }
+}
+
+void CountDegreeUndo(std::size_t question)
+{
+    AnalyticsBlock* block = LocalAnalytics();
+    if (block && question < static_cast<std::size_t>(degreeQuestionCount)) {
+        Bump(block->degreeUndone[question]);
+    }
+}
+
+void CountMajorRecommended(std::uint16_t major)
+{
+    AnalyticsBlock* block = LocalAnalytics();
+    if (block && major < analyticsMajorSlots) {
+        Bump(block->majorRecommended[major]);
+    }
+}
+
+void CountMajorUndo(std::uint32_t question)
+{
+    AnalyticsBlock* block = LocalAnalytics();
+    if (block && question < analyticsQuestionSlots) {
+        Bump(block->majorUndone[question]);
+    }
+}
+
+AnalyticsPause::AnalyticsPause() : wasPaused(analyticsPaused)
+{
+    analyticsPaused = true;
+}
+
+AnalyticsPause::~AnalyticsPause()
+{
+    analyticsPaused = wasPaused;
+}
+
+bool AnalyticsPaused()
+{
+    return analyticsPaused;
+}
+
+// Adds up one counter across every thread's block.
+template <typename Select>
+std::uint64_t SumAnalytics(Select select)
+{
+    std::uint64_t total = 0;
+    for (AnalyticsBlock* block = analyticsBlocks.load(std::memory_order_acquire); block; block = block->next) {
+        total += select(*block).load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void WriteAnalyticsSnapshot(std::ostream& out)
+{
+    static const char* const eventNames[] = { "degree_questionnaires", "degree_all_no", "degree_all_yes",
+        "major_questionnaires", "major_all_no", "major_all_yes" };
+    static_assert(std::size(eventNames) == static_cast<std::size_t>(AnalyticsEvent::Count), "every event needs a name");
+
+    out << "advisor_analytics\t" << analyticsVersion << "\n";
+    for (std::size_t e = 0; e < std::size(eventNames); ++e) {
+        out << "event\t" << eventNames[e] << "\t"
+            << SumAnalytics([e](AnalyticsBlock& block) -> auto& { return block.events[e]; }) << "\n";
+    }
+
+    const DegreeWeights& weights = ActiveDegreeWeights();
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        out << "degree_recommended\t" << weights.DegreeName(d) << "\t"
+            << SumAnalytics([d](AnalyticsBlock& block) -> auto& { return block.degreeRecommended[d]; }) << "\n";
+    }
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        for (std::size_t b = 0; b < analyticsPercentBuckets; ++b) {
+            out << "degree_percentage\t" << weights.DegreeName(d) << "\t";
+            if (b + 1 < analyticsPercentBuckets) {
+                out << b * 10 << "-" << b * 10 + 10;
+            }
+            else {
+                out << "100";
+            }
+            out << "\t" << SumAnalytics([d, b](AnalyticsBlock& block) -> auto& { return block.degreePercentages[d][b]; })
+                << "\n";
+        }
+    }
+    for (int q = 0; q < degreeQuestionCount; ++q) {
+        out << "degree_question_undone\t" << q + 1 << "\t" << GetDegreeQuestion(q) << "\t"
+            << SumAnalytics([q](AnalyticsBlock& block) -> auto& { return block.degreeUndone[q]; }) << "\n";
+    }
+
+    const MajorRanking& ranking = GetMajorRanking();
+    for (std::uint16_t major = 0; major < ranking.MajorCount() && major < analyticsMajorSlots; ++major) {
+        out << "major_recommended\t" << ranking.MajorDegree(major) << "\t" << ranking.MajorName(major) << "\t"
+            << SumAnalytics([major](AnalyticsBlock& block) -> auto& { return block.majorRecommended[major]; }) << "\n";
+    }
+    for (std::uint16_t major = 0; major < ranking.MajorCount(); ++major) {
+        const auto questions = ranking.MajorQuestions(major);
+        for (std::uint32_t q = questions.first; q < questions.second && q < analyticsQuestionSlots; ++q) {
+            out << "major_question_undone\t" << ranking.MajorDegree(major) << "\t" << ranking.MajorName(major) << "\t"
+                << q - questions.first + 1 << "\t" << ranking.QuestionText(q) << "\t"
+                << SumAnalytics([q](AnalyticsBlock& block) -> auto& { return block.majorUndone[q]; }) << "\n";
+        }
+    }
+}
+
+bool WriteAnalyticsSnapshot(const std::string& path, std::string& error)
+{
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            error = "Cannot write " + temporary;
+            return false;
+        }
+        WriteAnalyticsSnapshot(file);
+        file.flush();
+        if (!file) {
+            error = "Cannot write " + temporary;
+            return false;
+        }
+    }
+    return RenameOver(temporary, path, error);
+}
+
+void RequestAnalyticsSnapshot(int)
+{
+    analyticsSnapshotRequested = 1;
+}
+
+void EnableAnalyticsSignal()
+{
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, RequestAnalyticsSnapshot);
+#endif
+}
+
+void SaveAnalytics()
+{
+    if (analyticsPath.empty()) {
+        return;
+    }
+    std::string error;
+    if (!WriteAnalyticsSnapshot(analyticsPath, error)) {
+        std::cerr << error << "\n";
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Outcome counts of every advisor session in this process: which degrees and majors are
+// recommended, how the degree percentages fall, how often the all-no and all-yes
+// fallbacks fire, and which questions students step back over.
+//
+// Each thread counts into its own block, so the Count functions are a plain load and
+// store with no lock and no shared cache line. A snapshot adds up every thread's block
+// at the moment it is taken; it may miss counts made while it runs.
+enum class AnalyticsEvent : std::uint8_t
+{
+    DegreeQuestionnaire,  // finished degree questionnaires
+    DegreeAllNo,
+    DegreeAllYes,
+    MajorQuestionnaire,   // finished rounds of major questions, reruns included
+    MajorAllNo,
+    MajorAllYes,
+    Count
+};
+
+// Degree percentages are counted in tenths, with exactly 100% as its own bucket.
+const std::size_t analyticsPercentBuckets = 11;
+// Majors and major questions past these ids go uncounted.
+const std::size_t analyticsMajorSlots = 256;
+const std::size_t analyticsQuestionSlots = 2048;
+
+void CountEvent(AnalyticsEvent event);
+// One percentage per degree of ActiveDegreeWeights(); NaN ones are not counted.
+void CountDegreePercentages(const double* percentages, std::size_t count);
+void CountDegreeRecommended(std::size_t degree);
+// `question` is the one whose answer a "back" withdrew.
+void CountDegreeUndo(std::size_t question);
+// Majors and questions are ids in GetMajorRanking().
+void CountMajorRecommended(std::uint16_t major);
+void CountMajorUndo(std::uint32_t question);
+
+// Stops this thread counting while it lives, for replaying a session that was already
+// counted the first time round.
+class AnalyticsPause
+{
+public:
+    AnalyticsPause();
+    ~AnalyticsPause();
+    AnalyticsPause(const AnalyticsPause&) = delete;
+    AnalyticsPause& operator=(const AnalyticsPause&) = delete;
+
+private:
+    bool wasPaused;
+};
+
+// Whether this thread is inside an AnalyticsPause.
+bool AnalyticsPaused();
+
+// Writes a snapshot as tab-separated lines: a version line, then one line per count with
+// its labels first and the count last. Every known degree, major and question gets a
+// line, zero or not, in catalog order, so two snapshots line up.
+void WriteAnalyticsSnapshot(std::ostream& out);
+// Replaces `path` as a whole, so a reader never sees half a snapshot.
+bool WriteAnalyticsSnapshot(const std::string& path, std::string& error);
+
+// Where snapshots go when one is asked for; empty means analytics are not saved.
+extern std::string analyticsPath;
+// Set by SIGUSR1 once EnableAnalyticsSignal has run; long-running modes poll it.
+extern volatile std::sig_atomic_t analyticsSnapshotRequested;
+void EnableAnalyticsSignal();
+// Writes to analyticsPath if it is set, reporting failures on std::cerr.
+void SaveAnalytics();
@@ -0,0 +1,543 @@
+
+#include "Advisor.h"
+#include "AdvisorSession.h"
+#include "Catalog.h"
+#include "ContentSearch.h"
+#include "Curriculum.h"
+#include "Display.h"
+#include "Instrumentation.h"
+#include "MajorRanking.h"
+#include "ScholarshipStore.h"
+#include "Screen.h"
+#include "Simulation.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Swallows everything written to it, so display code can be timed without a terminal.
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Results are folded in here so the optimizer cannot drop the work being measured.
+volatile std::uint64_t benchmarkSink = 0;
+
+// Each benchmark body does `itemsPerIteration` units of work per call.
+struct Benchmark
+{
+    const char* name;
+    std::size_t itemsPerIteration;
+    void (*body)();
+};
+
+const std::vector<AnswerMask>& BenchmarkMasks()
+{
+    static const std::vector<AnswerMask> masks = [] {
+        std::vector<AnswerMask> result(1024);
+        std::uint32_t state = 12345;
+        for (AnswerMask& mask : result) {
+            state = state * 1103515245u + 12345u;
+            mask = static_cast<AnswerMask>((state >> 16) & ((1u << degreeQuestionCount) - 1));
+        }
+        return result;
+    }();
+    return masks;
+}
+
+const std::vector<MajorId>& BenchmarkMajors()
+{
+    static const std::vector<MajorId> majors = [] {
+        std::vector<MajorId> result;
+        for (std::size_t d = 0; d < degreeIdCount; ++d) {
+            const std::vector<MajorId>& majors = GetMajorSelection(static_cast<DegreeId>(d)).GetMajors();
+            result.insert(result.end(), majors.begin(), majors.end());
+        }
+        return result;
+    }();
+    return majors;
+}
+
+// Takes the degree questionnaire with one "back", picks a major, reads its
+// information and roadmap, then exits.
+constexpr std::string_view sessionScript =
+    "2\ny\nn\ny\nback\ny\nn\ny\nn\ny\nn\ny\nn\n"
+    "1\n2\ny\nn\nn\nn\nn\nn\n"
+    "1\n1\n"
+    "2\n1\n2\n"
+    "7\n";
+
+void BenchDegreeRecommendationMask()
+{
+    std::uint64_t total = 0;
+    for (const AnswerMask mask : BenchmarkMasks()) {
+        const DegreeRecommendation recommendation(mask);
+        total += recommendation.GetRecommendedDegree().size();
+    }
+    benchmarkSink += total;
+}
+
+void BenchDegreeRecommendationVector()
+{
+    static const std::vector<std::vector<bool>> answers = [] {
+        std::vector<std::vector<bool>> result;
+        for (const AnswerMask mask : BenchmarkMasks()) {
+            std::vector<bool> unpacked(degreeQuestionCount);
+            for (int i = 0; i < degreeQuestionCount; ++i) {
+                unpacked[i] = (mask >> i) & 1;
+            }
+            result.push_back(unpacked);
+        }
+        return result;
+    }();
+
+    std::uint64_t total = 0;
+    for (const std::vector<bool>& unpacked : answers) {
+        const DegreeRecommendation recommendation(unpacked);
+        total += recommendation.GetRecommendedDegree().size();
+    }
+    benchmarkSink += total;
+}
+
+void BenchScoreDegreeBatch()
+{
+    static DegreeScoreBatch results;
+    const std::vector<AnswerMask>& masks = BenchmarkMasks();
+    ScoreDegreeBatch(masks.data(), masks.size(), results);
+    benchmarkSink += results.recommended[masks.size() - 1];
+}
+
+// Random answers to every major question for a cohort of BenchmarkMasks().size() students.
+const std::vector<std::uint64_t>& BenchmarkMajorAnswers()
+{
+    static const std::vector<std::uint64_t> answers = [] {
+        const MajorRanking& ranking = GetMajorRanking();
+        std::vector<std::uint64_t> result(BenchmarkMasks().size() * ranking.AnswerWords());
+        std::uint64_t state = 88172645463325252ull;
+        for (std::uint64_t& word : result) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            word = state;
+        }
+        return result;
+    }();
+    return answers;
+}
+
+void BenchRankMajorsBatch()
+{
+    static MajorRankBatch results;
+    RankMajorsBatch(GetMajorRanking(), BenchmarkMajorAnswers().data(), BenchmarkMasks().size(), 3, results);
+    benchmarkSink += results.ranked[results.ranked.size() - 1].major;
+}
+
+const std::uint64_t simulationBenchSamples = 1 << 16;
+
+void BenchSimulateSamples()
+{
+    static SimulationSetup setup;
+    static SimulationCounts counts;
+    static std::uint64_t first = 0;
+    if (counts.degreeMasks.empty()) {
+        std::string error;
+        setup.Prepare(ActiveDegreeWeights(), GetMajorRanking(), error);
+        counts.Reset(setup);
+    }
+    SimulateSamples(setup, ActiveDegreeWeights(), first, simulationBenchSamples, counts);
+    first += simulationBenchSamples;
+    benchmarkSink += counts.degreeMasks[0];
+}
+
+const std::uint32_t benchmarkCourseCount = 4096;
+
+// A made-up curriculum of benchmarkCourseCount courses over the catalog years, each
+// needing up to three courses of earlier years and listed by one or two majors.
+const Curriculum& BenchmarkCurriculum()
+{
+    static const Curriculum curriculum = [] {
+        Curriculum result;
+        std::uint64_t state = 0x9E3779B97F4A7C15ull;
+        auto next = [&state]() {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        };
+        const std::uint32_t perYear = benchmarkCourseCount / catalogYearCount;
+        for (std::uint32_t c = 0; c < benchmarkCourseCount; ++c) {
+            const int year = static_cast<int>(std::min<std::uint32_t>(c / perYear, catalogYearCount - 1)) + 1;
+            const std::string name = "Course " + std::to_string(c);
+            result.AddOffering(static_cast<MajorId>(next() % majorIdCount), year, name);
+            result.AddOffering(static_cast<MajorId>(next() % majorIdCount), year, name);
+            if (year > 1) {
+                std::string error;
+                for (int p = 0; p < 3; ++p) {
+                    const std::uint32_t prerequisite = static_cast<std::uint32_t>(next() % ((year - 1) * perYear));
+                    result.AddPrerequisite(name, "Course " + std::to_string(prerequisite), error);
+                }
+            }
+        }
+        std::string error;
+        result.Build(error);
+        return result;
+    }();
+    return curriculum;
+}
+
+void BenchCurriculumBefore()
+{
+    static std::vector<std::uint32_t> ids;
+    const Curriculum& curriculum = BenchmarkCurriculum();
+    std::uint64_t total = 0;
+    for (std::uint32_t c = 0; c < benchmarkCourseCount; c += 64) {
+        curriculum.Courses(curriculum.Before(c), ids);
+        total += ids.size();
+    }
+    benchmarkSink += total;
+}
+
+void BenchCurriculumCommon()
+{
+    static std::vector<std::uint32_t> ids;
+    static std::vector<std::uint64_t> courses(BenchmarkCurriculum().Words());
+    const Curriculum& curriculum = BenchmarkCurriculum();
+    std::uint64_t total = 0;
+    for (std::size_t a = 0; a < majorIdCount; ++a) {
+        for (std::size_t b = 0; b < majorIdCount; ++b) {
+            curriculum.Common(static_cast<MajorId>(a), static_cast<MajorId>(b), courses.data());
+            curriculum.Courses(courses.data(), ids);
+            total += ids.size();
+        }
+    }
+    benchmarkSink += total;
+}
+
+void BenchCurriculumEarliest()
+{
+    const Curriculum& curriculum = BenchmarkCurriculum();
+    std::uint64_t total = 0;
+    for (std::uint32_t c = 0; c < benchmarkCourseCount; ++c) {
+        total += curriculum.EarliestYear(c);
+    }
+    benchmarkSink += total;
+}
+
+void BenchMajorSelectionComputerScience()
+{
+    const MajorSelectionLogic logic(DegreeId::ComputerScience);
+    benchmarkSink += logic.GetMajors().size();
+}
+
+void BenchMajorSelectionComputerTechnology()
+{
+    const MajorSelectionLogic logic(DegreeId::ComputerTechnology);
+    benchmarkSink += logic.GetMajors().size();
+}
+
+void BenchGetMajorQuestions()
+{
+    std::uint64_t total = 0;
+    for (std::size_t d = 0; d < degreeIdCount; ++d) {
+        const MajorSelectionLogic& logic = GetMajorSelection(static_cast<DegreeId>(d));
+        for (const MajorId major : logic.GetMajors()) {
+            total += logic.GetMajorQuestions(major)[0].text.size();
+        }
+    }
+    benchmarkSink += total;
+}
+
+void BenchGetMajorInfo()
+{
+    std::uint64_t total = 0;
+    for (const MajorId major : BenchmarkMajors()) {
+        total += GetMajorInfo(major).size();
+    }
+    benchmarkSink += total;
+}
+
+void BenchGetMajorRoadmap()
+{
+    std::uint64_t total = 0;
+    for (const MajorId major : BenchmarkMajors()) {
+        total += GetMajorRoadmap(major).size();
+    }
+    benchmarkSink += total;
+}
+
+void BenchGetMajorOpportunity()
+{
+    std::uint64_t total = 0;
+    for (const MajorId major : BenchmarkMajors()) {
+        total += GetMajorOpportunity(major).size();
+    }
+    benchmarkSink += total;
+}
+
+void BenchGetSubjects()
+{
+    std::uint64_t total = 0;
+    for (const MajorId major : BenchmarkMajors()) {
+        for (int year = 1; year <= 4; ++year) {
+            for (const std::string_view subject : getSubjects(major, year)) {
+                total += subject.size();
+            }
+        }
+    }
+    benchmarkSink += total;
+}
+
+void BenchDisplayScholarships()
+{
+    static NullBuffer buffer;
+    static std::ostream out(&buffer);
+    for (const MajorId major : BenchmarkMajors()) {
+        for (int year = 1; year <= 4; ++year) {
+            DisplayScholarships(major, year, out);
+        }
+    }
+    benchmarkSink += 1;
+}
+
+// Renders the screens a student sees for one major into a reused buffer.
+void BenchRenderMajorScreens()
+{
+    static ScreenStream screen;
+    for (const MajorId major : BenchmarkMajors()) {
+        DisplayMajorInfo(major, screen);
+        screen << GetMajorRoadmap(major) << '\n';
+        benchmarkSink += screen.View().size();
+        screen.Clear();
+    }
+}
+
+// 100k scholarships spread over the catalog majors and four years, each with a
+// sponsor name and an eight-word description drawn from a small vocabulary.
+const ScholarshipStore& BenchmarkScholarships()
+{
+    static const ScholarshipStore store = [] {
+        static const char* const vocabulary[] = { "research", "grant", "award", "women", "diversity", "systems",
+            "security", "cloud", "data", "innovation", "leadership", "travel", "fellowship", "merit", "need",
+            "graduate", "undergraduate", "excellence", "community", "hardware" };
+        const std::size_t vocabularySize = sizeof(vocabulary) / sizeof(vocabulary[0]);
+        ScholarshipStore result;
+        std::uint32_t state = 777;
+        std::string name;
+        std::string description;
+        for (int i = 0; i < 100000; ++i) {
+            state = state * 1103515245u + 12345u;
+            const std::string_view major = Name(BenchmarkMajors()[(state >> 8) % BenchmarkMajors().size()]);
+            const int year = 1 + static_cast<int>((state >> 20) % 4);
+            name = "Sponsor " + std::to_string(i % 997) + " Award";
+            description.clear();
+            for (int word = 0; word < 8; ++word) {
+                state = state * 1103515245u + 12345u;
+                description += vocabulary[(state >> 16) % vocabularySize];
+                description += ' ';
+            }
+            result.Add(major, year, name, description);
+        }
+        return result;
+    }();
+    return store;
+}
+
+void RunScholarshipQuery(const ScholarshipQuery& query)
+{
+    static std::vector<std::uint32_t> page;
+    benchmarkSink += BenchmarkScholarships().Query(query, page);
+}
+
+void BenchScholarshipMajorYears()
+{
+    ScholarshipQuery query;
+    query.major = Name(BenchmarkMajors()[0]);
+    query.firstYear = 2;
+    query.lastYear = 3;
+    RunScholarshipQuery(query);
+}
+
+void BenchScholarshipKeywords()
+{
+    ScholarshipQuery query;
+    query.keywords = "women research";
+    RunScholarshipQuery(query);
+}
+
+void BenchScholarshipCombined()
+{
+    ScholarshipQuery query;
+    query.major = Name(BenchmarkMajors()[1]);
+    query.firstYear = 1;
+    query.lastYear = 2;
+    query.keywords = "travel grant";
+    query.offset = 20;
+    RunScholarshipQuery(query);
+}
+
+// The whole catalog indexed 100 times over, to keep an eye on how search scales.
+const ContentIndex& BenchmarkContent()
+{
+    static const ContentIndex index = [] {
+        ContentIndex result;
+        for (int copy = 0; copy < 100; ++copy) {
+            result.AddCatalog();
+        }
+        result.Build();
+        return result;
+    }();
+    return index;
+}
+
+void RunContentSearch(std::string_view query)
+{
+    static std::vector<ContentHit> hits;
+    benchmarkSink += BenchmarkContent().Search(query, 10, hits);
+}
+
+void BenchContentSearchPhrase()
+{
+    RunContentSearch("cloud computing");
+}
+
+void BenchContentSearchQuestion()
+{
+    RunContentSearch("which careers mention GPUs?");
+}
+
+void BenchContentSearchMisspelt()
+{
+    RunContentSearch("machne lerning");
+}
+
+void BenchFullSession()
+{
+    static NullBuffer buffer;
+    static std::ostream out(&buffer);
+
+    AdvisorSession session;
+    session.Start(out);
+    std::size_t start = 0;
+    while (start < sessionScript.size() && !session.IsFinished()) {
+        const std::size_t end = sessionScript.find('\n', start);
+        session.HandleLine(sessionScript.substr(start, end - start), out);
+        start = end + 1;
+    }
+    benchmarkSink += session.IsFinished();
+}
+
+// The same session with the stage histograms on, to show what --profile costs; full_session
+// is the cost with them off.
+void BenchFullSessionProfiled()
+{
+    instrumentationEnabled.store(true, std::memory_order_relaxed);
+    BenchFullSession();
+    instrumentationEnabled.store(false, std::memory_order_relaxed);
+}
+
+std::size_t SubjectQueriesPerIteration()
+{
+    return BenchmarkMajors().size() * 4;
+}
+
+// Doubles the iteration count until one timed run lasts at least `minimumTime`, then
+// reports the cost of a single item from that run.
+double MeasureNanosecondsPerItem(const Benchmark& benchmark, std::chrono::nanoseconds minimumTime,
+    std::uint64_t& iterations)
+{
+    benchmark.body();  // warm caches and function-local statics
+    iterations = 1;
+    while (true) {
+        const auto started = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            benchmark.body();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - started;
+        if (elapsed >= minimumTime || iterations >= (std::uint64_t(1) << 40)) {
+            const double nanoseconds = static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            return nanoseconds / (static_cast<double>(iterations) * benchmark.itemsPerIteration);
+        }
+        iterations *= 2;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    MappedCatalog catalog;
+    std::string filter;
+    std::chrono::milliseconds minimumTime(200);
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--catalog" && i + 1 < argc) {
+            std::string error;
+            if (!catalog.Open(argv[++i], error)) {
+                std::cerr << error << "\n";
+                return 1;
+            }
+            activeCatalog = &catalog;
+        }
+        else if (option == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else if (option == "--min-time-ms" && i + 1 < argc) {
+            minimumTime = std::chrono::milliseconds(std::atoi(argv[++i]));
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--catalog FILE] [--filter SUBSTRING] [--min-time-ms N]\n";
+            return 2;
+        }
+    }
+
+    const Benchmark benchmarks[] = {
+        { "degree_recommendation_mask", BenchmarkMasks().size(), BenchDegreeRecommendationMask },
+        { "degree_recommendation_vector", BenchmarkMasks().size(), BenchDegreeRecommendationVector },
+        { "score_degree_batch", BenchmarkMasks().size(), BenchScoreDegreeBatch },
+        { "rank_majors_batch", BenchmarkMasks().size(), BenchRankMajorsBatch },
+        { "simulate_samples", simulationBenchSamples, BenchSimulateSamples },
+        { "curriculum_before", benchmarkCourseCount / 64, BenchCurriculumBefore },
+        { "curriculum_common", majorIdCount * majorIdCount, BenchCurriculumCommon },
+        { "curriculum_earliest", benchmarkCourseCount, BenchCurriculumEarliest },
+        { "major_selection_cs", 1, BenchMajorSelectionComputerScience },
+        { "major_selection_ct", 1, BenchMajorSelectionComputerTechnology },
+        { "get_major_questions", BenchmarkMajors().size(), BenchGetMajorQuestions },
+        { "get_major_info", BenchmarkMajors().size(), BenchGetMajorInfo },
+        { "get_major_roadmap", BenchmarkMajors().size(), BenchGetMajorRoadmap },
+        { "get_major_opportunity", BenchmarkMajors().size(), BenchGetMajorOpportunity },
+        { "get_subjects", SubjectQueriesPerIteration(), BenchGetSubjects },
+        { "display_scholarships", SubjectQueriesPerIteration(), BenchDisplayScholarships },
+        { "scholarship_query_major_years", 1, BenchScholarshipMajorYears },
+        { "scholarship_query_keywords", 1, BenchScholarshipKeywords },
+        { "scholarship_query_combined", 1, BenchScholarshipCombined },
+        { "content_search_phrase", 1, BenchContentSearchPhrase },
+        { "content_search_question", 1, BenchContentSearchQuestion },
+        { "content_search_misspelt", 1, BenchContentSearchMisspelt },
+        { "render_major_screens", BenchmarkMajors().size(), BenchRenderMajorScreens },
+        { "full_session", 1, BenchFullSession },
+        { "full_session_profiled", 1, BenchFullSessionProfiled },
+    };
+
+    // One row per benchmark; the column set and names are kept stable between releases.
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "benchmark,iterations,items_per_iteration,ns_per_item\n";
+    for (const Benchmark& benchmark : benchmarks) {
+        if (!filter.empty() && std::string_view(benchmark.name).find(filter) == std::string_view::npos) {
+            continue;
+        }
+        std::uint64_t iterations = 0;
+        const double nanoseconds = MeasureNanosecondsPerItem(benchmark, minimumTime, iterations);
+        std::cout << benchmark.name << ',' << iterations << ',' << benchmark.itemsPerIteration << ','
+                  << nanoseconds << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,719 @@
+#include "Catalog.h"
+
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+thread_local const MappedCatalog* activeCatalog = nullptr;
+
+std::string publishedCatalogPath;
+std::shared_ptr<const MappedCatalog> publishedCatalog;
+volatile std::sig_atomic_t catalogReloadRequested = 0;
+
+template <std::size_t N>
+constexpr CatalogStringList MakeSubjectList(const std::string_view (&subjects)[N])
+{
+    return CatalogStringList(subjects, N);
+}
+
+constexpr std::string_view computerScienceBachelors[] = {
+    "Bachelor of Software Engineering in Computer Science",
+    "Bachelor of Business Information Systems in Computer Science",
+    "Bachelor of Knowledge Engineering in Computer Science",
+    "Bachelor of High Performance Computing in Computer Science"
+};
+constexpr std::string_view computerTechnologyBachelors[] = {
+    "Bachelor of Embedded Systems in Computer Technology",
+    "Bachelor of Communication and Networking in Computer Technology",
+    "Bachelor of Cyber Security in Computer Technology"
+};
+
+CatalogStringList getBachelorDegrees(DegreeId degree) {
+    switch (degree) {
+    case DegreeId::ComputerScience:
+        return MakeSubjectList(computerScienceBachelors);
+    case DegreeId::ComputerTechnology:
+        return MakeSubjectList(computerTechnologyBachelors);
+    default:
+        return CatalogStringList();
+    }
+}
+
+constexpr std::string_view majorUndecidedSubjects[] = { "major will be choose at third year" };
+constexpr std::string_view businessInformationSystemsYear3Subjects[] = {
+    "Data Analytics",
+    "Data Science",
+    "Software Development",
+    "Cloud Computing"
+};
+constexpr std::string_view businessInformationSystemsYear4Subjects[] = {
+    "Embedded Systems",
+    "Internet of Things (IoT)",
+    "Software Engineering Management",
+    "Machine Learning and Artificial Intelligence for business"
+};
+constexpr std::string_view businessInformationSystemsYear5Subjects[] = {
+    "Blockchain Technology",
+    "Advanced Software Design",
+    "Software Quality Assurance(QA) ",
+    "Augmented Reality (AR) and Virtual Reality (VR)"
+};
+constexpr std::string_view communicationAndNetworkingYear3Subjects[] = {
+    "Communication Systems",
+    "Computer Networks",
+    "Network Protocols",
+    "Digital Signal Processing (DSP)"
+};
+constexpr std::string_view communicationAndNetworkingYear4Subjects[] = {
+    "Advanced Networking",
+    "Network Security",
+    "Optical Networks",
+    "Wireless Networks and Mobile Communications"
+};
+constexpr std::string_view communicationAndNetworkingYear5Subjects[] = {
+    "Next-Generation Networking",
+    "Cloud Computing and Networking",
+    "Network Management and Automation",
+    "Advanced Wireless Communication Systems"
+};
+constexpr std::string_view cyberSecurityYear3Subjects[] = {
+    "Network Security",
+    "Cybersecurity Fundamentals",
+    "Secure Software Development",
+    "Ethical Hacking and Penetration Testing"
+};
+constexpr std::string_view cyberSecurityYear4Subjects[] = {
+    "Cyber Forensics",
+    "Cloud Security",
+    "Application Security",
+    "Cybersecurity Policy and Strategy"
+};
+constexpr std::string_view cyberSecurityYear5Subjects[] = {
+    "Data Science",
+    "Advanced Cryptography",
+    "Cloud Security",
+    "Artificial Intelligence in Cybersecurity"
+};
+constexpr std::string_view embeddedSystemsYear3Subjects[] = {
+    "Embedded Systems Design",
+    "Digital Logic Design",
+    "Embedded Systems Programming",
+    "Microcontroller and Microprocessor Systems"
+};
+constexpr std::string_view embeddedSystemsYear4Subjects[] = {
+    "Advanced Embedded Systems",
+    "Power Management in Embedded Systems",
+    "System-on-Chip (SoC) Design",
+    "Embedded Networking and Communication"
+};
+constexpr std::string_view embeddedSystemsYear5Subjects[] = {
+    "Embedded Systems Security",
+    "Advanced Sensor Integration",
+    "Industrial Embedded Systems",
+    "Embedded Systems Testing and Debugging"
+};
+constexpr std::string_view highPerformanceComputingYear3Subjects[] = {
+    "Parallel Computing",
+    "Operating Systems",
+    "Operating System",
+    "Computer Architecture"
+};
+constexpr std::string_view highPerformanceComputingYear4Subjects[] = {
+    "Performance Engineering",
+    "Distributed Systems",
+    "Data Management and Storage",
+    "High-Performance Computing (HPC) Systems"
+};
+constexpr std::string_view highPerformanceComputingYear5Subjects[] = {
+    "Advanced Parallel Programming",
+    "Grid Computing",
+    "Cybersecurity in HPC",
+    "Machine Learning and Data Analysis"
+};
+constexpr std::string_view knowledgeEngineeringYear3Subjects[] = {
+    "Knowledge Representation",
+    "Database Systems for Knowledge Management",
+    "Artificial Intelligence and Machine Learning",
+    "Human-Computer Interaction (HCI) for Knowledge Systems"
+};
+constexpr std::string_view knowledgeEngineeringYear4Subjects[] = {
+    "Knowledge Discovery and Data Mining",
+    "Decision Support Systems",
+    "Knowledge Management Systems",
+    "Knowledge Discovery and Data Mining"
+};
+constexpr std::string_view knowledgeEngineeringYear5Subjects[] = {
+    "Global Knowledge Systems",
+    "Advanced Knowledge Engineering Techniques",
+    "Knowledge Engineering Project Management",
+    "Ethics and Legal Issues in Knowledge Engineering"
+};
+constexpr std::string_view softwareEngineeringYear3Subjects[] = {
+    "Web Technology",
+    "Software Testing",
+    "Operating Systems",
+    "Computer Networks"
+};
+constexpr std::string_view softwareEngineeringYear4Subjects[] = {
+    "Software Project Management",
+    "Project Management",
+    "Cloud Computing",
+    "Data Science and Machine Learning"
+};
+constexpr std::string_view softwareEngineeringYear5Subjects[] = {
+    "Human Computer Interation",
+    "Artificial Intelligence",
+    "Advanced Software Engineering",
+    "Data processing technquies in distributed systems"
+};
+
+constexpr MajorCatalogEntry majorCatalog[majorIdCount] = {
+    {
+        "Software Engineering",
+        "Software Engineering focuses on the design, development, and maintenance of complex software systems. It combines principles from computer science, engineering, and mathematics to create reliable, efficient, and scalable software solutions.",
+        "1. Master the Basics: \n Learn Core Programming Languages: Focus on languages like Python, Java, or C++.\nUnderstand Data Structures and Algorithms: These are crucial for problem-solving and coding interviews.\n"
+        "2. Build Projects:\nStart Small: Create simple projects to apply what youve learned.\nGradually Increase Complexity: Work on more complex projects as you gain confidence.\n"
+        "3. Use Version Control:\nLearn Git: Its essential for collaboration and managing code.\n"
+        "4. Study System Design:\nUnderstand How Systems Work: Learn about scalable and efficient system design.\n"
+        "5. Stay Updated:\nFollow Tech Trends: Keep up with the latest technologies and tools.\n"
+        "6. Practice Coding:\nUse Online Platforms: Practice coding problems on LeetCode, HackerRank, or CodeSignal.\n"
+        "7. Develop Soft Skills:\nCommunication: Improve your ability to explain technical concepts.\nTeamwork: Learn to work effectively in a team.\n"
+        "8. Seek Internships:\nGain Real-World Experience: Internships provide valuable industry experience.\n"
+        "9. Network:\nJoin Tech Communities: Attend meetups, join online forums, and connect with professionals.\n"
+        "10. Prepare for Interviews:\nMock Interviews: Practice with friends or use platforms like Pramp.\n",
+        "1. Front-end Developer\n2. Back-end Developer\n3. Full-stack Developer\n4. iOS Developer\n5. Android Developer\n6. Cross-platform Developer\n7. Data Engineer\n8. Big Data Engineer\n9. Machine Learning Engineer\n10. AI Researcher\n11. Cloud Engineer\n12. DevOps Engineer\n13. Security Engineer\n14. Ethical Hacker\n15. Embedded Software Engineer\n16. Firmware Engineer\n17. Game Developer\n18. Graphics Programmer\n19. Software Architect\n20. Enterprise Developer\n21. Startup Engineer\n22. CTO (Chief Technology Officer)\n23. R&D Engineer\n24. Freelance Developer\n25. Software Consultant",
+        {
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(softwareEngineeringYear3Subjects),
+            MakeSubjectList(softwareEngineeringYear4Subjects),
+            MakeSubjectList(softwareEngineeringYear5Subjects)
+        }
+    },
+    {
+        "Business Information Systems",
+        "Business Information Systems (BIS) focuses on integrating technology with business processes to improve decision-making and efficiency. Students learn to design, implement, and manage information systems, gaining skills in programming, database management, and IT governance. Career opportunities include roles like IT project manager, systems analyst, and business process analyst",
+        {},
+        "1. Business Analyst\n2. Systems Analyst  \n3. IT Project Manager  \n4. Data Analyst  \n5. ERP Consultant  \n6. Information Systems Manager  \n7. Web Developer  \n8. IT Business Strategist\n9. Software Consultant\n10. Cybersecurity Analyst",
+        {
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(businessInformationSystemsYear3Subjects),
+            MakeSubjectList(businessInformationSystemsYear4Subjects),
+            MakeSubjectList(businessInformationSystemsYear5Subjects)
+        }
+    },
+    {
+        "Knowledge Engineering",
+        "Knowledge Engineering focuses on creating systems that replicate human decision-making by using artificial intelligence. It involves translating expert knowledge into rules and data structures that computers can understand and use to solve complex problems. This field is essential in areas like healthcare, finance, and customer service, where it helps automate decision-making processes and improve efficiency.",
+        "1. Understand Core Concepts:\nFocus on key topics like databases, ERP, and data management.\n"
+        "2. Follow a Structured Curriculum:\nUse textbooks, online courses, or university syllabi to guide your study.\n"
+        "3. Hands-On Practice:\nApply concepts through case studies, projects, or internships.\n"
+        "4. Stay Updated:\nFollow industry trends and new technologies in BIS.\n"
+        "5. Group Study:\nCollaborate with peers for discussions and problem-solving.\n"
+        "6. Focus on Tools:\nLearn popular BIS tools like SAP, Oracle, and Microsoft Dynamics.\n"
+        "7. Seek Expert Guidance:\nAttend workshops or consult professionals for insights.\n"
+        "8. Review Regularly:\nConsistently revisit key concepts to reinforce learning.\n",
+        "1. Knowledge Engineer  \n2. Artificial Intelligence (AI) Specialist  \n3. Machine Learning Engineer  \n4. Data Scientist  \n5. Natural Language Processing (NLP) Engineer  \n6. Ontology Engineer  \n7. Semantic Web Developer  \n8. Expert Systems Developer  \n9. Research Scientist  \n10. Cognitive Computing Engineer",
+        {
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(knowledgeEngineeringYear3Subjects),
+            MakeSubjectList(knowledgeEngineeringYear4Subjects),
+            MakeSubjectList(knowledgeEngineeringYear5Subjects)
+        }
+    },
+    {
+        "High Performance Computing",
+        "High Performance Computing (HPC) involves using powerful processors and computer clusters to solve complex problems at extremely high speeds. It is essential for tasks that require significant computational power, such as scientific simulations, data analysis, and machine learning. HPC systems can process massive datasets and perform calculations much faster than standard computers, making them crucial in fields like weather forecasting, genomics, and financial modeling",
+        "1. Understand Basics:\nLearn parallel and distributed computing fundamentals.\n"
+        "2. Learn Key Languages:\nFocus on C, C++, and Python for HPC.\n"
+        "3. Explore Parallel Programming:\nStudy MPI, OpenMP, and CUDA.\n"
+        "4. Understand HPC Architectures:\nLearn about multi-core processors and clusters.\n"
+        "5. Hands-On Practice:\nWork on simple parallel programming projects.\n"
+        "6. Use HPC Platforms:\nGain experience with Linux clusters or cloud HPC services.\n"
+        "7. Study Applications:\nExplore how HPC is used in real-world scenarios.\n"
+        "8. Stay Updated:\nFollow the latest trends and advancements in HPC.\n",
+        "1. HPC Engineer\n2. HPC Systems Administrator\n3. Parallel Computing Specialist\n4. HPC Software Developer\n5. HPC Architect\n6. Computational Scientist\n7. Data Center Engineer\n8. GPU Programmer\n9. HPC Analyst\n10. Supercomputing Engineer\n11. Cluster Administrator\n12. Performance Optimization Engineer",
+        {
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(highPerformanceComputingYear3Subjects),
+            MakeSubjectList(highPerformanceComputingYear4Subjects),
+            MakeSubjectList(highPerformanceComputingYear5Subjects)
+        }
+    },
+    {
+        "Embedded Systems",
+        "Embedded Systems involve integrating hardware and software to perform specific functions within larger systems.These systems are used in various applications like automotive controls, medical devices, and consumer electronics.They are designed for real - time processing and often operate with minimal human intervention.",
+        "1. Learn Basics:\nStudy microcontrollers and RTOS.\n"
+        "2. Master Programming:\nFocus on C and C++.\n"
+        "3. Get Hands-On:\nWork with Arduino or Raspberry Pi.\n"
+        "4. Understand Hardware:\nLearn about sensors and actuators.\n"
+        "5. Explore Protocols:\nStudy I2C, SPI, and UART.\n"
+        "6. Build Projects:\nApply knowledge in practical projects.\n"
+        "7. Stay Current:\nFollow trends in embedded systems and IoT.\n",
+        "1. Embedded Systems Engineer\n2. Firmware Engineer\n3. Embedded Software Developer\n4. Hardware Engineer\n5. Embedded Linux Engineer\n6. Microcontroller Programmer\n7. FPGA Developer\n8. IoT (Internet of Things) Engineer\n9. Real-Time Systems Engineer\n10. Embedded Systems Architect\n11. Automotive Embedded Engineer\n12. Robotics Engineer",
+        {
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(embeddedSystemsYear3Subjects),
+            MakeSubjectList(embeddedSystemsYear4Subjects),
+            MakeSubjectList(embeddedSystemsYear5Subjects)
+        }
+    },
+    {
+        "Communication and Networking",
+        "Communication and Networking focuses on connecting devices and systems to share data efficiently. This field covers the design, implementation, and management of networks, including local, wide-area, and mobile networks. Key topics include network protocols, data transmission, and network security.",
+        "1. Learn Basics:\nStudy encryption, firewalls, and protocols.\n"
+        "2. Understand Threats:\nLearn about common attacks and vulnerabilities.\n"
+        "3. Use Security Tools:\nFamiliarize yourself with intrusion detection and scanning tools.\n"
+        "4. Practice Skills:\nSet up secure networks and perform basic penetration tests.\n"
+        "5. Know Compliance:\nUnderstand regulations like GDPR and HIPAA.\n"
+        "6. Stay Updated:\nFollow the latest in security trends and threats.\n"
+        "7. Get Certified:\nConsider certifications like CompTIA Security+ or CISSP.\n",
+        "1. Network Engineer\n2. Telecommunications Engineer\n3. Network Administrator\n4. VoIP Engineer\n5. Wireless Communication Engineer\n6. Network Architect\n7. Systems Engineer (Networking)\n8. Network Security Engineer\n9. Communication Systems Engineer\n10. Network Support Specialist\n11. Cloud Networking Engineer\n12. Data Communications Analyst",
+        {
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(communicationAndNetworkingYear3Subjects),
+            MakeSubjectList(communicationAndNetworkingYear4Subjects),
+            MakeSubjectList(communicationAndNetworkingYear5Subjects)
+        }
+    },
+    {
+        "Cyber Security",
+        "Cybersecurity is the practice of protecting systems, networks, and programs from digital attacks. It involves implementing strong security measures to prevent, detect, and respond to threats in the ever-evolving landscape of information technology.",
+        "1. Learn Basics:\nStudy encryption, firewalls, and protocols.\n"
+        "2. Understand Threats:\nLearn about common attacks and vulnerabilities.\n"
+        "3. Use Security Tools:\nFamiliarize yourself with intrusion detection and scanning tools.\n"
+        "4. Practice Skills:\nSet up secure networks and perform basic penetration tests.\n"
+        "5. Know Compliance:\nUnderstand regulations like GDPR and HIPAA.\n"
+        "6. Stay Updated:\nFollow the latest in security trends and threats.\n"
+        "7. Get Certified:\nConsider certifications like CompTIA Security+ or CISSP.\n",
+        {},
+        {
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(majorUndecidedSubjects),
+            MakeSubjectList(cyberSecurityYear3Subjects),
+            MakeSubjectList(cyberSecurityYear4Subjects),
+            MakeSubjectList(cyberSecurityYear5Subjects)
+        }
+    }
+};
+
+constexpr bool MajorCatalogMatchesIds()
+{
+    for (std::size_t m = 0; m < majorIdCount; ++m) {
+        if (majorCatalog[m].name != majorNames[m]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(MajorCatalogMatchesIds(), "majorCatalog must list the majors in MajorId order");
+
+std::string_view GetMajorRoadmap(MajorId major)
+{
+    StageTimer timer(Stage::CatalogLookup);
+    if (activeCatalog) {
+        const CatalogMajorRecord& record = activeCatalog->Major(major);
+        if (record.roadmap.length > 0) {
+            return activeCatalog->String(record.roadmap);
+        }
+    }
+    else if (!majorCatalog[Index(major)].roadmap.empty()) {
+        return majorCatalog[Index(major)].roadmap;
+    }
+    return "Roadmap not available for this major.";
+}
+
+std::string_view GetMajorInfo(MajorId major)
+{
+    StageTimer timer(Stage::CatalogLookup);
+    if (activeCatalog) {
+        const CatalogMajorRecord& record = activeCatalog->Major(major);
+        if (record.info.length > 0) {
+            return activeCatalog->String(record.info);
+        }
+    }
+    else if (!majorCatalog[Index(major)].info.empty()) {
+        return majorCatalog[Index(major)].info;
+    }
+    return "Information not available for this major.";
+}
+
+std::string_view GetMajorOpportunity(MajorId major)
+{
+    StageTimer timer(Stage::CatalogLookup);
+    if (activeCatalog) {
+        const CatalogMajorRecord& record = activeCatalog->Major(major);
+        if (record.opportunity.length > 0) {
+            return activeCatalog->String(record.opportunity);
+        }
+    }
+    else if (!majorCatalog[Index(major)].opportunity.empty()) {
+        return majorCatalog[Index(major)].opportunity;
+    }
+    return "Opportunity not available for this major.";
+}
+
+constexpr std::string_view subjectsUnavailable[] = { "Subjects not available for this major and year." };
+
+CatalogStringList getSubjects(MajorId major, int year) {
+    StageTimer timer(Stage::CatalogLookup);
+    if (year >= 1 && year <= catalogYearCount) {
+        if (activeCatalog) {
+            const CatalogMajorRecord& record = activeCatalog->Major(major);
+            if (record.subjects[year - 1].count > 0) {
+                return activeCatalog->List(record.subjects[year - 1]);
+            }
+        }
+        else if (majorCatalog[Index(major)].subjects[year - 1].size() > 0) {
+            return majorCatalog[Index(major)].subjects[year - 1];
+        }
+    }
+    return MakeSubjectList(subjectsUnavailable);
+}
+
+const std::map<int, std::vector<Scholarship>> scholarshipDatabase[majorIdCount] = {
+    // Software Engineering
+    {
+        {1, {
+            {"Google Scholarship", "A prestigious scholarship for first-year Software Engineering students, providing financial aid and mentorship."},
+            {"ACM-W Scholarship", "Supports women in computing by covering costs for conferences and events."}
+        }},
+        {2, {
+            {"Facebook Engineering Excellence", "Awarded to second-year Software Engineering students excelling in their studies."}
+        }},
+        {3, {}}, // No scholarships for Year 3
+        {4, {
+            {"Microsoft Diversity Scholarship", "Supports diverse candidates in their final year of Software Engineering."}
+        }},
+    },
+    // Business Information Systems
+    {
+        {1, {}}, // No scholarships for Year 1
+        {2, {
+            {"McKinsey Emerging Scholars", "Offered to second-year students with strong leadership potential."}
+        }},
+        {3, {
+            {"SAP Scholarship for Business Innovators", "Awarded to third-year students showing innovation in business technology."}
+        }},
+        {4, {
+            {"Deloitte Technology Scholars", "Supports final-year students with a focus on business information systems."}
+        }},
+    },
+    // Knowledge Engineering
+    {
+        {1, {
+            {"AI Research Fellowship", "Supports first-year Knowledge Engineering students interested in AI research."}
+        }},
+        {2, {
+            {"IBM Watson Scholarship", "Awarded to second-year students focusing on cognitive computing and AI."}
+        }},
+        {3, {}}, // No scholarships for Year 3
+        {4, {
+            {"DeepMind Scholarship", "Covers the cost of final-year tuition for students specializing in machine learning."}
+        }},
+    },
+    // High Performance Computing
+    {
+        {1, {}}, // No scholarships for Year 1
+        {2, {
+            {"NVIDIA GPU Research Grant", "Offered to second-year students engaged in GPU computing research."}
+        }},
+        {3, {
+            {"Intel HPC Scholarship", "Supports third-year students with a focus on high-performance computing systems."}
+        }},
+        {4, {}}, // No scholarships for Year 4
+    },
+    // Embedded Systems
+    {
+        {1, {
+            {"ARM Embedded Systems Scholarship", "Offered to first-year students with an interest in embedded systems design."}
+        }},
+        {2, {}}, // No scholarships for Year 2
+        {3, {
+            {"Texas Instruments Embedded Innovation", "Supports third-year students working on embedded systems projects."}
+        }},
+        {4, {
+            {"Qualcomm Scholarship", "Provides financial support for final-year students specializing in embedded systems."}
+        }},
+    },
+    // Communication and Networking
+    {
+        {1, {
+            {"Cisco Networking Scholarship", "Provides support to first-year students studying networking technologies."}
+        }},
+        {2, {}}, // No scholarships for Year 2
+        {3, {
+            {"Huawei Communications Scholarship", "Awarded to third-year students with a focus on telecommunications."}
+        }},
+        {4, {
+            {"Ericsson Scholarship for Network Engineers", "Supports final-year students specializing in communication networks."}
+        }},
+    },
+    {}, // Cyber Security is not in the database
+};
+
+std::string_view CatalogStringList::operator[](std::size_t index) const
+{
+    if (views) {
+        return views[index];
+    }
+    const CatalogStringRef& ref = refs[index];
+    if (ref.offset > stringsSize || ref.length > stringsSize - ref.offset) {
+        return std::string_view();
+    }
+    return std::string_view(strings + ref.offset, ref.length);
+}
+
+MappedCatalog::MappedCatalog() : header(nullptr), degrees(), majors(), scholarshipMajors()
+{
+}
+
+MappedCatalog::~MappedCatalog()
+{
+    Close();
+}
+
+void MappedCatalog::Close()
+{
+    file.Close();
+    header = nullptr;
+    std::fill(std::begin(degrees), std::end(degrees), nullptr);
+    std::fill(std::begin(majors), std::end(majors), CatalogMajorRecord());
+    std::fill(std::begin(scholarshipMajors), std::end(scholarshipMajors), nullptr);
+}
+
+// Records with names outside the id table are never looked up. A major can be spread over
+// several records under its older spellings, so its fields are taken from the first record
+// that has them.
+void MappedCatalog::IndexRecords()
+{
+    for (const CatalogDegreeRecord* record = DegreesBegin(); record != DegreesEnd(); ++record) {
+        DegreeId degree;
+        if (FindDegreeId(String(record->name), degree) && !degrees[Index(degree)]) {
+            degrees[Index(degree)] = record;
+        }
+    }
+    for (const CatalogMajorRecord* record = MajorsBegin(); record != MajorsEnd(); ++record) {
+        MajorId id;
+        if (!FindMajorId(String(record->name), id)) {
+            continue;
+        }
+        CatalogMajorRecord& major = majors[Index(id)];
+        for (CatalogStringRef CatalogMajorRecord::*field : { &CatalogMajorRecord::name, &CatalogMajorRecord::info,
+                 &CatalogMajorRecord::roadmap, &CatalogMajorRecord::opportunity }) {
+            if ((major.*field).length == 0) {
+                major.*field = record->*field;
+            }
+        }
+        for (int year = 0; year < catalogYearCount; ++year) {
+            if (major.subjects[year].count == 0) {
+                major.subjects[year] = record->subjects[year];
+            }
+        }
+    }
+    for (const CatalogScholarshipMajorRecord* record = ScholarshipMajorsBegin(); record != ScholarshipMajorsEnd(); ++record) {
+        MajorId major;
+        if (FindMajorId(String(record->major), major) && !scholarshipMajors[Index(major)]) {
+            scholarshipMajors[Index(major)] = record;
+        }
+    }
+}
+
+bool MappedCatalog::Open(const std::string& path, std::string& error)
+{
+    Close();
+    if (!file.Open(path, error)) {
+        return false;
+    }
+    const char* data = file.Data();
+    const std::size_t size = file.Size();
+    header = reinterpret_cast<const CatalogFileHeader*>(data);
+    auto tableFits = [size](const CatalogTable& table, std::size_t recordSize) {
+        return table.offset % 4 == 0 && table.offset <= size && table.count <= (size - table.offset) / recordSize;
+    };
+    if (size < sizeof(CatalogFileHeader) || std::memcmp(header->magic, catalogFileMagic, sizeof(catalogFileMagic)) != 0) {
+        error = path + " is not a catalog file";
+    }
+    else if (header->version != catalogFileVersion) {
+        error = path + " has catalog version " + std::to_string(header->version) + ", expected " + std::to_string(catalogFileVersion);
+    }
+    else if (header->fileSize != size ||
+        !tableFits(header->degrees, sizeof(CatalogDegreeRecord)) ||
+        !tableFits(header->majors, sizeof(CatalogMajorRecord)) ||
+        !tableFits(header->scholarshipMajors, sizeof(CatalogScholarshipMajorRecord)) ||
+        !tableFits(header->scholarships, sizeof(CatalogScholarshipRecord)) ||
+        !tableFits(header->stringRefs, sizeof(CatalogStringRef)) ||
+        !tableFits(header->strings, 1)) {
+        error = path + " is truncated or corrupt";
+    }
+    else {
+        IndexRecords();
+        return true;
+    }
+    Close();
+    return false;
+}
+
+template <typename Record>
+const Record* MappedCatalog::Table(const CatalogTable& table) const
+{
+    return reinterpret_cast<const Record*>(file.Data() + table.offset);
+}
+
+std::string_view MappedCatalog::String(const CatalogStringRef& ref) const
+{
+    const CatalogTable& strings = header->strings;
+    if (ref.offset > strings.count || ref.length > strings.count - ref.offset) {
+        return std::string_view();
+    }
+    return std::string_view(file.Data() + strings.offset + ref.offset, ref.length);
+}
+
+CatalogStringList MappedCatalog::List(const CatalogListRef& ref) const
+{
+    const CatalogTable& refs = header->stringRefs;
+    if (ref.first > refs.count || ref.count > refs.count - ref.first) {
+        return CatalogStringList();
+    }
+    return CatalogStringList(file.Data() + header->strings.offset, header->strings.count,
+        Table<CatalogStringRef>(refs) + ref.first, ref.count);
+}
+
+const CatalogDegreeRecord* MappedCatalog::DegreesBegin() const
+{
+    return Table<CatalogDegreeRecord>(header->degrees);
+}
+
+const CatalogDegreeRecord* MappedCatalog::DegreesEnd() const
+{
+    return DegreesBegin() + header->degrees.count;
+}
+
+const CatalogDegreeRecord* MappedCatalog::Degree(DegreeId degree) const
+{
+    return Index(degree) < degreeIdCount ? degrees[Index(degree)] : nullptr;
+}
+
+const CatalogMajorRecord* MappedCatalog::MajorsBegin() const
+{
+    return Table<CatalogMajorRecord>(header->majors);
+}
+
+const CatalogMajorRecord* MappedCatalog::MajorsEnd() const
+{
+    return MajorsBegin() + header->majors.count;
+}
+
+const CatalogMajorRecord& MappedCatalog::Major(MajorId major) const
+{
+    return majors[Index(major)];
+}
+
+const CatalogScholarshipMajorRecord* MappedCatalog::ScholarshipMajorsBegin() const
+{
+    return Table<CatalogScholarshipMajorRecord>(header->scholarshipMajors);
+}
+
+const CatalogScholarshipMajorRecord* MappedCatalog::ScholarshipMajorsEnd() const
+{
+    return ScholarshipMajorsBegin() + header->scholarshipMajors.count;
+}
+
+const CatalogScholarshipMajorRecord* MappedCatalog::ScholarshipMajor(MajorId major) const
+{
+    return scholarshipMajors[Index(major)];
+}
+
+const CatalogScholarshipRecord* MappedCatalog::ScholarshipsBegin(const CatalogScholarshipMajorRecord& major) const
+{
+    const std::uint32_t first = std::min(major.first, header->scholarships.count);
+    return Table<CatalogScholarshipRecord>(header->scholarships) + first;
+}
+
+const CatalogScholarshipRecord* MappedCatalog::ScholarshipsEnd(const CatalogScholarshipMajorRecord& major) const
+{
+    const std::uint32_t available = header->scholarships.count - std::min(major.first, header->scholarships.count);
+    return ScholarshipsBegin(major) + std::min(major.count, available);
+}
+
+void MappedCatalog::Touch() const
+{
+    volatile char sink = 0;
+    for (std::size_t offset = 0; offset < file.Size(); offset += 4096) {
+        sink = sink + file.Data()[offset];
+    }
+}
+
+CatalogScope::CatalogScope(const MappedCatalog* catalog) : previous(activeCatalog)
+{
+    activeCatalog = catalog;
+}
+
+CatalogScope::~CatalogScope()
+{
+    activeCatalog = previous;
+}
+
+// Snapshots are published with the atomic shared_ptr functions: taking one is a load and a
+// reference count increment, and a reload only holds them up for the pointer swap.
+bool OpenPublishedCatalog(const std::string& path, std::string& error)
+{
+    std::shared_ptr<MappedCatalog> catalog = std::make_shared<MappedCatalog>();
+    if (!catalog->Open(path, error)) {
+        return false;
+    }
+    catalog->Touch();
+    publishedCatalogPath = path;
+    std::atomic_store(&publishedCatalog, std::shared_ptr<const MappedCatalog>(std::move(catalog)));
+    return true;
+}
+
+bool ReloadPublishedCatalog(std::string& error)
+{
+    if (publishedCatalogPath.empty()) {
+        error = "no catalog file to reload; start with --catalog FILE";
+        return false;
+    }
+    return OpenPublishedCatalog(publishedCatalogPath, error);
+}
+
+std::shared_ptr<const MappedCatalog> PublishedCatalog()
+{
+    return std::atomic_load(&publishedCatalog);
+}
+
+void RequestCatalogReload(int)
+{
+    catalogReloadRequested = 1;
+}
+
+void EnableCatalogReloadSignal()
+{
+#ifdef SIGHUP
+    std::signal(SIGHUP, RequestCatalogReload);
+#endif
+}
+
+void ReloadCatalogIfRequested()
+{
+    if (!catalogReloadRequested) {
+        return;
+    }
+    catalogReloadRequested = 0;
+    std::string error;
+    if (ReloadPublishedCatalog(error)) {
+        std::cerr << "Reloaded the catalog from " << publishedCatalogPath << ".\n";
+    }
+    else {
+        std::cerr << "Catalog reload failed, keeping the current catalog: " << error << "\n";
+    }
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "CatalogIds.h"
+#include "MappedFile.h"
+
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+const int catalogYearCount = 5;
+
+// Binary catalog file, produced by --compile-catalog and mapped read-only at run time.
+// Everything is 32-bit little-endian and 4-byte aligned so records can be used in place.
+// Strings are (offset, length) pairs into one byte blob; lists are runs of string refs.
+// Majors, degrees and scholarship majors are sorted by name; their names are resolved to
+// ids once, when the file is opened.
+const char catalogFileMagic[8] = { 'S', 'M', 'S', 'C', 'A', 'T', 'L', 'G' };
+const std::uint32_t catalogFileVersion = 1;
+
+struct CatalogTable
+{
+    std::uint32_t offset;
+    std::uint32_t count;
+};
+
+struct CatalogFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t fileSize;
+    CatalogTable degrees;
+    CatalogTable majors;
+    CatalogTable scholarshipMajors;
+    CatalogTable scholarships;
+    CatalogTable stringRefs;
+    CatalogTable strings;
+};
+
+struct CatalogStringRef
+{
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+struct CatalogListRef
+{
+    std::uint32_t first;
+    std::uint32_t count;
+};
+
+struct CatalogDegreeRecord
+{
+    CatalogStringRef name;
+    CatalogStringRef info;
+    CatalogListRef bachelors;
+};
+
+struct CatalogMajorRecord
+{
+    CatalogStringRef name;
+    CatalogStringRef info;
+    CatalogStringRef roadmap;
+    CatalogStringRef opportunity;
+    CatalogListRef subjects[catalogYearCount];
+};
+
+// A major listed in the scholarship database; its awards are a run of
+// CatalogScholarshipRecords sorted by year.
+struct CatalogScholarshipMajorRecord
+{
+    CatalogStringRef major;
+    std::uint32_t first;
+    std::uint32_t count;
+};
+
+struct CatalogScholarshipRecord
+{
+    std::uint32_t year;
+    CatalogStringRef name;
+    CatalogStringRef description;
+};
+
+static_assert(sizeof(CatalogFileHeader) == 64, "catalog header layout changed");
+static_assert(sizeof(CatalogMajorRecord) == 72, "catalog major record layout changed");
+
+// A read-only list of strings, either compiled in or inside a mapped catalog file.
+class CatalogStringList
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(const CatalogStringList* list, std::size_t index) : list(list), index(index) {}
+        std::string_view operator*() const { return (*list)[index]; }
+        Iterator& operator++() { ++index; return *this; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+    private:
+        const CatalogStringList* list;
+        std::size_t index;
+    };
+
+    constexpr CatalogStringList()
+        : views(nullptr), strings(nullptr), stringsSize(0), refs(nullptr), count(0) {}
+    constexpr CatalogStringList(const std::string_view* views, std::size_t count)
+        : views(views), strings(nullptr), stringsSize(0), refs(nullptr), count(count) {}
+    CatalogStringList(const char* strings, std::size_t stringsSize, const CatalogStringRef* refs, std::size_t count)
+        : views(nullptr), strings(strings), stringsSize(stringsSize), refs(refs), count(count) {}
+
+    std::size_t size() const { return count; }
+    std::string_view operator[](std::size_t index) const;
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, count); }
+
+private:
+    const std::string_view* views;
+    const char* strings;
+    std::size_t stringsSize;
+    const CatalogStringRef* refs;
+    std::size_t count;
+};
+
+// A catalog file mapped into memory. Open only checks the header and table bounds, so
+// it costs the same however big the file is; every lookup returns views into the mapping.
+class MappedCatalog
+{
+public:
+    MappedCatalog();
+    ~MappedCatalog();
+    MappedCatalog(const MappedCatalog&) = delete;
+    MappedCatalog& operator=(const MappedCatalog&) = delete;
+
+    bool Open(const std::string& path, std::string& error);
+    std::string_view String(const CatalogStringRef& ref) const;
+    CatalogStringList List(const CatalogListRef& ref) const;
+
+    const CatalogDegreeRecord* DegreesBegin() const;
+    const CatalogDegreeRecord* DegreesEnd() const;
+    // Null when the file has no such degree.
+    const CatalogDegreeRecord* Degree(DegreeId degree) const;
+    const CatalogMajorRecord* MajorsBegin() const;
+    const CatalogMajorRecord* MajorsEnd() const;
+    // Every record naming `major`, merged field by field; a field no record has is empty.
+    const CatalogMajorRecord& Major(MajorId major) const;
+    const CatalogScholarshipMajorRecord* ScholarshipMajorsBegin() const;
+    const CatalogScholarshipMajorRecord* ScholarshipMajorsEnd() const;
+    // Null when the file lists no scholarships for `major`.
+    const CatalogScholarshipMajorRecord* ScholarshipMajor(MajorId major) const;
+    const CatalogScholarshipRecord* ScholarshipsBegin(const CatalogScholarshipMajorRecord& major) const;
+    const CatalogScholarshipRecord* ScholarshipsEnd(const CatalogScholarshipMajorRecord& major) const;
+    // Reads one byte of every page, so lookups that follow do not stop for page faults.
+    void Touch() const;
+
+private:
+    template <typename Record>
+    const Record* Table(const CatalogTable& table) const;
+    void IndexRecords();
+    void Close();
+
+    MappedFile file;
+    const CatalogFileHeader* header;
+    const CatalogDegreeRecord* degrees[degreeIdCount];
+    CatalogMajorRecord majors[majorIdCount];
+    const CatalogScholarshipMajorRecord* scholarshipMajors[majorIdCount];
+};
+
+// The catalog this thread's lookups read; when null, the compiled-in catalog is used.
+extern thread_local const MappedCatalog* activeCatalog;
+
+// Points this thread's activeCatalog at `catalog` until it goes out of scope.
+class CatalogScope
+{
+public:
+    explicit CatalogScope(const MappedCatalog* catalog);
+    ~CatalogScope();
+    CatalogScope(const CatalogScope&) = delete;
+    CatalogScope& operator=(const CatalogScope&) = delete;
+
+private:
+    const MappedCatalog* previous;
+};
+
+// The catalog file named by --catalog, as immutable snapshots. A session takes the current
+// snapshot when it starts and reads only that one, so it sees one version of every text
+// however many reloads happen meanwhile. A reload maps the file again, pages it in and
+// swaps it in for sessions that start later; a snapshot is unmapped when the last session
+// holding it lets go. Replace the file by renaming a new one over it (as --compile-catalog
+// does) rather than rewriting it in place, which would change the snapshots being read.
+bool OpenPublishedCatalog(const std::string& path, std::string& error);
+bool ReloadPublishedCatalog(std::string& error);
+// Null when no catalog file is in use.
+std::shared_ptr<const MappedCatalog> PublishedCatalog();
+
+// Set by SIGHUP once EnableCatalogReloadSignal has run.
+extern volatile std::sig_atomic_t catalogReloadRequested;
+void EnableCatalogReloadSignal();
+// Reloads if a reload was asked for, reporting the outcome on std::cerr. A catalog that
+// fails to load leaves the current one in place.
+void ReloadCatalogIfRequested();
+
+// Advising content, built once at compile time. Every string is a view into static
+// storage, so looking a major up never allocates. Entries are indexed by MajorId; a
+// section that is empty means "not available".
+struct MajorCatalogEntry
+{
+    std::string_view name;
+    std::string_view info;
+    std::string_view roadmap;
+    std::string_view opportunity;
+    CatalogStringList subjects[catalogYearCount];
+};
+
+extern const MajorCatalogEntry majorCatalog[majorIdCount];
+
+struct Scholarship {
+    std::string name;
+    std::string description;
+};
+
+// Scholarships of each major by year; a major with none is not in the database at all.
+extern const std::map<int, std::vector<Scholarship>> scholarshipDatabase[majorIdCount];
+
+CatalogStringList getBachelorDegrees(DegreeId degree);
+std::string_view GetMajorRoadmap(MajorId major);
+std::string_view GetMajorInfo(MajorId major);
+std::string_view GetMajorOpportunity(MajorId major);
+CatalogStringList getSubjects(MajorId major, int year);
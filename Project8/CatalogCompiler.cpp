@@ -0,0 +1,383 @@
+#include "CatalogCompiler.h"
+
+#include "Display.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+// The content compiled into this program, in catalog source form.
+CatalogSource BuiltinCatalogSource()
+{
+    CatalogSource source;
+    for (std::size_t d = 0; d < degreeIdCount; ++d) {
+        const DegreeId degree = static_cast<DegreeId>(d);
+        std::ostringstream info;
+        DisplayDegreeInfo(degree, info);
+        std::vector<std::string> bachelors;
+        for (const std::string_view bachelor : getBachelorDegrees(degree)) {
+            bachelors.push_back(std::string(bachelor));
+        }
+        source.degrees.push_back({ std::string(Name(degree)), info.str(), bachelors });
+    }
+    for (const MajorCatalogEntry* entry = std::begin(majorCatalog); entry != std::end(majorCatalog); ++entry) {
+        CatalogSourceMajor major;
+        major.name = std::string(entry->name);
+        major.info = std::string(entry->info);
+        major.roadmap = std::string(entry->roadmap);
+        major.opportunity = std::string(entry->opportunity);
+        for (int year = 0; year < catalogYearCount; ++year) {
+            for (const auto& subject : entry->subjects[year]) {
+                major.subjects[year].push_back(std::string(subject));
+            }
+        }
+        source.majors.push_back(major);
+    }
+    for (std::size_t m = 0; m < majorIdCount; ++m) {
+        if (scholarshipDatabase[m].empty()) {
+            continue;
+        }
+        CatalogSourceScholarshipMajor scholarshipMajor;
+        scholarshipMajor.major = std::string(majorNames[m]);
+        for (const auto& year : scholarshipDatabase[m]) {
+            for (const auto& scholarship : year.second) {
+                scholarshipMajor.awards.push_back({ year.first, scholarship });
+            }
+        }
+        source.scholarshipMajors.push_back(scholarshipMajor);
+    }
+    return source;
+}
+
+// Values in the text format run to the end of the line. Newlines, backslashes, control
+// and non-ASCII bytes, and a trailing space are escaped so the file survives editors.
+std::string EscapeCatalogValue(std::string_view value)
+{
+    static const char hexDigits[] = "0123456789ABCDEF";
+    std::string escaped;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c == '\n') {
+            escaped += "\\n";
+        }
+        else if (c == '\\') {
+            escaped += "\\\\";
+        }
+        else if (c < 0x20 || c >= 0x7f || (c == ' ' && i + 1 == value.size())) {
+            escaped += "\\x";
+            escaped += hexDigits[c >> 4];
+            escaped += hexDigits[c & 0xf];
+        }
+        else {
+            escaped += static_cast<char>(c);
+        }
+    }
+    return escaped;
+}
+
+bool UnescapeCatalogValue(std::string_view value, std::string& result)
+{
+    result.clear();
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        if (value[i] != '\\') {
+            result += value[i];
+            continue;
+        }
+        if (i + 1 < value.size() && value[i + 1] == 'n') {
+            result += '\n';
+            i += 1;
+        }
+        else if (i + 1 < value.size() && value[i + 1] == '\\') {
+            result += '\\';
+            i += 1;
+        }
+        else if (i + 3 < value.size() && value[i + 1] == 'x' &&
+            std::isxdigit(static_cast<unsigned char>(value[i + 2])) && std::isxdigit(static_cast<unsigned char>(value[i + 3]))) {
+            result += static_cast<char>(std::stoi(std::string(value.substr(i + 2, 2)), nullptr, 16));
+            i += 3;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WriteCatalogSource(const CatalogSource& source, std::ostream& out)
+{
+    out << "# Advising catalog source.\n";
+    out << "# Compile with: Project8 --compile-catalog catalog.txt catalog.bin\n";
+    out << "# Each line is a keyword and a value; \\n, \\\\ and \\xHH are the only escapes.\n";
+    for (const auto& degree : source.degrees) {
+        out << "\ndegree " << EscapeCatalogValue(degree.name) << "\n";
+        for (const auto& bachelor : degree.bachelors) {
+            out << "bachelor " << EscapeCatalogValue(bachelor) << "\n";
+        }
+        out << "info " << EscapeCatalogValue(degree.info) << "\n";
+    }
+    for (const auto& major : source.majors) {
+        out << "\nmajor " << EscapeCatalogValue(major.name) << "\n";
+        if (!major.info.empty()) {
+            out << "info " << EscapeCatalogValue(major.info) << "\n";
+        }
+        if (!major.roadmap.empty()) {
+            out << "roadmap " << EscapeCatalogValue(major.roadmap) << "\n";
+        }
+        if (!major.opportunity.empty()) {
+            out << "opportunity " << EscapeCatalogValue(major.opportunity) << "\n";
+        }
+        for (int year = 0; year < catalogYearCount; ++year) {
+            for (const auto& subject : major.subjects[year]) {
+                out << "subject " << year + 1 << " " << EscapeCatalogValue(subject) << "\n";
+            }
+        }
+    }
+    for (const auto& scholarshipMajor : source.scholarshipMajors) {
+        out << "\nscholarships " << EscapeCatalogValue(scholarshipMajor.major) << "\n";
+        for (const auto& award : scholarshipMajor.awards) {
+            out << "award " << award.first << " " << EscapeCatalogValue(award.second.name) << "\n";
+            out << "description " << EscapeCatalogValue(award.second.description) << "\n";
+        }
+    }
+}
+
+bool ParseCatalogSource(std::istream& in, CatalogSource& source, std::string& error)
+{
+    enum class Block { None, Degree, Major, Scholarships } block = Block::None;
+    std::string line;
+    std::string value;
+    int lineNumber = 0;
+    auto fail = [&](const std::string& message) {
+        error = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+    // "subject" and "award" values start with a year.
+    auto splitYear = [](std::string_view text, int& year, std::string_view& rest) {
+        const std::size_t space = text.find(' ');
+        if (space == std::string_view::npos ||
+            std::from_chars(text.data(), text.data() + space, year).ec != std::errc()) {
+            return false;
+        }
+        rest = text.substr(space + 1);
+        return true;
+    };
+
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        const std::size_t space = line.find(' ');
+        const std::string keyword = line.substr(0, space);
+        std::string_view rawValue = space == std::string::npos ? std::string_view() : std::string_view(line).substr(space + 1);
+        int year = 0;
+        if ((keyword == "subject" || keyword == "award") && !splitYear(rawValue, year, rawValue)) {
+            return fail(keyword + " needs a year before its text");
+        }
+        if (!UnescapeCatalogValue(rawValue, value)) {
+            return fail("bad escape sequence");
+        }
+
+        if (keyword == "degree") {
+            source.degrees.push_back({ value, std::string(), {} });
+            block = Block::Degree;
+        }
+        else if (keyword == "major") {
+            source.majors.push_back(CatalogSourceMajor());
+            source.majors.back().name = value;
+            block = Block::Major;
+        }
+        else if (keyword == "scholarships") {
+            source.scholarshipMajors.push_back({ value, {} });
+            block = Block::Scholarships;
+        }
+        else if (keyword == "bachelor" && block == Block::Degree) {
+            source.degrees.back().bachelors.push_back(value);
+        }
+        else if (keyword == "info" && block == Block::Degree) {
+            source.degrees.back().info = value;
+        }
+        else if (keyword == "info" && block == Block::Major) {
+            source.majors.back().info = value;
+        }
+        else if (keyword == "roadmap" && block == Block::Major) {
+            source.majors.back().roadmap = value;
+        }
+        else if (keyword == "opportunity" && block == Block::Major) {
+            source.majors.back().opportunity = value;
+        }
+        else if (keyword == "subject" && block == Block::Major) {
+            if (year < 1 || year > catalogYearCount) {
+                return fail("subject year must be between 1 and " + std::to_string(catalogYearCount));
+            }
+            source.majors.back().subjects[year - 1].push_back(value);
+        }
+        else if (keyword == "award" && block == Block::Scholarships) {
+            source.scholarshipMajors.back().awards.push_back({ year, Scholarship{ value, std::string() } });
+        }
+        else if (keyword == "description" && block == Block::Scholarships && !source.scholarshipMajors.back().awards.empty()) {
+            source.scholarshipMajors.back().awards.back().second.description = value;
+        }
+        else {
+            return fail("unexpected \"" + keyword + "\"");
+        }
+    }
+    return true;
+}
+
+// Lays the catalog out in the binary format. Identical strings are stored once.
+bool WriteCatalogFile(const CatalogSource& source, const std::string& path, std::string& error)
+{
+    std::string strings;
+    std::unordered_map<std::string, std::uint32_t> stringOffsets;
+    std::vector<CatalogStringRef> stringRefs;
+    auto addString = [&](const std::string& text) {
+        auto inserted = stringOffsets.emplace(text, static_cast<std::uint32_t>(strings.size()));
+        if (inserted.second) {
+            strings += text;
+        }
+        return CatalogStringRef{ inserted.first->second, static_cast<std::uint32_t>(text.size()) };
+    };
+    auto addList = [&](const std::vector<std::string>& texts) {
+        CatalogListRef list{ static_cast<std::uint32_t>(stringRefs.size()), static_cast<std::uint32_t>(texts.size()) };
+        for (const auto& text : texts) {
+            stringRefs.push_back(addString(text));
+        }
+        return list;
+    };
+    auto byName = [](const auto& a, const auto& b) { return a.name < b.name; };
+
+    std::vector<CatalogSourceDegree> degrees = source.degrees;
+    std::vector<CatalogSourceMajor> majors = source.majors;
+    std::vector<CatalogSourceScholarshipMajor> scholarshipMajors = source.scholarshipMajors;
+    std::stable_sort(degrees.begin(), degrees.end(), byName);
+    std::stable_sort(majors.begin(), majors.end(), byName);
+    std::stable_sort(scholarshipMajors.begin(), scholarshipMajors.end(),
+        [](const CatalogSourceScholarshipMajor& a, const CatalogSourceScholarshipMajor& b) { return a.major < b.major; });
+    for (std::size_t i = 1; i < degrees.size(); ++i) {
+        if (degrees[i - 1].name == degrees[i].name) {
+            error = "degree \"" + degrees[i].name + "\" is defined twice";
+            return false;
+        }
+    }
+    for (std::size_t i = 1; i < majors.size(); ++i) {
+        if (majors[i - 1].name == majors[i].name) {
+            error = "major \"" + majors[i].name + "\" is defined twice";
+            return false;
+        }
+    }
+    for (std::size_t i = 1; i < scholarshipMajors.size(); ++i) {
+        if (scholarshipMajors[i - 1].major == scholarshipMajors[i].major) {
+            error = "scholarships for \"" + scholarshipMajors[i].major + "\" are defined twice";
+            return false;
+        }
+    }
+
+    std::vector<CatalogDegreeRecord> degreeRecords;
+    for (const auto& degree : degrees) {
+        degreeRecords.push_back({ addString(degree.name), addString(degree.info), addList(degree.bachelors) });
+    }
+    std::vector<CatalogMajorRecord> majorRecords;
+    for (const auto& major : majors) {
+        CatalogMajorRecord record;
+        record.name = addString(major.name);
+        record.info = addString(major.info);
+        record.roadmap = addString(major.roadmap);
+        record.opportunity = addString(major.opportunity);
+        for (int year = 0; year < catalogYearCount; ++year) {
+            record.subjects[year] = addList(major.subjects[year]);
+        }
+        majorRecords.push_back(record);
+    }
+    std::vector<CatalogScholarshipMajorRecord> scholarshipMajorRecords;
+    std::vector<CatalogScholarshipRecord> scholarshipRecords;
+    for (auto& scholarshipMajor : scholarshipMajors) {
+        std::stable_sort(scholarshipMajor.awards.begin(), scholarshipMajor.awards.end(),
+            [](const std::pair<int, Scholarship>& a, const std::pair<int, Scholarship>& b) { return a.first < b.first; });
+        scholarshipMajorRecords.push_back({ addString(scholarshipMajor.major),
+            static_cast<std::uint32_t>(scholarshipRecords.size()), static_cast<std::uint32_t>(scholarshipMajor.awards.size()) });
+        for (const auto& award : scholarshipMajor.awards) {
+            scholarshipRecords.push_back({ static_cast<std::uint32_t>(award.first),
+                addString(award.second.name), addString(award.second.description) });
+        }
+    }
+
+    CatalogFileHeader header;
+    std::memcpy(header.magic, catalogFileMagic, sizeof(catalogFileMagic));
+    header.version = catalogFileVersion;
+    std::uint64_t offset = sizeof(CatalogFileHeader);
+    auto place = [&offset](CatalogTable& table, std::size_t count, std::size_t recordSize) {
+        table.offset = static_cast<std::uint32_t>(offset);
+        table.count = static_cast<std::uint32_t>(count);
+        offset += count * recordSize;
+        offset = (offset + 3) & ~std::uint64_t(3);
+    };
+    place(header.degrees, degreeRecords.size(), sizeof(CatalogDegreeRecord));
+    place(header.majors, majorRecords.size(), sizeof(CatalogMajorRecord));
+    place(header.scholarshipMajors, scholarshipMajorRecords.size(), sizeof(CatalogScholarshipMajorRecord));
+    place(header.scholarships, scholarshipRecords.size(), sizeof(CatalogScholarshipRecord));
+    place(header.stringRefs, stringRefs.size(), sizeof(CatalogStringRef));
+    place(header.strings, strings.size(), 1);
+    if (offset > UINT32_MAX) {
+        error = "catalog is larger than 4 GiB";
+        return false;
+    }
+    header.fileSize = static_cast<std::uint32_t>(offset);
+
+    std::string image(header.fileSize, '\0');
+    std::memcpy(&image[0], &header, sizeof(header));
+    auto copyTable = [&image](const CatalogTable& table, const void* records, std::size_t bytes) {
+        if (bytes > 0) {
+            std::memcpy(&image[table.offset], records, bytes);
+        }
+    };
+    copyTable(header.degrees, degreeRecords.data(), degreeRecords.size() * sizeof(CatalogDegreeRecord));
+    copyTable(header.majors, majorRecords.data(), majorRecords.size() * sizeof(CatalogMajorRecord));
+    copyTable(header.scholarshipMajors, scholarshipMajorRecords.data(), scholarshipMajorRecords.size() * sizeof(CatalogScholarshipMajorRecord));
+    copyTable(header.scholarships, scholarshipRecords.data(), scholarshipRecords.size() * sizeof(CatalogScholarshipRecord));
+    copyTable(header.stringRefs, stringRefs.data(), stringRefs.size() * sizeof(CatalogStringRef));
+    copyTable(header.strings, strings.data(), strings.size());
+
+    // A running server may have the old file mapped, so the new one is written beside it
+    // and renamed over it instead of being rewritten in place.
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(image.data(), static_cast<std::streamsize>(image.size())) || !file.flush()) {
+            error = "cannot write " + temporary;
+            return false;
+        }
+    }
+    return RenameOver(temporary, path, error);
+}
+
+int CompileCatalog(const std::string& sourcePath, const std::string& outputPath)
+{
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << sourcePath << "\n";
+        return 1;
+    }
+    CatalogSource source;
+    std::string error;
+    if (!ParseCatalogSource(in, source, error)) {
+        std::cerr << sourcePath << ": " << error << "\n";
+        return 1;
+    }
+    if (!WriteCatalogFile(source, outputPath, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    std::cout << "Compiled " << source.degrees.size() << " degrees, " << source.majors.size() << " majors and "
+        << source.scholarshipMajors.size() << " scholarship majors into " << outputPath << "\n";
+    return 0;
+}
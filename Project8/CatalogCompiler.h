@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Catalog.h"
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Editable form of the catalog, used by the text format and the compiler.
+struct CatalogSourceDegree
+{
+    std::string name;
+    std::string info;
+    std::vector<std::string> bachelors;
+};
+
+struct CatalogSourceMajor
+{
+    std::string name;
+    std::string info;
+    std::string roadmap;
+    std::string opportunity;
+    std::vector<std::string> subjects[catalogYearCount];
+};
+
+struct CatalogSourceScholarshipMajor
+{
+    std::string major;
+    std::vector<std::pair<int, Scholarship>> awards;
+};
+
+struct CatalogSource
+{
+    std::vector<CatalogSourceDegree> degrees;
+    std::vector<CatalogSourceMajor> majors;
+    std::vector<CatalogSourceScholarshipMajor> scholarshipMajors;
+};
+
+CatalogSource BuiltinCatalogSource();
+std::string EscapeCatalogValue(std::string_view value);
+bool UnescapeCatalogValue(std::string_view value, std::string& result);
+void WriteCatalogSource(const CatalogSource& source, std::ostream& out);
+bool ParseCatalogSource(std::istream& in, CatalogSource& source, std::string& error);
+bool WriteCatalogFile(const CatalogSource& source, const std::string& path, std::string& error);
+int CompileCatalog(const std::string& sourcePath, const std::string& outputPath);
@@ -0,0 +1,37 @@
+#include "CatalogIds.h"
+
+// Names the advising content was keyed by before there was one table, each of which hid
+// some of a major's content from the menus. Catalog files compiled back then still use them.
+const std::pair<std::string_view, MajorId> majorAliases[] = {
+    { "Cybersecurity", MajorId::CyberSecurity },
+    { "High Performance Computing ", MajorId::HighPerformanceComputing },
+    { "High Performing Computing", MajorId::HighPerformanceComputing },
+};
+
+bool FindDegreeId(std::string_view name, DegreeId& degree)
+{
+    for (std::size_t d = 0; d < degreeIdCount; ++d) {
+        if (degreeNames[d] == name) {
+            degree = static_cast<DegreeId>(d);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FindMajorId(std::string_view name, MajorId& major)
+{
+    for (std::size_t m = 0; m < majorIdCount; ++m) {
+        if (majorNames[m] == name) {
+            major = static_cast<MajorId>(m);
+            return true;
+        }
+    }
+    for (const auto& alias : majorAliases) {
+        if (alias.first == name) {
+            major = alias.second;
+            return true;
+        }
+    }
+    return false;
+}
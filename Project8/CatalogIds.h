@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+// The one table of degrees and majors. Inside the program a degree or major is its id,
+// and everything kept per degree or per major is a dense array indexed by it; names are
+// looked up only where text comes in (FindDegreeId, FindMajorId) and printed only where
+// it goes out.
+enum class DegreeId : std::uint8_t
+{
+    ComputerScience,
+    ComputerTechnology,
+    Unlisted  // a degree from a weight file that is not in the table; it has no majors
+};
+const std::size_t degreeIdCount = 2;
+
+// Majors are numbered degree by degree in menu order, the order GetMajorRanking() gives
+// them, so a MajorId is also the catalog ranking's major id.
+enum class MajorId : std::uint8_t
+{
+    SoftwareEngineering,
+    BusinessInformationSystems,
+    KnowledgeEngineering,
+    HighPerformanceComputing,
+    EmbeddedSystems,
+    CommunicationAndNetworking,
+    CyberSecurity
+};
+const std::size_t majorIdCount = 7;
+
+constexpr std::string_view degreeNames[degreeIdCount] = { "Computer Science", "Computer Technology" };
+constexpr std::string_view majorNames[majorIdCount] = { "Software Engineering", "Business Information Systems",
+    "Knowledge Engineering", "High Performance Computing", "Embedded Systems", "Communication and Networking",
+    "Cyber Security" };
+constexpr DegreeId majorDegrees[majorIdCount] = { DegreeId::ComputerScience, DegreeId::ComputerScience,
+    DegreeId::ComputerScience, DegreeId::ComputerScience, DegreeId::ComputerTechnology,
+    DegreeId::ComputerTechnology, DegreeId::ComputerTechnology };
+
+constexpr std::size_t Index(DegreeId degree)
+{
+    return static_cast<std::size_t>(degree);
+}
+
+constexpr std::size_t Index(MajorId major)
+{
+    return static_cast<std::size_t>(major);
+}
+
+// Only listed degrees have a name here; an Unlisted one is named by its weight file.
+constexpr std::string_view Name(DegreeId degree)
+{
+    return degreeNames[Index(degree)];
+}
+
+constexpr std::string_view Name(MajorId major)
+{
+    return majorNames[Index(major)];
+}
+
+constexpr DegreeId DegreeOf(MajorId major)
+{
+    return majorDegrees[Index(major)];
+}
+
+// The majors of `degree` are the ids [first, second); an Unlisted degree has none.
+constexpr std::pair<MajorId, MajorId> MajorsOf(DegreeId degree)
+{
+    std::size_t first = 0;
+    while (first < majorIdCount && majorDegrees[first] != degree) {
+        ++first;
+    }
+    std::size_t last = first;
+    while (last < majorIdCount && majorDegrees[last] == degree) {
+        ++last;
+    }
+    return { static_cast<MajorId>(first), static_cast<MajorId>(last) };
+}
+
+// Accept the names above, and for majors the other spellings older content used.
+bool FindDegreeId(std::string_view name, DegreeId& degree);
+bool FindMajorId(std::string_view name, MajorId& major);
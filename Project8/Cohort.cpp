@@ -0,0 +1,465 @@
+#include "Cohort.h"
+
+#include "Advisor.h"
+#include "MajorRanking.h"
+#include "MappedFile.h"
+#include "SessionExport.h"
+#include "WorkPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// Chunks are cut at the first line end past this many bytes.
+const std::size_t cohortChunkBytes = std::size_t(1) << 20;
+// Chunks in flight per worker: enough that a worker finishing early always finds another,
+// few enough that the window stays a few megabytes.
+const std::size_t cohortChunksPerThread = 4;
+// Rejected rows reported by line; the rest are only counted.
+const std::size_t cohortErrorLimit = 10;
+
+const char cohortOutputHeader[] = "student_id,degree,degree_fallback,major,major_fallback\n";
+
+struct CohortScore
+{
+    std::uint8_t degree;  // degree index
+    OutcomeFallback degreeFallback;
+    std::uint16_t major;  // MajorRanking id
+    OutcomeFallback majorFallback;
+    bool degreeRecommended;
+    bool majorsAsked;  // false when no degree was recommended or it has no majors
+    bool majorRecommended;
+};
+
+struct CohortError
+{
+    std::uint64_t line;  // within the chunk, from 0
+    std::string message;
+};
+
+// One slot of the window: a chunk's input range and everything each stage makes of it.
+// Slots are reused, so after the first few chunks the stages allocate nothing.
+struct CohortChunk
+{
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    bool done = false;
+
+    // Parsed rows.
+    std::vector<std::string_view> ids;
+    std::vector<AnswerMask> degreeAnswers;
+    std::vector<std::uint64_t> majorAnswers;  // AnswerWords() per row
+    // Scored rows.
+    std::vector<CohortScore> scores;
+    // Formatted rows.
+    std::string output;
+
+    std::uint64_t lines = 0;
+    std::uint64_t rejected = 0;
+    std::vector<CohortError> errors;  // the first cohortErrorLimit rejected rows
+};
+
+// What every task shares: the scoring tables and the names already escaped for CSV.
+struct CohortContext
+{
+    std::string_view text;
+    const DegreeWeights* weights;
+    const MajorRanking* ranking;
+    std::size_t fieldCount;
+    std::vector<std::string> degreeFields;
+    std::vector<std::string> majorFields;
+};
+
+bool ParseCohortAnswer(std::string_view field, bool& yes)
+{
+    while (!field.empty() && field.front() == ' ') {
+        field.remove_prefix(1);
+    }
+    while (!field.empty() && field.back() == ' ') {
+        field.remove_suffix(1);
+    }
+    if (field == "1" || field == "0") {
+        yes = field == "1";
+        return true;
+    }
+    const Answer answer = ClassifyAnswer(field);
+    yes = answer == Answer::Yes;
+    return answer == Answer::Yes || answer == Answer::No;
+}
+
+bool SplitCohortId(std::string_view line, std::string_view& id, std::size_t& next)
+{
+    std::size_t end = 0;
+    if (!line.empty() && line.front() == '"') {
+        end = 1;
+        while (true) {
+            end = line.find('"', end);
+            if (end == std::string_view::npos) {
+                return false;
+            }
+            if (end + 1 < line.size() && line[end + 1] == '"') {
+                end += 2;
+                continue;
+            }
+            end++;
+            break;
+        }
+        if (end < line.size() && line[end] != ',') {
+            return false;
+        }
+    }
+    else {
+        end = std::min(line.find(','), line.size());
+    }
+    id = line.substr(0, end);
+    next = end < line.size() ? end + 1 : std::string_view::npos;
+    return true;
+}
+
+void AppendCsvField(std::string& out, std::string_view field)
+{
+    if (field.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.append(field);
+        return;
+    }
+    out += '"';
+    for (const char c : field) {
+        if (c == '"') {
+            out += '"';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+void AppendCohortId(std::string& out, std::uint64_t row)
+{
+    char id[24];  // 'S', up to 20 digits and the terminator
+    std::snprintf(id, sizeof(id), "S%09llu", static_cast<unsigned long long>(row + 1));
+    out += id;
+}
+
+// Parses one row onto the end of the chunk's parsed rows; false with `error` set, and
+// nothing added, if it is malformed.
+bool ParseCohortRow(const CohortContext& context, std::string_view line, CohortChunk& chunk, std::string& error)
+{
+    std::string_view id;
+    std::size_t next = 0;
+    if (!SplitCohortId(line, id, next)) {
+        error = "unterminated quoted student ID";
+        return false;
+    }
+    const std::size_t words = context.ranking->AnswerWords();
+    const std::size_t firstWord = chunk.majorAnswers.size();
+    chunk.majorAnswers.resize(firstWord + words, 0);
+    AnswerMask degreeAnswers = 0;
+    std::size_t field = 1;
+    while (next != std::string_view::npos) {
+        const std::size_t comma = line.find(',', next);
+        const std::size_t end = comma == std::string_view::npos ? line.size() : comma;
+        if (field < context.fieldCount) {
+            bool yes = false;
+            if (!ParseCohortAnswer(line.substr(next, end - next), yes)) {
+                chunk.majorAnswers.resize(firstWord);
+                error = "field " + std::to_string(field + 1) + " is not y, n, 1 or 0";
+                return false;
+            }
+            if (field <= static_cast<std::size_t>(degreeQuestionCount)) {
+                degreeAnswers |= static_cast<AnswerMask>(yes) << (field - 1);
+            }
+            else {
+                const std::size_t question = field - 1 - degreeQuestionCount;
+                chunk.majorAnswers[firstWord + question / 64] |= static_cast<std::uint64_t>(yes) << (question % 64);
+            }
+        }
+        field++;
+        next = comma == std::string_view::npos ? std::string_view::npos : comma + 1;
+    }
+    if (field != context.fieldCount) {
+        chunk.majorAnswers.resize(firstWord);
+        error = "expected " + std::to_string(context.fieldCount) + " fields, found " + std::to_string(field);
+        return false;
+    }
+    chunk.ids.push_back(id);
+    chunk.degreeAnswers.push_back(degreeAnswers);
+    return true;
+}
+
+void ParseCohortChunk(const CohortContext& context, CohortChunk& chunk)
+{
+    chunk.ids.clear();
+    chunk.degreeAnswers.clear();
+    chunk.majorAnswers.clear();
+    chunk.lines = 0;
+    chunk.rejected = 0;
+    chunk.errors.clear();
+    std::string error;
+    std::size_t offset = chunk.begin;
+    while (offset < chunk.end) {
+        std::size_t end = context.text.find('\n', offset);
+        end = end == std::string_view::npos || end > chunk.end ? chunk.end : end;
+        std::string_view line = context.text.substr(offset, end - offset);
+        offset = end + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        chunk.lines++;
+        if (line.empty() || ParseCohortRow(context, line, chunk, error)) {
+            continue;
+        }
+        if (chunk.errors.size() < cohortErrorLimit) {
+            chunk.errors.push_back({ chunk.lines - 1, error });
+        }
+        chunk.rejected++;
+    }
+}
+
+std::uint64_t CohortAnswerRange(const std::uint64_t* words, std::uint32_t first, std::uint32_t last)
+{
+    std::uint64_t bits = 0;
+    for (std::uint32_t q = first; q < last; ++q) {
+        bits |= ((words[q / 64] >> (q % 64)) & 1) << (q - first);
+    }
+    return bits;
+}
+
+// The same outcomes a session reaches for the same answers.
+void ScoreCohortChunk(const CohortContext& context, CohortChunk& chunk)
+{
+    const std::size_t rows = chunk.ids.size();
+    const std::size_t words = context.ranking->AnswerWords();
+    chunk.scores.resize(rows);
+    for (std::size_t n = 0; n < rows; ++n) {
+        CohortScore& score = chunk.scores[n];
+        const DegreeRecommendation recommendation(chunk.degreeAnswers[n], *context.weights);
+        score.degree = static_cast<std::uint8_t>(recommendation.GetRecommendedIndex());
+        score.degreeFallback = recommendation.GetFallback();
+        score.degreeRecommended = score.degreeFallback == OutcomeFallback::None;
+        score.majorsAsked = false;
+        score.majorRecommended = false;
+        score.majorFallback = OutcomeFallback::None;
+        score.major = 0;
+        if (!score.degreeRecommended) {
+            continue;
+        }
+        const auto majors = context.ranking->DegreeMajors(context.weights->CatalogId(score.degree));
+        if (majors.first == majors.second) {
+            continue;
+        }
+        score.majorsAsked = true;
+        const std::uint32_t first = context.ranking->MajorQuestions(majors.first).first;
+        const std::uint32_t last = context.ranking->MajorQuestions(static_cast<std::uint16_t>(majors.second - 1)).second;
+        const MajorOutcome outcome = context.ranking->Outcome(majors,
+            CohortAnswerRange(chunk.majorAnswers.data() + n * words, first, last));
+        score.major = outcome.major;
+        score.majorFallback = outcome.fallback;
+        score.majorRecommended = outcome.fallback == OutcomeFallback::None;
+    }
+}
+
+void FormatCohortChunk(const CohortContext& context, CohortChunk& chunk)
+{
+    chunk.output.clear();
+    for (std::size_t n = 0; n < chunk.ids.size(); ++n) {
+        const CohortScore& score = chunk.scores[n];
+        chunk.output.append(chunk.ids[n]);
+        chunk.output += ',';
+        if (score.degreeRecommended) {
+            chunk.output.append(context.degreeFields[score.degree]);
+        }
+        chunk.output += ',';
+        chunk.output.append(FallbackName(score.degreeFallback));
+        chunk.output += ',';
+        if (score.majorRecommended) {
+            chunk.output.append(context.majorFields[score.major]);
+        }
+        chunk.output += ',';
+        if (score.majorsAsked) {
+            chunk.output.append(FallbackName(score.majorFallback));
+        }
+        chunk.output += '\n';
+    }
+}
+
+bool IsCohortHeader(std::string_view line)
+{
+    std::string_view id;
+    std::size_t next = 0;
+    if (!SplitCohortId(line, id, next) || next == std::string_view::npos) {
+        return false;
+    }
+    const std::size_t comma = line.find(',', next);
+    bool yes = false;
+    return !ParseCohortAnswer(line.substr(next, comma == std::string_view::npos ? std::string_view::npos : comma - next), yes);
+}
+
+int ScoreCohort(const std::string& inputPath, const std::string& outputPath, int threadCount)
+{
+    MappedFile input;
+    std::string error;
+    if (!input.Open(inputPath, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    const std::string temporary = outputPath + ".tmp";
+    std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        std::cerr << "Cannot write " << temporary << "\n";
+        return 1;
+    }
+
+    CohortContext context;
+    context.text = input.View();
+    context.weights = &ActiveDegreeWeights();
+    context.ranking = &GetMajorRanking();
+    context.fieldCount = 1 + degreeQuestionCount + context.ranking->QuestionCount();
+    for (std::size_t d = 0; d < context.weights->DegreeCount(); ++d) {
+        context.degreeFields.emplace_back();
+        AppendCsvField(context.degreeFields.back(), context.weights->DegreeName(d));
+    }
+    for (std::uint16_t m = 0; m < context.ranking->MajorCount(); ++m) {
+        context.majorFields.emplace_back();
+        AppendCsvField(context.majorFields.back(), context.ranking->MajorName(m));
+    }
+
+    std::size_t offset = 0;
+    std::uint64_t line = 1;
+    const std::size_t firstEnd = std::min(context.text.find('\n'), context.text.size());
+    if (IsCohortHeader(context.text.substr(0, firstEnd))) {
+        offset = std::min(firstEnd + 1, context.text.size());
+        line++;
+    }
+    output << cohortOutputHeader;
+
+    threadCount = std::max(1, threadCount);
+    std::vector<CohortChunk> slots(cohortChunksPerThread * threadCount);
+    std::mutex doneMutex;
+    std::condition_variable chunkDone;
+    std::uint64_t rows = 0;
+    std::uint64_t rejected = 0;
+    std::uint64_t chunks = 0;
+
+    const auto begin = std::chrono::steady_clock::now();
+    {
+        // Declared after the slots so that its workers are gone before the slots are.
+        WorkStealingPool pool(threadCount);
+        std::size_t issued = 0;
+        std::size_t written = 0;
+        while (true) {
+            // Read ahead until the window is full; a chunk is only cut once the one a
+            // window behind it has been written, which is the backpressure.
+            while (offset < context.text.size() && issued - written < slots.size()) {
+                CohortChunk& chunk = slots[issued % slots.size()];
+                chunk.begin = offset;
+                chunk.end = std::min(offset + cohortChunkBytes, context.text.size());
+                const std::size_t lineEnd = context.text.find('\n', chunk.end);
+                chunk.end = chunk.end == context.text.size() || lineEnd == std::string_view::npos ?
+                    context.text.size() : lineEnd + 1;
+                chunk.done = false;
+                offset = chunk.end;
+                issued++;
+                pool.Submit([&context, &chunk, &doneMutex, &chunkDone]() {
+                    ParseCohortChunk(context, chunk);
+                    ScoreCohortChunk(context, chunk);
+                    FormatCohortChunk(context, chunk);
+                    {
+                        std::lock_guard<std::mutex> lock(doneMutex);
+                        chunk.done = true;
+                    }
+                    chunkDone.notify_one();
+                });
+            }
+            if (written == issued) {
+                break;
+            }
+            CohortChunk& chunk = slots[written % slots.size()];
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                chunkDone.wait(lock, [&]() { return chunk.done; });
+            }
+            output.write(chunk.output.data(), static_cast<std::streamsize>(chunk.output.size()));
+            for (const CohortError& rowError : chunk.errors) {
+                if (rejected++ < cohortErrorLimit) {
+                    std::cerr << inputPath << ":" << line + rowError.line << ": " << rowError.message << "\n";
+                }
+            }
+            rejected += chunk.rejected - chunk.errors.size();
+            // Nothing reads the chunk's input again, so its pages can go.
+            input.Release(chunk.begin, chunk.end - chunk.begin);
+            rows += chunk.ids.size();
+            line += chunk.lines;
+            chunks++;
+            written++;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    output.flush();
+    if (!output) {
+        std::cerr << "Cannot write " << temporary << "\n";
+        return 1;
+    }
+    output.close();
+    if (!RenameOver(temporary, outputPath, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    if (rejected > cohortErrorLimit) {
+        std::cerr << rejected - cohortErrorLimit << " more rows rejected\n";
+    }
+    std::cout << "rows=" << rows << " rejected=" << rejected << " chunks=" << chunks << " threads=" << threadCount
+        << std::fixed << std::setprecision(3) << " seconds=" << seconds
+        << " rows_per_second=" << (seconds > 0 ? rows / seconds : 0.0) << "\n";
+    return rejected == 0 ? 0 : 1;
+}
+
+int MakeCohort(const std::string& path, std::uint64_t rows, std::uint64_t seed)
+{
+    const MajorRanking& ranking = GetMajorRanking();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Cannot write " << path << "\n";
+        return 1;
+    }
+    std::string buffer = "student_id";
+    for (int k = 0; k < degreeQuestionCount; ++k) {
+        buffer += ",degree_q" + std::to_string(k + 1);
+    }
+    for (std::uint32_t q = 0; q < ranking.QuestionCount(); ++q) {
+        buffer += ",major_q" + std::to_string(q + 1);
+    }
+    buffer += '\n';
+
+    std::mt19937_64 random(seed);
+    const std::size_t answers = degreeQuestionCount + ranking.QuestionCount();
+    for (std::uint64_t n = 0; n < rows; ++n) {
+        AppendCohortId(buffer, n);
+        std::uint64_t bits = 0;
+        for (std::size_t a = 0; a < answers; ++a) {
+            if (a % 64 == 0) {
+                bits = random();
+            }
+            buffer += (bits >> (a % 64)) & 1 ? ",y" : ",n";
+        }
+        buffer += '\n';
+        if (buffer.size() >= cohortChunkBytes) {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    if (!file) {
+        std::cerr << "Cannot write " << path << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Scores a whole admissions cohort from a CSV file, without running a session per student.
+//
+// Each row is a student ID, the degreeQuestionCount degree answers, then one answer per
+// question of GetMajorRanking(), every degree's questions in the order they are asked.
+// An answer is y, yes, n, no, 1 or 0, in any case; the ID may be quoted. A first line
+// whose second field is not an answer is taken for a header. Rows must not span lines.
+//
+// Each output row is the ID as given, the recommended degree and its fallback, then the
+// recommended major among that degree's majors and its fallback. A degree or major is
+// left empty where the advisor would have had the student choose one instead.
+//
+// The input is mapped and cut into chunks at line ends. Each chunk is parsed, scored and
+// formatted as one task on a WorkStealingPool, and the calling thread writes finished
+// chunks in input order. Only a fixed window of chunks is in flight at a time, so however
+// large the input, memory is bounded by the window and not the file. Rejected rows are
+// reported by line number and left out.
+int ScoreCohort(const std::string& inputPath, const std::string& outputPath, int threadCount);
+
+// Row parsing shared with --train-weights. An answer is y, yes, n, no, 1 or 0 in any case,
+// with surrounding spaces ignored.
+bool ParseCohortAnswer(std::string_view field, bool& yes);
+// The first field of `line`, quoted or not, and where the field after it starts; npos
+// when it is the last. False for a quoted field that never closes.
+bool SplitCohortId(std::string_view line, std::string_view& id, std::size_t& next);
+// Whether the first line is a header rather than a student: its second field is not an
+// answer.
+bool IsCohortHeader(std::string_view line);
+// Bits [first, last) of a row's answers, which span at most 64 questions, shifted down to
+// bit 0.
+std::uint64_t CohortAnswerRange(const std::uint64_t* words, std::uint32_t first, std::uint32_t last);
+// Appends `field` to `out`, quoted if it needs to be.
+void AppendCsvField(std::string& out, std::string_view field);
+// Appends the made-up ID of the `row`th student, from 0, that the generators write.
+void AppendCohortId(std::string& out, std::uint64_t row);
+
+// Writes a cohort of `rows` students with made-up answers, with a header.
+int MakeCohort(const std::string& path, std::uint64_t rows, std::uint64_t seed);
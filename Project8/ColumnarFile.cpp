@@ -0,0 +1,454 @@
+#include "ColumnarFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+void ColumnValues::Clear()
+{
+    bools.clear();
+    ints.clear();
+    doubles.clear();
+    strings.clear();
+}
+
+template <typename Unsigned>
+void AppendLittleEndian(std::string& out, Unsigned value)
+{
+    for (std::size_t k = 0; k < sizeof(Unsigned); ++k) {
+        out.push_back(static_cast<char>((value >> (8 * k)) & 0xFF));
+    }
+}
+
+template <typename Unsigned>
+bool ReadLittleEndian(std::string_view& in, Unsigned& value)
+{
+    if (in.size() < sizeof(Unsigned)) {
+        return false;
+    }
+    value = 0;
+    for (std::size_t k = 0; k < sizeof(Unsigned); ++k) {
+        value |= static_cast<Unsigned>(static_cast<unsigned char>(in[k])) << (8 * k);
+    }
+    in.remove_prefix(sizeof(Unsigned));
+    return true;
+}
+
+int BitWidth(std::uint64_t value)
+{
+    int width = 0;
+    while (value) {
+        ++width;
+        value >>= 1;
+    }
+    return width;
+}
+
+// Appends `width` bits of each value, packed with no padding between values.
+void PackBits(const std::uint64_t* values, std::size_t count, int width, std::string& out)
+{
+    const std::size_t start = out.size();
+    out.resize(start + (count * width + 7) / 8, '\0');
+    std::size_t bit = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        for (int done = 0; done < width;) {
+            const int offset = static_cast<int>(bit % 8);
+            const int take = std::min(8 - offset, width - done);
+            const unsigned bits = static_cast<unsigned>((values[i] >> done) & ((1u << take) - 1));
+            char& byte = out[start + bit / 8];
+            byte = static_cast<char>(static_cast<unsigned char>(byte) | (bits << offset));
+            done += take;
+            bit += take;
+        }
+    }
+}
+
+bool UnpackBits(std::string_view& in, std::size_t count, int width, std::vector<std::uint64_t>& values)
+{
+    const std::size_t bytes = (count * width + 7) / 8;
+    if (width < 0 || width > 64 || in.size() < bytes) {
+        return false;
+    }
+    values.assign(count, 0);
+    std::size_t bit = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t value = 0;
+        for (int done = 0; done < width;) {
+            const int offset = static_cast<int>(bit % 8);
+            const int take = std::min(8 - offset, width - done);
+            const std::uint64_t bits = (static_cast<unsigned char>(in[bit / 8]) >> offset) & ((1u << take) - 1);
+            value |= bits << done;
+            done += take;
+            bit += take;
+        }
+        values[i] = value;
+    }
+    in.remove_prefix(bytes);
+    return true;
+}
+
+void EncodeColumn(ColumnType type, const ColumnValues& values, std::size_t rows, std::string& out)
+{
+    std::vector<std::uint64_t> packed(rows);
+    switch (type) {
+    case ColumnType::Bool:
+        std::copy(values.bools.begin(), values.bools.begin() + rows, packed.begin());
+        PackBits(packed.data(), rows, 1, out);
+        break;
+
+    case ColumnType::Int32: {
+        const std::int64_t base = rows ? *std::min_element(values.ints.begin(), values.ints.begin() + rows) : 0;
+        std::uint64_t largest = 0;
+        for (std::size_t r = 0; r < rows; ++r) {
+            packed[r] = static_cast<std::uint64_t>(values.ints[r]) - static_cast<std::uint64_t>(base);
+            largest = std::max(largest, packed[r]);
+        }
+        AppendLittleEndian(out, static_cast<std::uint64_t>(base));
+        out.push_back(static_cast<char>(BitWidth(largest)));
+        PackBits(packed.data(), rows, BitWidth(largest), out);
+        break;
+    }
+
+    case ColumnType::Int64: {
+        if (rows == 0) {
+            break;
+        }
+        std::int64_t smallestStep = 0;
+        for (std::size_t r = 1; r < rows; ++r) {
+            const std::int64_t step = static_cast<std::int64_t>(
+                static_cast<std::uint64_t>(values.ints[r]) - static_cast<std::uint64_t>(values.ints[r - 1]));
+            smallestStep = r == 1 ? step : std::min(smallestStep, step);
+        }
+        std::uint64_t largest = 0;
+        for (std::size_t r = 1; r < rows; ++r) {
+            packed[r - 1] = static_cast<std::uint64_t>(values.ints[r]) - static_cast<std::uint64_t>(values.ints[r - 1])
+                - static_cast<std::uint64_t>(smallestStep);
+            largest = std::max(largest, packed[r - 1]);
+        }
+        AppendLittleEndian(out, static_cast<std::uint64_t>(values.ints[0]));
+        AppendLittleEndian(out, static_cast<std::uint64_t>(smallestStep));
+        out.push_back(static_cast<char>(BitWidth(largest)));
+        PackBits(packed.data(), rows - 1, BitWidth(largest), out);
+        break;
+    }
+
+    case ColumnType::Float64:
+        for (std::size_t r = 0; r < rows; ++r) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &values.doubles[r], sizeof(bits));
+            AppendLittleEndian(out, bits);
+        }
+        break;
+
+    case ColumnType::String: {
+        std::unordered_map<std::string_view, std::uint32_t> codes;
+        std::vector<std::string_view> dictionary;
+        for (std::size_t r = 0; r < rows; ++r) {
+            const auto inserted = codes.emplace(values.strings[r], static_cast<std::uint32_t>(dictionary.size()));
+            if (inserted.second) {
+                dictionary.push_back(values.strings[r]);
+            }
+            packed[r] = inserted.first->second;
+        }
+        AppendLittleEndian(out, static_cast<std::uint32_t>(dictionary.size()));
+        for (const std::string_view entry : dictionary) {
+            AppendLittleEndian(out, static_cast<std::uint32_t>(entry.size()));
+            out.append(entry.data(), entry.size());
+        }
+        const int width = dictionary.empty() ? 0 : BitWidth(dictionary.size() - 1);
+        out.push_back(static_cast<char>(width));
+        PackBits(packed.data(), rows, width, out);
+        break;
+    }
+    }
+}
+
+bool DecodeColumn(ColumnType type, std::string_view in, std::size_t rows, ColumnValues& values)
+{
+    values.Clear();
+    std::vector<std::uint64_t> packed;
+    switch (type) {
+    case ColumnType::Bool:
+        if (!UnpackBits(in, rows, 1, packed)) {
+            return false;
+        }
+        values.bools.assign(packed.begin(), packed.end());
+        return true;
+
+    case ColumnType::Int32: {
+        std::uint64_t base;
+        if (!ReadLittleEndian(in, base) || in.empty()) {
+            return false;
+        }
+        const int width = static_cast<unsigned char>(in[0]);
+        in.remove_prefix(1);
+        if (!UnpackBits(in, rows, width, packed)) {
+            return false;
+        }
+        values.ints.resize(rows);
+        for (std::size_t r = 0; r < rows; ++r) {
+            values.ints[r] = static_cast<std::int64_t>(base + packed[r]);
+        }
+        return true;
+    }
+
+    case ColumnType::Int64: {
+        if (rows == 0) {
+            return true;
+        }
+        std::uint64_t first;
+        std::uint64_t smallestStep;
+        if (!ReadLittleEndian(in, first) || !ReadLittleEndian(in, smallestStep) || in.empty()) {
+            return false;
+        }
+        const int width = static_cast<unsigned char>(in[0]);
+        in.remove_prefix(1);
+        if (!UnpackBits(in, rows - 1, width, packed)) {
+            return false;
+        }
+        values.ints.resize(rows);
+        std::uint64_t value = first;
+        values.ints[0] = static_cast<std::int64_t>(value);
+        for (std::size_t r = 1; r < rows; ++r) {
+            value += smallestStep + packed[r - 1];
+            values.ints[r] = static_cast<std::int64_t>(value);
+        }
+        return true;
+    }
+
+    case ColumnType::Float64:
+        values.doubles.resize(rows);
+        for (std::size_t r = 0; r < rows; ++r) {
+            std::uint64_t bits;
+            if (!ReadLittleEndian(in, bits)) {
+                return false;
+            }
+            std::memcpy(&values.doubles[r], &bits, sizeof(bits));
+        }
+        return true;
+
+    case ColumnType::String: {
+        std::uint32_t entries;
+        if (!ReadLittleEndian(in, entries) || entries > in.size() / 4) {
+            return false;
+        }
+        std::vector<std::string_view> dictionary(entries);
+        for (std::string_view& entry : dictionary) {
+            std::uint32_t length;
+            if (!ReadLittleEndian(in, length) || length > in.size()) {
+                return false;
+            }
+            entry = in.substr(0, length);
+            in.remove_prefix(length);
+        }
+        if (in.empty()) {
+            return false;
+        }
+        const int width = static_cast<unsigned char>(in[0]);
+        in.remove_prefix(1);
+        if (!UnpackBits(in, rows, width, packed)) {
+            return false;
+        }
+        values.strings.resize(rows);
+        for (std::size_t r = 0; r < rows; ++r) {
+            if (packed[r] >= dictionary.size()) {
+                return false;
+            }
+            values.strings[r] = dictionary[packed[r]];
+        }
+        return true;
+    }
+    }
+    return false;
+}
+
+ColumnarWriter::ColumnarWriter() : written(0)
+{
+}
+
+ColumnarWriter::~ColumnarWriter()
+{
+    if (file.is_open()) {
+        file.close();
+        std::remove((path + ".tmp").c_str());
+    }
+}
+
+bool ColumnarWriter::IsOpen() const
+{
+    return file.is_open();
+}
+
+bool ColumnarWriter::Open(const std::string& path, const std::vector<ColumnSpec>& columns, std::string& error)
+{
+    this->path = path;
+    this->columns = columns;
+    groupRows.clear();
+    chunks.clear();
+    file.open(path + ".tmp", std::ios::binary | std::ios::trunc);
+    file.write(columnarFileMagic, sizeof(columnarFileMagic));
+    if (!file) {
+        error = "cannot write " + path + ".tmp";
+        file.close();
+        return false;
+    }
+    written = sizeof(columnarFileMagic);
+    return true;
+}
+
+bool ColumnarWriter::WriteRowGroup(const std::vector<ColumnValues>& values, std::size_t rows, std::string& error)
+{
+    if (rows == 0) {
+        return true;
+    }
+    for (std::size_t c = 0; c < columns.size(); ++c) {
+        chunk.clear();
+        EncodeColumn(columns[c].type, values[c], rows, chunk);
+        file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        chunks.push_back({ written, chunk.size() });
+        written += chunk.size();
+    }
+    groupRows.push_back(static_cast<std::uint32_t>(rows));
+    if (!file) {
+        error = "cannot write " + path + ".tmp";
+        return false;
+    }
+    return true;
+}
+
+bool ColumnarWriter::Close(std::string& error)
+{
+    std::string footer;
+    AppendLittleEndian(footer, columnarFileVersion);
+    AppendLittleEndian(footer, static_cast<std::uint32_t>(columns.size()));
+    for (const ColumnSpec& column : columns) {
+        footer.push_back(static_cast<char>(column.type));
+        AppendLittleEndian(footer, static_cast<std::uint32_t>(column.name.size()));
+        footer += column.name;
+    }
+    AppendLittleEndian(footer, static_cast<std::uint32_t>(groupRows.size()));
+    for (std::size_t g = 0; g < groupRows.size(); ++g) {
+        AppendLittleEndian(footer, groupRows[g]);
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            AppendLittleEndian(footer, chunks[g * columns.size() + c].offset);
+            AppendLittleEndian(footer, chunks[g * columns.size() + c].size);
+        }
+    }
+    AppendLittleEndian(footer, static_cast<std::uint32_t>(footer.size()));
+    footer.append(columnarFileMagic, sizeof(columnarFileMagic));
+    file.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    file.close();
+    const std::string temporary = path + ".tmp";
+    if (!file) {
+        error = "cannot write " + temporary;
+        return false;
+    }
+    return RenameOver(temporary, path, error);
+}
+
+bool ColumnarReader::Open(const std::string& path, std::string& error)
+{
+    columns.clear();
+    groupRows.clear();
+    chunkOffsets.clear();
+    chunkSizes.clear();
+    if (!file.Open(path, error)) {
+        return false;
+    }
+    const std::string_view data = file.View();
+    const std::size_t magicSize = sizeof(columnarFileMagic);
+    std::string_view tail = data.size() >= 2 * magicSize + 4 ? data.substr(data.size() - magicSize - 4) : std::string_view();
+    std::uint32_t footerSize = 0;
+    if (tail.empty() || data.compare(0, magicSize, columnarFileMagic, magicSize) != 0 ||
+        tail.compare(4, magicSize, columnarFileMagic, magicSize) != 0) {
+        error = path + " is not a columnar file";
+        return false;
+    }
+    ReadLittleEndian(tail, footerSize);
+    const std::size_t footerEnd = data.size() - magicSize - 4;
+    if (footerSize > footerEnd - magicSize) {
+        error = path + " is truncated or corrupt";
+        return false;
+    }
+    std::string_view footer = data.substr(footerEnd - footerSize, footerSize);
+    const std::size_t chunksEnd = footerEnd - footerSize;
+
+    std::uint32_t version = 0;
+    std::uint32_t columnCount = 0;
+    if (!ReadLittleEndian(footer, version) || version != columnarFileVersion) {
+        error = path + " has columnar version " + std::to_string(version) + ", expected " + std::to_string(columnarFileVersion);
+        return false;
+    }
+    bool intact = ReadLittleEndian(footer, columnCount) && columnCount <= footer.size() / 5;
+    for (std::uint32_t c = 0; intact && c < columnCount; ++c) {
+        std::uint32_t nameSize = 0;
+        intact = !footer.empty() && static_cast<unsigned char>(footer[0]) <= static_cast<unsigned char>(ColumnType::String);
+        if (intact) {
+            const ColumnType type = static_cast<ColumnType>(footer[0]);
+            footer.remove_prefix(1);
+            intact = ReadLittleEndian(footer, nameSize) && nameSize <= footer.size();
+            if (intact) {
+                columns.push_back({ std::string(footer.substr(0, nameSize)), type });
+                footer.remove_prefix(nameSize);
+            }
+        }
+    }
+    std::uint32_t groupCount = 0;
+    intact = intact && ReadLittleEndian(footer, groupCount) && groupCount <= footer.size() / 4;
+    for (std::uint32_t g = 0; intact && g < groupCount; ++g) {
+        std::uint32_t rows = 0;
+        intact = ReadLittleEndian(footer, rows);
+        groupRows.push_back(rows);
+        for (std::uint32_t c = 0; intact && c < columnCount; ++c) {
+            std::uint64_t offset = 0;
+            std::uint64_t size = 0;
+            intact = ReadLittleEndian(footer, offset) && ReadLittleEndian(footer, size) &&
+                offset >= magicSize && offset <= chunksEnd && size <= chunksEnd - offset;
+            chunkOffsets.push_back(offset);
+            chunkSizes.push_back(size);
+        }
+    }
+    if (!intact || !footer.empty()) {
+        error = path + " is truncated or corrupt";
+        columns.clear();
+        groupRows.clear();
+        return false;
+    }
+    return true;
+}
+
+const std::vector<ColumnSpec>& ColumnarReader::Columns() const
+{
+    return columns;
+}
+
+std::size_t ColumnarReader::RowGroupCount() const
+{
+    return groupRows.size();
+}
+
+std::size_t ColumnarReader::RowGroupRows(std::size_t group) const
+{
+    return groupRows[group];
+}
+
+std::uint64_t ColumnarReader::RowCount() const
+{
+    std::uint64_t rows = 0;
+    for (const std::uint32_t group : groupRows) {
+        rows += group;
+    }
+    return rows;
+}
+
+bool ColumnarReader::ReadColumn(std::size_t group, std::size_t column, ColumnValues& values, std::string& error) const
+{
+    const std::size_t chunk = group * columns.size() + column;
+    const std::string_view data(file.Data() + chunkOffsets[chunk], static_cast<std::size_t>(chunkSizes[chunk]));
+    if (!DecodeColumn(columns[column].type, data, groupRows[group], values)) {
+        error = "column " + columns[column].name + " of row group " + std::to_string(group) + " is corrupt";
+        return false;
+    }
+    return true;
+}
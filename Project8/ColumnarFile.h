@@ -0,0 +1,112 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A columnar table file for handing results to other tools. Rows are written in row
+// groups; within a group each column is one contiguous chunk, so a reader that wants two
+// columns reads two chunks and skips the rest. Each column type has its own encoding:
+//
+//   Bool     bit-packed, one bit per row
+//   Int32    frame of reference: the smallest value, then every value less it bit-packed
+//            at the width of the largest difference
+//   Int64    delta: the first value and the smallest step, then every step less that
+//            bit-packed, which suits timestamps written roughly in order
+//   Float64  plain 8-byte values
+//   String   dictionary: the distinct values in order of first use, then bit-packed codes
+//
+// Layout: magic, the chunks of every row group, the footer (schema, then each group's row
+// count and chunk offsets and sizes), the footer size, magic. Everything is little-endian
+// and bits fill each byte from the lowest.
+const char columnarFileMagic[8] = { 'S', 'M', 'S', 'C', 'O', 'L', 'S', '1' };
+const std::uint32_t columnarFileVersion = 1;
+
+enum class ColumnType : std::uint8_t
+{
+    Bool,
+    Int32,
+    Int64,
+    Float64,
+    String
+};
+
+struct ColumnSpec
+{
+    std::string name;
+    ColumnType type;
+};
+
+// One row group's values of one column; only the vector for the column's type is used.
+// Bools are 0 or 1. Strings written must stay alive until the group is written; strings
+// read are views into the reader's mapping.
+struct ColumnValues
+{
+    std::vector<std::uint8_t> bools;
+    std::vector<std::int64_t> ints;
+    std::vector<double> doubles;
+    std::vector<std::string_view> strings;
+
+    void Clear();
+};
+
+// Writes to PATH.tmp and renames it over PATH on Close, so a reader never sees a file
+// without its footer. Only the footer's offsets stay in memory between row groups.
+class ColumnarWriter
+{
+public:
+    ColumnarWriter();
+    ~ColumnarWriter();
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    bool Open(const std::string& path, const std::vector<ColumnSpec>& columns, std::string& error);
+    // `values` holds one ColumnValues per column, each with `rows` values.
+    bool WriteRowGroup(const std::vector<ColumnValues>& values, std::size_t rows, std::string& error);
+    bool Close(std::string& error);
+    bool IsOpen() const;
+
+private:
+    struct ChunkRef
+    {
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    std::string path;
+    std::ofstream file;
+    std::vector<ColumnSpec> columns;
+    std::vector<std::uint32_t> groupRows;
+    std::vector<ChunkRef> chunks;  // columns.size() per row group
+    std::uint64_t written;
+    std::string chunk;  // reused for every chunk
+};
+
+// Maps a columnar file and decodes one column chunk at a time.
+class ColumnarReader
+{
+public:
+    ColumnarReader() = default;
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    bool Open(const std::string& path, std::string& error);
+    const std::vector<ColumnSpec>& Columns() const;
+    std::size_t RowGroupCount() const;
+    std::size_t RowGroupRows(std::size_t group) const;
+    std::uint64_t RowCount() const;
+    // Replaces `values` with the column's values in row group `group`.
+    bool ReadColumn(std::size_t group, std::size_t column, ColumnValues& values, std::string& error) const;
+
+private:
+    MappedFile file;
+    std::vector<ColumnSpec> columns;
+    std::vector<std::uint32_t> groupRows;
+    std::vector<std::uint64_t> chunkOffsets;  // columns.size() per row group
+    std::vector<std::uint64_t> chunkSizes;
+};
@@ -0,0 +1,540 @@
+#include "ContentSearch.h"
+
+#include "Advisor.h"
+#include "Display.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Lower-cases ASCII letters and digits and turns everything else into a space, byte for
+// byte, so positions in the result are positions in the original text.
+void NormalizeContent(std::string_view value, std::string& out)
+{
+    for (const char c : value) {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        out.push_back(byte < 0x80 && std::isalnum(byte) ? static_cast<char>(std::tolower(byte)) : ' ');
+    }
+}
+
+std::uint32_t TrigramKey(const char* trigram)
+{
+    return (static_cast<std::uint32_t>(static_cast<unsigned char>(trigram[0])) << 16) |
+        (static_cast<std::uint32_t>(static_cast<unsigned char>(trigram[1])) << 8) |
+        static_cast<std::uint32_t>(static_cast<unsigned char>(trigram[2]));
+}
+
+const std::uint32_t blankTrigram = (' ' << 16) | (' ' << 8) | ' ';
+
+// How many of the documents closest to a query, by shared trigrams, are ranked word by word.
+const std::size_t contentShortlist = 256;
+
+std::string_view ContentSectionName(ContentSection section)
+{
+    switch (section) {
+    case ContentSection::DegreeInfo:
+        return "Degree overview";
+    case ContentSection::MajorInfo:
+        return "Major information";
+    case ContentSection::Roadmap:
+        return "Roadmap";
+    case ContentSection::Opportunity:
+        return "Opportunities";
+    case ContentSection::Subject:
+        return "Subject";
+    }
+    return "";
+}
+
+void ContentIndex::Add(std::string_view owner, ContentSection section, int year, std::string_view value)
+{
+    Document document;
+    if (!documents.empty() && Slice(text, documents.back().owner) == owner) {
+        document.owner = documents.back().owner;
+    }
+    else {
+        document.owner = { static_cast<std::uint32_t>(text.size()), static_cast<std::uint32_t>(owner.size()) };
+        text.append(owner);
+    }
+    document.text = { static_cast<std::uint32_t>(text.size()), static_cast<std::uint32_t>(value.size()) };
+    text.append(value);
+
+    document.normalized = { static_cast<std::uint32_t>(normalizedText.size()), static_cast<std::uint32_t>(value.size() + 2) };
+    normalizedText.push_back(' ');
+    NormalizeContent(value, normalizedText);
+    normalizedText.push_back(' ');
+
+    document.section = section;
+    document.year = static_cast<std::uint8_t>(year);
+    documents.push_back(document);
+}
+
+// Indexes every degree overview and every section of every major in the active catalog.
+void ContentIndex::AddCatalog()
+{
+    for (std::size_t d = 0; d < degreeIdCount; ++d) {
+        std::ostringstream info;
+        DisplayDegreeInfo(static_cast<DegreeId>(d), info);
+        Add(degreeNames[d], ContentSection::DegreeInfo, 0, info.str());
+    }
+
+    if (activeCatalog) {
+        for (std::size_t m = 0; m < majorIdCount; ++m) {
+            const CatalogMajorRecord& major = activeCatalog->Major(static_cast<MajorId>(m));
+            const std::string_view name = majorNames[m];
+            if (major.info.length > 0) {
+                Add(name, ContentSection::MajorInfo, 0, activeCatalog->String(major.info));
+            }
+            if (major.roadmap.length > 0) {
+                Add(name, ContentSection::Roadmap, 0, activeCatalog->String(major.roadmap));
+            }
+            if (major.opportunity.length > 0) {
+                Add(name, ContentSection::Opportunity, 0, activeCatalog->String(major.opportunity));
+            }
+            for (int y = 0; y < catalogYearCount; ++y) {
+                for (const std::string_view subject : activeCatalog->List(major.subjects[y])) {
+                    Add(name, ContentSection::Subject, y + 1, subject);
+                }
+            }
+        }
+        return;
+    }
+    for (const MajorCatalogEntry& major : majorCatalog) {
+        if (!major.info.empty()) {
+            Add(major.name, ContentSection::MajorInfo, 0, major.info);
+        }
+        if (!major.roadmap.empty()) {
+            Add(major.name, ContentSection::Roadmap, 0, major.roadmap);
+        }
+        if (!major.opportunity.empty()) {
+            Add(major.name, ContentSection::Opportunity, 0, major.opportunity);
+        }
+        for (int y = 0; y < catalogYearCount; ++y) {
+            for (const std::string_view subject : major.subjects[y]) {
+                Add(major.name, ContentSection::Subject, y + 1, subject);
+            }
+        }
+    }
+}
+
+// Builds the trigram postings from every document added so far.
+void ContentIndex::Build()
+{
+    std::vector<std::uint64_t> pairs;
+    for (std::uint32_t id = 0; id < documents.size(); ++id) {
+        const std::string_view normalized = Slice(normalizedText, documents[id].normalized);
+        for (std::size_t i = 0; i + 3 <= normalized.size(); ++i) {
+            const std::uint32_t key = TrigramKey(normalized.data() + i);
+            if (key != blankTrigram) {
+                pairs.push_back((static_cast<std::uint64_t>(key) << 32) | id);
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    trigramKeys.clear();
+    trigramStarts.clear();
+    trigramDocuments.clear();
+    trigramDocuments.reserve(pairs.size());
+    for (const std::uint64_t pair : pairs) {
+        const std::uint32_t key = static_cast<std::uint32_t>(pair >> 32);
+        if (trigramKeys.empty() || trigramKeys.back() != key) {
+            trigramKeys.push_back(key);
+            trigramStarts.push_back(static_cast<std::uint32_t>(trigramDocuments.size()));
+        }
+        trigramDocuments.push_back(static_cast<std::uint32_t>(pair));
+    }
+    trigramStarts.push_back(static_cast<std::uint32_t>(trigramDocuments.size()));
+}
+
+std::size_t ContentIndex::Size() const
+{
+    return documents.size();
+}
+
+std::string_view ContentIndex::Owner(std::uint32_t document) const
+{
+    return Slice(text, documents[document].owner);
+}
+
+ContentSection ContentIndex::Section(std::uint32_t document) const
+{
+    return documents[document].section;
+}
+
+int ContentIndex::Year(std::uint32_t document) const
+{
+    return documents[document].year;
+}
+
+std::string_view ContentIndex::Text(std::uint32_t document) const
+{
+    return Slice(text, documents[document].text);
+}
+
+std::string_view ContentIndex::Slice(const std::string& arena, const CatalogStringRef& ref) const
+{
+    return std::string_view(arena).substr(ref.offset, ref.length);
+}
+
+ContentIndex::QueryWord::QueryWord(std::string_view word)
+    : bare(word), prefix(" " + std::string(word)), whole(" " + std::string(word) + " ")
+{
+    for (std::size_t i = 0; i + 3 <= whole.size(); ++i) {
+        trigrams.push_back(TrigramKey(whole.data() + i));
+    }
+}
+
+// The documents containing `key`, as a range of trigramDocuments; empty when none do.
+std::pair<std::uint32_t, std::uint32_t> ContentIndex::Postings(std::uint32_t key) const
+{
+    const auto it = std::lower_bound(trigramKeys.begin(), trigramKeys.end(), key);
+    if (it == trigramKeys.end() || *it != key) {
+        return { 0, 0 };
+    }
+    const std::size_t slot = static_cast<std::size_t>(it - trigramKeys.begin());
+    return { trigramStarts[slot], trigramStarts[slot + 1] };
+}
+
+// Question words that say nothing about the content, and words that say which section
+// the student is after rather than what it should contain.
+const std::string_view contentStopWords[] = { "a", "about", "an", "and", "any", "are", "at", "be", "by", "can",
+    "do", "does", "for", "from", "how", "i", "in", "is", "it", "me", "mention", "mentions", "my", "of", "on", "or",
+    "show", "the", "there", "to", "what", "when", "where", "which", "who", "with" };
+
+struct ContentSectionHint
+{
+    std::string_view word;
+    ContentSection section;
+};
+
+const ContentSectionHint contentSectionHints[] = {
+    { "career", ContentSection::Opportunity }, { "careers", ContentSection::Opportunity },
+    { "job", ContentSection::Opportunity }, { "jobs", ContentSection::Opportunity },
+    { "class", ContentSection::Subject }, { "classes", ContentSection::Subject },
+    { "course", ContentSection::Subject }, { "courses", ContentSection::Subject },
+    { "subject", ContentSection::Subject }, { "subjects", ContentSection::Subject },
+    { "taught", ContentSection::Subject }, { "teach", ContentSection::Subject },
+    { "roadmap", ContentSection::Roadmap }, { "steps", ContentSection::Roadmap },
+};
+
+ContentIndex::ParsedQuery ContentIndex::ParseQuery(std::string_view query) const
+{
+    std::string normalized;
+    NormalizeContent(query, normalized);
+    std::istringstream in(normalized);
+    std::vector<std::string> all;
+    std::string word;
+    while (in >> word) {
+        all.push_back(word);
+    }
+
+    ParsedQuery parsed;
+    parsed.hasSection = false;
+    parsed.section = ContentSection::MajorInfo;
+    for (const std::string& candidate : all) {
+        const auto hint = std::find_if(std::begin(contentSectionHints), std::end(contentSectionHints),
+            [&candidate](const ContentSectionHint& entry) { return entry.word == candidate; });
+        if (hint != std::end(contentSectionHints)) {
+            parsed.hasSection = true;
+            parsed.section = hint->section;
+        }
+        else if (std::find(std::begin(contentStopWords), std::end(contentStopWords), candidate) == std::end(contentStopWords)) {
+            parsed.words.emplace_back(candidate);
+        }
+    }
+    // A query made only of such words is taken literally.
+    if (parsed.words.empty()) {
+        parsed.hasSection = false;
+        for (const std::string& candidate : all) {
+            parsed.words.emplace_back(candidate);
+        }
+    }
+
+    if (parsed.words.size() > 1) {
+        for (const QueryWord& queryWord : parsed.words) {
+            parsed.phrase += queryWord.prefix;
+        }
+    }
+    return parsed;
+}
+
+// How well one query word matches a document: 1 as a whole word, 0.8 as the start of
+// a word, 0.7 as a word start once a plural "s" is dropped, 0.6 anywhere, and otherwise
+// up to 0.5 in proportion to the trigrams it shares, when at least half are present.
+// Which of the word's trigrams the document has is read from the postings, so the text
+// is only searched when those make a match possible.
+double ContentIndex::MatchWord(std::uint32_t document, const QueryWord& word,
+    const std::vector<std::pair<std::uint32_t, std::uint32_t>>& postings) const
+{
+    const std::size_t count = word.trigrams.size();
+    std::size_t found = 0;
+    std::size_t innerFound = 0;
+    bool leading = false;
+    bool trailing = false;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto first = trigramDocuments.begin() + postings[i].first;
+        const auto last = trigramDocuments.begin() + postings[i].second;
+        if (!std::binary_search(first, last, document)) {
+            continue;
+        }
+        ++found;
+        if (i == 0) {
+            leading = true;
+        }
+        else if (i + 1 == count) {
+            trailing = true;
+        }
+        else {
+            ++innerFound;
+        }
+    }
+    const bool inner = count < 2 || innerFound == count - 2;
+
+    const std::string_view normalized = Slice(normalizedText, documents[document].normalized);
+    if (leading && inner && trailing && normalized.find(word.whole) != std::string_view::npos) {
+        return 1.0;
+    }
+    if (leading && inner && normalized.find(word.prefix) != std::string_view::npos) {
+        return 0.8;
+    }
+    if (leading && word.prefix.size() > 4 && word.prefix.back() == 's' &&
+        normalized.find(std::string_view(word.prefix).substr(0, word.prefix.size() - 1)) != std::string_view::npos) {
+        return 0.7;
+    }
+    if (inner && normalized.find(word.bare) != std::string_view::npos) {
+        return 0.6;
+    }
+    return found * 2 >= count ? 0.5 * found / count : 0.0;
+}
+
+std::size_t ContentIndex::Search(std::string_view query, std::size_t limit, std::vector<ContentHit>& hits) const
+{
+    hits.clear();
+    const ParsedQuery parsed = ParseQuery(query);
+    const std::vector<QueryWord>& words = parsed.words;
+
+    std::vector<std::uint32_t> keys;
+    std::vector<std::vector<std::pair<std::uint32_t, std::uint32_t>>> wordPostings;
+    for (const QueryWord& word : words) {
+        wordPostings.emplace_back();
+        for (const std::uint32_t key : word.trigrams) {
+            wordPostings.back().push_back(Postings(key));
+            keys.push_back(key);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    // Score documents by the trigrams they share with the query, each weighted by how
+    // rare it is, touching only documents that have any.
+    std::vector<float> overlap(documents.size(), 0.0f);
+    std::vector<std::uint32_t> touched;
+    float best = 0;
+    for (const std::uint32_t key : keys) {
+        const auto [first, last] = Postings(key);
+        if (first == last) {
+            continue;
+        }
+        const float weight = static_cast<float>(std::log(1.0 + static_cast<double>(documents.size()) / (last - first)));
+        for (std::uint32_t i = first; i < last; ++i) {
+            const std::uint32_t document = trigramDocuments[i];
+            if (overlap[document] == 0) {
+                touched.push_back(document);
+            }
+            overlap[document] += weight;
+        }
+    }
+    for (const std::uint32_t document : touched) {
+        best = std::max(best, overlap[document]);
+    }
+
+    // Words that appear nowhere, like "where" or "taught", lower every document's overlap
+    // alike, so matches are measured against the best document rather than the query.
+    // Only the closest candidates are checked word by word, which keeps the cost of a
+    // query tied to the result size rather than to how much content there is.
+    std::size_t total = 0;
+    std::vector<std::uint32_t> candidates;
+    for (const std::uint32_t document : touched) {
+        if (overlap[document] * 2 >= best) {
+            candidates.push_back(document);
+        }
+    }
+    total = candidates.size();
+    const std::size_t shortlist = std::max<std::size_t>(contentShortlist, limit * 4);
+    if (candidates.size() > shortlist) {
+        std::nth_element(candidates.begin(), candidates.begin() + shortlist, candidates.end(),
+            [&overlap](std::uint32_t a, std::uint32_t b) { return overlap[a] != overlap[b] ? overlap[a] > overlap[b] : a < b; });
+        candidates.resize(shortlist);
+    }
+
+    std::vector<double> matches;
+    for (const std::uint32_t document : candidates) {
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            matches.push_back(MatchWord(document, words[w], wordPostings[w]));
+        }
+    }
+
+    // Weight each word by how rare it is among the documents, so "is" or "computing"
+    // cannot outvote "cloud".
+    std::vector<double> weights(words.size(), 0.0);
+    for (std::size_t w = 0; w < words.size(); ++w) {
+        std::size_t frequency = 0;
+        for (std::size_t c = 0; c < candidates.size(); ++c) {
+            frequency += matches[c * words.size() + w] > 0;
+        }
+        if (frequency > 0) {
+            weights[w] = std::log(1.0 + static_cast<double>(documents.size()) / frequency);
+        }
+    }
+    double topWeight = 0;
+    for (const double weight : weights) {
+        topWeight = std::max(topWeight, weight);
+    }
+
+    for (std::size_t c = 0; c < candidates.size(); ++c) {
+        double score = 0;
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            score += weights[w] * matches[c * words.size() + w];
+        }
+        if (score > 0 && !parsed.phrase.empty() &&
+            Slice(normalizedText, documents[candidates[c]].normalized).find(parsed.phrase) != std::string_view::npos) {
+            score += topWeight;
+        }
+        if (score > 0 && parsed.hasSection && documents[candidates[c]].section == parsed.section) {
+            score += topWeight / 2;
+        }
+        if (score > 0) {
+            hits.push_back({ candidates[c], score });
+        }
+    }
+
+    const auto better = [this](const ContentHit& a, const ContentHit& b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        if (documents[a.document].text.length != documents[b.document].text.length) {
+            return documents[a.document].text.length < documents[b.document].text.length;
+        }
+        return a.document < b.document;
+    };
+    if (hits.size() > limit) {
+        std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), better);
+        hits.resize(limit);
+    }
+    else {
+        std::sort(hits.begin(), hits.end(), better);
+    }
+    return total;
+}
+
+// Up to `width` characters of the document on one line, starting a little before the
+// longest query word it contains.
+std::string ContentIndex::Snippet(std::uint32_t document, std::string_view query, std::size_t width) const
+{
+    const std::string_view original = Text(document);
+    const std::string_view normalized = Slice(normalizedText, documents[document].normalized);
+    std::size_t anchor = 0;
+    std::size_t anchorLength = 0;
+    for (const QueryWord& word : ParseQuery(query).words) {
+        std::size_t found = normalized.find(word.bare);
+        if (found == std::string_view::npos && word.bare.size() > 3 && word.bare.back() == 's') {
+            found = normalized.find(std::string_view(word.bare).substr(0, word.bare.size() - 1));
+        }
+        if (found != std::string_view::npos && word.bare.size() > anchorLength) {
+            anchor = found - 1;
+            anchorLength = word.bare.size();
+        }
+    }
+
+    std::size_t start = anchor > width / 4 ? anchor - width / 4 : 0;
+    if (original.size() - start < width) {
+        start = original.size() > width ? original.size() - width : 0;
+    }
+    const std::size_t end = std::min(original.size(), start + width);
+
+    std::string snippet = start > 0 ? "..." : "";
+    for (std::size_t i = start; i < end; ++i) {
+        const char c = original[i];
+        if (c == '\n' || c == '\r' || c == '\t') {
+            if (!snippet.empty() && snippet.back() != ' ') {
+                snippet.push_back(' ');
+            }
+        }
+        else {
+            snippet.push_back(c);
+        }
+    }
+    if (end < original.size()) {
+        snippet += "...";
+    }
+    return snippet;
+}
+
+int SearchContent(std::string_view query, std::size_t limit)
+{
+    ContentIndex index;
+    index.AddCatalog();
+    index.Build();
+
+    std::vector<ContentHit> hits;
+    const auto started = std::chrono::steady_clock::now();
+    const std::size_t total = index.Search(query, limit, hits);
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+
+    if (hits.empty()) {
+        std::cout << "Nothing in the catalog matches \"" << query << "\".\n";
+    }
+    else {
+        std::cout << "Top " << hits.size() << " of " << total << " matches for \"" << query << "\":\n";
+        for (const ContentHit& hit : hits) {
+            std::cout << "- " << index.Owner(hit.document) << ", " << ContentSectionName(index.Section(hit.document));
+            if (index.Year(hit.document) > 0) {
+                std::cout << " (Year " << index.Year(hit.document) << ")";
+            }
+            std::cout << ": " << index.Snippet(hit.document, query, 70) << "\n";
+        }
+    }
+    std::cerr << "Searched " << index.Size() << " documents in " << std::fixed << std::setprecision(1)
+        << std::chrono::duration<double, std::micro>(elapsed).count() << " us\n";
+    return 0;
+}
+
+// Searches for every subject of every major and checks the major and year it is listed in
+// are among the hits.
+int CheckContentSearch()
+{
+    ContentIndex index;
+    index.AddCatalog();
+    index.Build();
+
+    std::vector<ContentHit> hits;
+    std::size_t checked = 0;
+    std::size_t missing = 0;
+    for (std::size_t m = 0; m < majorIdCount; ++m) {
+        const std::string_view owner = majorNames[m];
+        for (int y = 0; y < catalogYearCount; ++y) {
+            for (const std::string_view subject : getSubjects(static_cast<MajorId>(m), y + 1)) {
+                index.Search(subject, index.Size(), hits);
+                const bool found = std::any_of(hits.begin(), hits.end(), [&](const ContentHit& hit) {
+                    return index.Section(hit.document) == ContentSection::Subject && index.Owner(hit.document) == owner &&
+                        index.Year(hit.document) == y + 1 && index.Text(hit.document) == subject;
+                });
+                if (!found) {
+                    if (missing == 0) {
+                        std::cout << "\"" << subject << "\" is not found in " << owner << ", Year " << y + 1 << ".\n";
+                    }
+                    missing++;
+                }
+                checked++;
+            }
+        }
+    }
+    std::cout << "Subjects: " << checked << " searched, " << missing << " not found where listed.\n";
+    return missing == 0 ? 0 : 1;
+}
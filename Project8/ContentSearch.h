@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Catalog.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class ContentSection : std::uint8_t
+{
+    DegreeInfo,
+    MajorInfo,
+    Roadmap,
+    Opportunity,
+    Subject
+};
+
+struct ContentHit
+{
+    std::uint32_t document;
+    double score;
+};
+
+// Full-text search over the advising content. Every degree overview, major description,
+// roadmap, opportunity text and subject is a document tagged with its major (or degree),
+// section and year. Text is lower-cased with punctuation turned into spaces, and each
+// document is indexed by the trigrams of that form, padded with a space on both sides so
+// words of one or two letters still have trigrams.
+//
+// A query keeps the documents sharing at least half as many of its trigrams as the best
+// document does, then ranks them by how well each query word matches (whole word, word
+// prefix, anywhere, or only some of its trigrams, which lets a misspelt word still find
+// its target), with rarer words counting for more.
+class ContentIndex
+{
+public:
+    void Add(std::string_view owner, ContentSection section, int year, std::string_view text);
+    void AddCatalog();
+    void Build();
+
+    std::size_t Size() const;
+    std::string_view Owner(std::uint32_t document) const;
+    ContentSection Section(std::uint32_t document) const;
+    int Year(std::uint32_t document) const;
+    std::string_view Text(std::uint32_t document) const;
+    std::string Snippet(std::uint32_t document, std::string_view query, std::size_t width) const;
+
+    // Best `limit` documents first. Returns how many documents matched in total.
+    std::size_t Search(std::string_view query, std::size_t limit, std::vector<ContentHit>& hits) const;
+
+private:
+    struct Document
+    {
+        CatalogStringRef owner;
+        CatalogStringRef text;
+        CatalogStringRef normalized;
+        ContentSection section;
+        std::uint8_t year;
+    };
+
+    // A normalized query word with the patterns it is matched against.
+    struct QueryWord
+    {
+        explicit QueryWord(std::string_view word);
+
+        std::string bare;
+        std::string prefix;
+        std::string whole;
+        std::vector<std::uint32_t> trigrams;  // of `whole`, in order
+    };
+
+    std::string_view Slice(const std::string& arena, const CatalogStringRef& ref) const;
+    // The words to match, with question words dropped and words like "careers" or
+    // "taught" turned into a preference for a section.
+    struct ParsedQuery
+    {
+        std::vector<QueryWord> words;
+        std::string phrase;  // " word1 word2 ..." when there is more than one word
+        bool hasSection;
+        ContentSection section;
+    };
+
+    ParsedQuery ParseQuery(std::string_view query) const;
+    std::pair<std::uint32_t, std::uint32_t> Postings(std::uint32_t key) const;
+    double MatchWord(std::uint32_t document, const QueryWord& word,
+        const std::vector<std::pair<std::uint32_t, std::uint32_t>>& postings) const;
+
+    std::vector<Document> documents;
+    std::string text;
+    std::string normalizedText;
+
+    // Trigram postings in compressed-row form: the documents containing trigramKeys[i]
+    // are trigramDocuments[trigramStarts[i] .. trigramStarts[i + 1]).
+    std::vector<std::uint32_t> trigramKeys;
+    std::vector<std::uint32_t> trigramStarts;
+    std::vector<std::uint32_t> trigramDocuments;
+};
+
+std::string_view ContentSectionName(ContentSection section);
+
+// Prints the best matches for `query` across the catalog.
+int SearchContent(std::string_view query, std::size_t limit);
+// Checks every subject is found under the major and year the catalog lists it in.
+int CheckContentSearch();
@@ -0,0 +1,427 @@
+#include "Curriculum.h"
+
+#include "ScholarshipStore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// Subjects the catalog lists that are notes rather than courses.
+const std::string_view curriculumNotes[] = { "major will be choose at third year" };
+
+// Other spellings the catalog uses for a course.
+const std::pair<std::string_view, std::string_view> courseAliases[] = {
+    { "Operating System", "Operating Systems" },
+};
+
+// Course, then a course that must be taken before it.
+const std::pair<std::string_view, std::string_view> builtinPrerequisites[] = {
+    { "Software Project Management", "Software Testing" },
+    { "Advanced Software Engineering", "Software Project Management" },
+    { "Artificial Intelligence", "Data Science and Machine Learning" },
+    { "Data processing technquies in distributed systems", "Cloud Computing" },
+    { "Data processing technquies in distributed systems", "Operating Systems" },
+    { "Software Engineering Management", "Software Development" },
+    { "Advanced Software Design", "Software Development" },
+    { "Software Quality Assurance(QA)", "Software Development" },
+    { "Machine Learning and Artificial Intelligence for business", "Data Science" },
+    { "Blockchain Technology", "Cloud Computing" },
+    { "Knowledge Discovery and Data Mining", "Database Systems for Knowledge Management" },
+    { "Knowledge Management Systems", "Database Systems for Knowledge Management" },
+    { "Decision Support Systems", "Knowledge Representation" },
+    { "Global Knowledge Systems", "Knowledge Management Systems" },
+    { "Advanced Knowledge Engineering Techniques", "Knowledge Representation" },
+    { "Advanced Knowledge Engineering Techniques", "Artificial Intelligence and Machine Learning" },
+    { "Performance Engineering", "Computer Architecture" },
+    { "High-Performance Computing (HPC) Systems", "Parallel Computing" },
+    { "High-Performance Computing (HPC) Systems", "Computer Architecture" },
+    { "Distributed Systems", "Operating Systems" },
+    { "Distributed Systems", "Computer Networks" },
+    { "Advanced Parallel Programming", "Parallel Computing" },
+    { "Grid Computing", "Distributed Systems" },
+    { "Cybersecurity in HPC", "High-Performance Computing (HPC) Systems" },
+    { "Advanced Embedded Systems", "Embedded Systems Design" },
+    { "Advanced Embedded Systems", "Embedded Systems Programming" },
+    { "Power Management in Embedded Systems", "Microcontroller and Microprocessor Systems" },
+    { "System-on-Chip (SoC) Design", "Digital Logic Design" },
+    { "Embedded Networking and Communication", "Embedded Systems Programming" },
+    { "Embedded Systems Security", "Advanced Embedded Systems" },
+    { "Advanced Sensor Integration", "Microcontroller and Microprocessor Systems" },
+    { "Industrial Embedded Systems", "Advanced Embedded Systems" },
+    { "Embedded Systems Testing and Debugging", "Embedded Systems Programming" },
+    { "Advanced Networking", "Computer Networks" },
+    { "Advanced Networking", "Network Protocols" },
+    { "Network Security", "Computer Networks" },
+    { "Optical Networks", "Communication Systems" },
+    { "Wireless Networks and Mobile Communications", "Communication Systems" },
+    { "Next-Generation Networking", "Advanced Networking" },
+    { "Cloud Computing and Networking", "Advanced Networking" },
+    { "Network Management and Automation", "Network Protocols" },
+    { "Advanced Wireless Communication Systems", "Wireless Networks and Mobile Communications" },
+    { "Advanced Wireless Communication Systems", "Digital Signal Processing (DSP)" },
+    { "Cyber Forensics", "Cybersecurity Fundamentals" },
+    { "Cloud Security", "Network Security" },
+    { "Application Security", "Secure Software Development" },
+    { "Cybersecurity Policy and Strategy", "Cybersecurity Fundamentals" },
+    { "Advanced Cryptography", "Cybersecurity Fundamentals" },
+    { "Artificial Intelligence in Cybersecurity", "Ethical Hacking and Penetration Testing" },
+};
+
+// `name` without surrounding spaces and under its usual spelling.
+std::string_view CourseKey(std::string_view name)
+{
+    while (!name.empty() && name.front() == ' ') {
+        name.remove_prefix(1);
+    }
+    while (!name.empty() && name.back() == ' ') {
+        name.remove_suffix(1);
+    }
+    for (const auto& alias : courseAliases) {
+        if (alias.first == name) {
+            return alias.second;
+        }
+    }
+    return name;
+}
+
+std::uint32_t Curriculum::AddCourse(std::string_view name)
+{
+    const std::string_view key = CourseKey(name);
+    const auto found = ids.find(key);
+    if (found != ids.end()) {
+        return found->second;
+    }
+    const std::uint32_t course = static_cast<std::uint32_t>(names.size());
+    names.emplace_back(key);
+    ids.emplace(names.back(), course);
+    prerequisites.emplace_back();
+    offered.push_back(0);
+    return course;
+}
+
+void Curriculum::AddOffering(MajorId major, int year, std::string_view course)
+{
+    const std::uint32_t id = AddCourse(course);
+    offered[id] = static_cast<std::uint8_t>(offered[id] == 0 ? year : std::min<int>(offered[id], year));
+    std::vector<std::uint32_t>& courses = listed[Index(major)];
+    if (std::find(courses.begin(), courses.end(), id) == courses.end()) {
+        courses.push_back(id);
+    }
+}
+
+bool Curriculum::AddPrerequisite(std::string_view course, std::string_view prerequisite, std::string& error)
+{
+    std::uint32_t courseId = 0;
+    std::uint32_t prerequisiteId = 0;
+    if (!FindCourse(course, courseId)) {
+        error = "unknown course \"" + std::string(course) + "\"";
+        return false;
+    }
+    if (!FindCourse(prerequisite, prerequisiteId)) {
+        error = "unknown course \"" + std::string(prerequisite) + "\"";
+        return false;
+    }
+    std::vector<std::uint32_t>& direct = prerequisites[courseId];
+    if (std::find(direct.begin(), direct.end(), prerequisiteId) == direct.end()) {
+        direct.push_back(prerequisiteId);
+    }
+    return true;
+}
+
+void Curriculum::AddCatalog()
+{
+    for (std::size_t m = 0; m < majorIdCount; ++m) {
+        const MajorId major = static_cast<MajorId>(m);
+        for (int year = 1; year <= catalogYearCount; ++year) {
+            const CatalogStringList subjects = activeCatalog ?
+                activeCatalog->List(activeCatalog->Major(major).subjects[year - 1]) : majorCatalog[m].subjects[year - 1];
+            for (const std::string_view subject : subjects) {
+                if (std::find(std::begin(curriculumNotes), std::end(curriculumNotes), subject) == std::end(curriculumNotes)) {
+                    AddOffering(major, year, subject);
+                }
+            }
+        }
+    }
+}
+
+void Curriculum::AddBuiltinPrerequisites()
+{
+    std::string error;
+    std::uint32_t id = 0;
+    for (const auto& edge : builtinPrerequisites) {
+        if (FindCourse(edge.first, id) && FindCourse(edge.second, id)) {
+            AddPrerequisite(edge.first, edge.second, error);
+        }
+    }
+}
+
+bool Curriculum::LoadPrerequisites(const std::string& path, std::string& error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::size_t tab = line.find('\t');
+        const std::string course = line.substr(0, tab);
+        while (tab != std::string::npos) {
+            const std::size_t next = line.find('\t', tab + 1);
+            const std::string prerequisite = line.substr(tab + 1, next == std::string::npos ? std::string::npos : next - tab - 1);
+            if (!AddPrerequisite(course, prerequisite, error)) {
+                error = path + ": line " + std::to_string(lineNumber) + ": " + error;
+                return false;
+            }
+            tab = next;
+        }
+    }
+    return true;
+}
+
+bool Curriculum::Build(std::string& error)
+{
+    const std::size_t count = names.size();
+    words = (count + 63) / 64;
+
+    // Prerequisites first: each course once everything it needs is placed.
+    std::vector<std::uint32_t> waiting(count, 0);
+    std::vector<std::vector<std::uint32_t>> unlocks(count);
+    for (std::uint32_t course = 0; course < count; ++course) {
+        waiting[course] = static_cast<std::uint32_t>(prerequisites[course].size());
+        for (const std::uint32_t prerequisite : prerequisites[course]) {
+            unlocks[prerequisite].push_back(course);
+        }
+    }
+    std::vector<std::uint32_t> order;
+    for (std::uint32_t course = 0; course < count; ++course) {
+        if (waiting[course] == 0) {
+            order.push_back(course);
+        }
+    }
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        for (const std::uint32_t next : unlocks[order[i]]) {
+            if (--waiting[next] == 0) {
+                order.push_back(next);
+            }
+        }
+    }
+    if (order.size() != count) {
+        // Every course left waits on another left, so following them must come round to
+        // one already passed, which is on a cycle.
+        std::uint32_t stuck = static_cast<std::uint32_t>(
+            std::find_if(waiting.begin(), waiting.end(), [](std::uint32_t left) { return left > 0; }) - waiting.begin());
+        std::vector<bool> passed(count, false);
+        while (!passed[stuck]) {
+            passed[stuck] = true;
+            stuck = *std::find_if(prerequisites[stuck].begin(), prerequisites[stuck].end(),
+                [&waiting](std::uint32_t prerequisite) { return waiting[prerequisite] > 0; });
+        }
+        error = "prerequisites form a cycle through \"" + names[stuck] + "\"";
+        return false;
+    }
+
+    before.assign(count * words, 0);
+    earliest.assign(count, 0);
+    for (const std::uint32_t course : order) {
+        std::uint64_t* row = before.data() + course * words;
+        int year = std::max<int>(offered[course], 1);
+        for (const std::uint32_t prerequisite : prerequisites[course]) {
+            const std::uint64_t* needed = before.data() + prerequisite * words;
+            for (std::size_t w = 0; w < words; ++w) {
+                row[w] |= needed[w];
+            }
+            row[prerequisite / 64] |= std::uint64_t(1) << (prerequisite % 64);
+            year = std::max(year, earliest[prerequisite] + 1);
+        }
+        earliest[course] = static_cast<std::uint8_t>(std::min(year, 255));
+    }
+
+    majorCourses.assign(majorIdCount * words, 0);
+    for (std::size_t m = 0; m < majorIdCount; ++m) {
+        std::uint64_t* row = majorCourses.data() + m * words;
+        for (const std::uint32_t course : listed[m]) {
+            const std::uint64_t* needed = before.data() + course * words;
+            for (std::size_t w = 0; w < words; ++w) {
+                row[w] |= needed[w];
+            }
+            row[course / 64] |= std::uint64_t(1) << (course % 64);
+        }
+    }
+    return true;
+}
+
+std::size_t Curriculum::CourseCount() const
+{
+    return names.size();
+}
+
+std::string_view Curriculum::CourseName(std::uint32_t course) const
+{
+    return names[course];
+}
+
+bool Curriculum::FindCourse(std::string_view name, std::uint32_t& course) const
+{
+    const auto found = ids.find(CourseKey(name));
+    if (found == ids.end()) {
+        return false;
+    }
+    course = found->second;
+    return true;
+}
+
+std::size_t Curriculum::Words() const
+{
+    return words;
+}
+
+const std::vector<std::uint32_t>& Curriculum::Prerequisites(std::uint32_t course) const
+{
+    return prerequisites[course];
+}
+
+const std::uint64_t* Curriculum::Before(std::uint32_t course) const
+{
+    return before.data() + course * words;
+}
+
+const std::uint64_t* Curriculum::MajorCourses(MajorId major) const
+{
+    return majorCourses.data() + Index(major) * words;
+}
+
+void Curriculum::Common(MajorId first, MajorId second, std::uint64_t* courses) const
+{
+    const std::uint64_t* a = MajorCourses(first);
+    const std::uint64_t* b = MajorCourses(second);
+    for (std::size_t w = 0; w < words; ++w) {
+        courses[w] = a[w] & b[w];
+    }
+}
+
+int Curriculum::OfferedYear(std::uint32_t course) const
+{
+    return offered[course];
+}
+
+int Curriculum::EarliestYear(std::uint32_t course) const
+{
+    return earliest[course];
+}
+
+void Curriculum::Courses(const std::uint64_t* courses, std::vector<std::uint32_t>& courseIds) const
+{
+    courseIds.clear();
+    for (std::size_t w = 0; w < words; ++w) {
+        for (std::uint64_t bits = courses[w]; bits != 0; bits &= bits - 1) {
+            courseIds.push_back(static_cast<std::uint32_t>(w * 64 + LowestBit(bits)));
+        }
+    }
+}
+
+// "Name (year N)", or without the year for a course no major lists.
+void PrintCourse(const Curriculum& curriculum, std::uint32_t course)
+{
+    std::cout << "- " << curriculum.CourseName(course);
+    if (curriculum.OfferedYear(course) > 0) {
+        std::cout << " (Year " << curriculum.OfferedYear(course) << ")";
+    }
+    std::cout << "\n";
+}
+
+int RunCurriculumQuery(const std::string& prerequisitesPath, const std::vector<std::string>& query)
+{
+    Curriculum curriculum;
+    std::string error;
+    const auto buildStarted = std::chrono::steady_clock::now();
+    curriculum.AddCatalog();
+    if (prerequisitesPath.empty()) {
+        curriculum.AddBuiltinPrerequisites();
+    }
+    else if (!curriculum.LoadPrerequisites(prerequisitesPath, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    if (!curriculum.Build(error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    const auto built = std::chrono::steady_clock::now();
+
+    const std::string kind = query.empty() ? "courses" : query[0];
+    std::uint32_t course = 0;
+    std::vector<std::uint32_t> ids;
+    if (kind == "courses" && query.size() <= 1) {
+        std::cout << curriculum.CourseCount() << " courses:\n";
+        for (std::uint32_t c = 0; c < curriculum.CourseCount(); ++c) {
+            std::cout << "- " << curriculum.CourseName(c) << ": listed in year " << curriculum.OfferedYear(c)
+                << ", earliest year " << curriculum.EarliestYear(c) << ", " << curriculum.Prerequisites(c).size()
+                << " direct prerequisites\n";
+        }
+    }
+    else if ((kind == "before" || kind == "earliest") && query.size() == 2) {
+        if (!curriculum.FindCourse(query[1], course)) {
+            std::cerr << "No major lists a course called \"" << query[1] << "\"\n";
+            return 1;
+        }
+        const auto started = std::chrono::steady_clock::now();
+        if (kind == "before") {
+            curriculum.Courses(curriculum.Before(course), ids);
+        }
+        const int year = curriculum.EarliestYear(course);
+        const auto elapsed = std::chrono::steady_clock::now() - started;
+        if (kind == "before") {
+            std::cout << ids.size() << " courses come before " << curriculum.CourseName(course) << ":\n";
+            for (const std::uint32_t id : ids) {
+                PrintCourse(curriculum, id);
+            }
+        }
+        else {
+            std::cout << curriculum.CourseName(course) << " can be taken in year " << year << " at the earliest";
+            if (curriculum.OfferedYear(course) > 0 && curriculum.OfferedYear(course) < year) {
+                std::cout << ", though a major lists it in year " << curriculum.OfferedYear(course);
+            }
+            std::cout << ".\n";
+        }
+        std::cerr << "Answered in " << std::fixed << std::setprecision(2)
+            << std::chrono::duration<double, std::micro>(elapsed).count() << " us\n";
+    }
+    else if (kind == "common" && query.size() == 3) {
+        MajorId first = MajorId::SoftwareEngineering;
+        MajorId second = MajorId::SoftwareEngineering;
+        if (!FindMajorId(query[1], first) || !FindMajorId(query[2], second)) {
+            std::cerr << "Unknown major \"" << query[FindMajorId(query[1], first) ? 2 : 1] << "\"\n";
+            return 1;
+        }
+        std::vector<std::uint64_t> courses(curriculum.Words());
+        const auto started = std::chrono::steady_clock::now();
+        curriculum.Common(first, second, courses.data());
+        curriculum.Courses(courses.data(), ids);
+        const auto elapsed = std::chrono::steady_clock::now() - started;
+        std::cout << ids.size() << " courses are taken in both " << Name(first) << " and " << Name(second)
+            << ", listed or as prerequisites:\n";
+        for (const std::uint32_t id : ids) {
+            PrintCourse(curriculum, id);
+        }
+        std::cerr << "Answered in " << std::fixed << std::setprecision(2)
+            << std::chrono::duration<double, std::micro>(elapsed).count() << " us\n";
+    }
+    else {
+        std::cerr << "Expected courses, before COURSE, earliest COURSE or common MAJOR MAJOR\n";
+        return 1;
+    }
+    std::cerr << "Built " << curriculum.CourseCount() << " courses in " << std::fixed << std::setprecision(1)
+        << std::chrono::duration<double, std::micro>(built - buildStarted).count() << " us\n";
+    return 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Catalog.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The courses of every major as one prerequisite graph. A course is a node shared by every
+// major that lists it, named once however many majors and years list it; majors and
+// prerequisites are edges onto those nodes.
+//
+// Build works out, in prerequisite order, every course's transitive prerequisites and
+// every major's courses with theirs, each as a bitset over course ids, and the earliest
+// year each course can be taken. Queries are then a row lookup, or an AND of two rows,
+// and cost a few words per 64 courses.
+class Curriculum
+{
+public:
+    // Names are trimmed and older spellings resolved, so the same course listed two ways is
+    // one node. Returns its id.
+    std::uint32_t AddCourse(std::string_view name);
+    void AddOffering(MajorId major, int year, std::string_view course);
+    // Both courses must have been added.
+    bool AddPrerequisite(std::string_view course, std::string_view prerequisite, std::string& error);
+    // Every major's subjects from the catalog in use, less the notes standing in for the
+    // years before a major is chosen.
+    void AddCatalog();
+    // The built-in prerequisites of the catalog's courses, skipping any course not added.
+    void AddBuiltinPrerequisites();
+    // One line per course: its name, then a tab-separated list of its prerequisites; blank
+    // lines and lines starting with '#' are skipped.
+    bool LoadPrerequisites(const std::string& path, std::string& error);
+    // False, naming a course on it, when the prerequisites form a cycle.
+    bool Build(std::string& error);
+
+    std::size_t CourseCount() const;
+    std::string_view CourseName(std::uint32_t course) const;
+    bool FindCourse(std::string_view name, std::uint32_t& course) const;
+    // Words in each bitset below.
+    std::size_t Words() const;
+    const std::vector<std::uint32_t>& Prerequisites(std::uint32_t course) const;
+    // Everything that must be taken before `course`, directly or not.
+    const std::uint64_t* Before(std::uint32_t course) const;
+    // The courses `major` lists and everything they need.
+    const std::uint64_t* MajorCourses(MajorId major) const;
+    // MajorCourses of both majors, into Words() words.
+    void Common(MajorId first, MajorId second, std::uint64_t* courses) const;
+    // The first year any major lists `course` in; 0 when none does.
+    int OfferedYear(std::uint32_t course) const;
+    // The first year `course` can be taken: no earlier than it is offered, and a year after
+    // each of its prerequisites can be. Past catalogYearCount when its prerequisites do not
+    // fit in the years the catalog lists them in.
+    int EarliestYear(std::uint32_t course) const;
+    // Ids of the courses set in `courses`, in order.
+    void Courses(const std::uint64_t* courses, std::vector<std::uint32_t>& courseIds) const;
+
+private:
+    std::vector<std::string> names;
+    std::map<std::string, std::uint32_t, std::less<>> ids;
+    std::vector<std::vector<std::uint32_t>> prerequisites;
+    std::vector<std::uint8_t> offered;
+    std::vector<std::uint32_t> listed[majorIdCount];
+
+    // Built.
+    std::size_t words = 0;
+    std::vector<std::uint64_t> before;        // CourseCount() rows
+    std::vector<std::uint64_t> majorCourses;  // majorIdCount rows
+    std::vector<std::uint8_t> earliest;
+};
+
+// Prints the answer to a curriculum query: "courses", "before COURSE", "common MAJOR MAJOR"
+// or "earliest COURSE". `prerequisitesPath`, when not empty, replaces the built-in
+// prerequisites.
+int RunCurriculumQuery(const std::string& prerequisitesPath, const std::vector<std::string>& query);
@@ -0,0 +1,149 @@
+#include "Display.h"
+
+#include "Catalog.h"
+#include "Instrumentation.h"
+#include "Messages.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+void displayBachelorDegrees(std::ostream& out) {
+    StageTimer timer(Stage::Display);
+    if (activeCatalog) {
+        for (const CatalogDegreeRecord* degree = activeCatalog->DegreesBegin(); degree != activeCatalog->DegreesEnd(); ++degree) {
+            WriteMessage(out, MessageId::BachelorDegreesTitle, { activeCatalog->String(degree->name) });
+            for (const auto& bachelor : activeCatalog->List(degree->bachelors)) {
+                out << "- " << bachelor << "\n";
+            }
+            out << "\n";
+        }
+        return;
+    }
+    for (std::size_t d = 0; d < degreeIdCount; ++d) {
+        WriteMessage(out, MessageId::BachelorDegreesTitle, { degreeNames[d] });
+        for (const auto& bachelor : getBachelorDegrees(static_cast<DegreeId>(d))) {
+            out << "- " << bachelor << "\n";
+        }
+        out << "\n";
+    }
+}
+
+// Function to display clear and concise information about a specific degree
+void DisplayDegreeInfo(DegreeId degree, std::ostream& out) {
+    StageTimer timer(Stage::Display);
+    if (activeCatalog) {
+        const CatalogDegreeRecord* record = activeCatalog->Degree(degree);
+        if (record && record->info.length > 0) {
+            out << activeCatalog->String(record->info);
+        }
+        else {
+            WriteMessage(out, MessageId::DegreeInfoMissing);
+        }
+        return;
+    }
+    if (degree == DegreeId::ComputerScience) {
+        out << "\n--- Computer Science Degree ---\n"
+               "Overview:\n"
+               "Focuses on the study of computers and computational systems. This degree covers programming, algorithms, and software development.\n"
+               "\nCore Topics:\n"
+               "- Programming: Learn various coding languages such as C++, Python, and Java.\n"
+               "- Algorithms and Data Structures: Understand how to efficiently manage and process data.\n"
+               "- Software Engineering: Develop skills in designing and maintaining software applications.\n"
+               "- Operating Systems: Explore how operating systems manage hardware and software resources.\n"
+               "\nCareer Opportunities:\n"
+               "- Software Developer\n"
+               "- Systems Analyst\n"
+               "- Data Scientist\n"
+               "\nTypical Courses:\n"
+               "- Introduction to Programming\n"
+               "- Algorithms and Complexity\n"
+               "- Database Systems\n"
+               "- Computer Networks\n";
+    }
+    else if (degree == DegreeId::ComputerTechnology) {
+        out << "\n--- Computer Technology Degree ---\n"
+               "Overview:\n"
+               "Focuses on practical applications of technology, including hardware, networking, and IT support.\n"
+               "\nCore Topics:\n"
+               "- Computer Hardware: Understand the components and functioning of computer systems.\n"
+               "- Networking: Learn about designing, implementing, and managing networks.\n"
+               "- IT Support: Develop skills to provide technical support and resolve issues.\n"
+               "- Systems Analysis: Analyze and improve IT systems and processes.\n"
+               "\nCareer Opportunities:\n"
+               "- IT Support Specialist\n"
+               "- Network Administrator\n"
+               "- Systems Technician\n"
+               "\nTypical Courses:\n"
+               "- Introduction to Computer Hardware\n"
+               "- Networking Fundamentals\n"
+               "- IT Project Management\n"
+               "- Systems Integration\n";
+    }
+    else {
+        WriteMessage(out, MessageId::DegreeInfoMissing);
+    }
+}
+
+void DisplayMajorInfo(MajorId major, std::ostream& out)
+{
+    StageTimer timer(Stage::Display);
+    const int width = 110;
+    const std::string separator(width, '-');
+    std::ostringstream titleText;
+    WriteMessage(titleText, MessageId::MajorTitle, { Name(major) });
+    const std::string title = titleText.str();
+
+    // Display title
+    out << separator << '\n';
+    out << std::setw((width + title.length()) / 2) << title << '\n';
+    out << separator << "\n\n";
+
+    // Display major info
+    WriteMessage(out, MessageId::MajorDescriptionTitle);
+    out << GetMajorInfo(major) << "\n\n";
+
+
+    out << '\n' << separator << '\n';
+}
+
+void DisplayScholarships(MajorId id, int year, std::ostream& out) {
+    StageTimer timer(Stage::Display);
+    const std::string_view major = Name(id);
+    if (activeCatalog) {
+        const CatalogScholarshipMajorRecord* record = activeCatalog->ScholarshipMajor(id);
+        if (!record) {
+            WriteMessage(out, MessageId::ScholarshipMajorMissing);
+            return;
+        }
+        const CatalogScholarshipRecord* first = activeCatalog->ScholarshipsBegin(*record);
+        const CatalogScholarshipRecord* last = activeCatalog->ScholarshipsEnd(*record);
+        first = std::lower_bound(first, last, year,
+            [](const CatalogScholarshipRecord& scholarship, int key) { return static_cast<int>(scholarship.year) < key; });
+        if (first == last || static_cast<int>(first->year) != year) {
+            WriteMessage(out, MessageId::NoScholarships, { major, year });
+            return;
+        }
+        WriteMessage(out, MessageId::ScholarshipsTitle, { major, year });
+        for (; first != last && static_cast<int>(first->year) == year; ++first) {
+            out << "- " << activeCatalog->String(first->name) << ": " << activeCatalog->String(first->description) << "\n";
+        }
+        return;
+    }
+    const auto& years = scholarshipDatabase[Index(id)];
+    if (!years.empty()) {
+        auto yearIt = years.find(year);
+        if (yearIt != years.end() && !yearIt->second.empty()) {
+            WriteMessage(out, MessageId::ScholarshipsTitle, { major, year });
+            for (const auto& scholarship : yearIt->second) {
+                out << "- " << scholarship.name << ": " << scholarship.description << "\n";
+            }
+        }
+        else {
+            WriteMessage(out, MessageId::NoScholarships, { major, year });
+        }
+    }
+    else {
+        WriteMessage(out, MessageId::ScholarshipMajorMissing);
+    }
+}
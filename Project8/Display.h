@@ -0,0 +1,11 @@
+#pragma once
+
+#include "CatalogIds.h"
+
+#include <iostream>
+#include <string>
+
+void displayBachelorDegrees(std::ostream& out = std::cout);
+void DisplayDegreeInfo(DegreeId degree, std::ostream& out = std::cout);
+void DisplayMajorInfo(MajorId major, std::ostream& out = std::cout);
+void DisplayScholarships(MajorId major, int year, std::ostream& out = std::cout);
@@ -0,0 +1,258 @@
+#include "Instrumentation.h"
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+const std::size_t stageCount = static_cast<std::size_t>(Stage::Count);
+
+const char* StageName(Stage stage)
+{
+    static const char* const names[] = { "session_line", "menu", "questionnaire", "degree_scoring", "major_selection",
+        "major_questions", "major_scoring", "catalog_lookup", "display", "render" };
+    static_assert(sizeof(names) / sizeof(names[0]) == stageCount, "every stage needs a name");
+    return names[static_cast<std::size_t>(stage)];
+}
+
+int FloorLog2(std::uint64_t value)
+{
+    int exponent = 0;
+    for (int shift = 32; shift > 0; shift /= 2) {
+        if (value >> shift) {
+            value >>= shift;
+            exponent += shift;
+        }
+    }
+    return exponent;
+}
+
+std::size_t HistogramBucket(std::uint64_t value)
+{
+    value = std::min(value, (std::uint64_t(2) << histogramMaxExponent) - 1);
+    if (value < (std::uint64_t(1) << histogramSubBucketBits)) {
+        return static_cast<std::size_t>(value);
+    }
+    const int shift = FloorLog2(value) - histogramSubBucketBits;
+    return (static_cast<std::size_t>(shift) << histogramSubBucketBits) + static_cast<std::size_t>(value >> shift);
+}
+
+std::uint64_t HistogramBucketHigh(std::size_t bucket)
+{
+    const std::size_t subBuckets = std::size_t(1) << histogramSubBucketBits;
+    if (bucket < 2 * subBuckets) {
+        return bucket;
+    }
+    const std::size_t shift = bucket / subBuckets - 1;
+    const std::uint64_t mantissa = bucket % subBuckets + subBuckets;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+struct TraceSpan
+{
+    std::uint64_t start;
+    std::uint64_t end;
+    Stage stage;
+};
+
+// One thread's measurements. As with analytics, only the owning thread writes, so a
+// record is relaxed loads and stores; blocks are cache-line aligned and never freed.
+struct alignas(64) InstrumentationBlock
+{
+    std::atomic<std::uint64_t> buckets[stageCount][histogramBucketCount];
+    std::atomic<std::uint64_t> totals[stageCount];
+    std::atomic<std::uint64_t> maxima[stageCount];
+    // Spans [0, spanCount) are complete; the count is published after the span is written.
+    TraceSpan* spans;
+    std::atomic<std::size_t> spanCount;
+    std::atomic<std::uint64_t> droppedSpans;
+    std::uint32_t thread;
+    InstrumentationBlock* next;
+};
+
+std::atomic<bool> instrumentationEnabled{ false };
+std::atomic<bool> tracingEnabled{ false };
+std::atomic<InstrumentationBlock*> instrumentationBlocks{ nullptr };
+std::atomic<std::uint32_t> instrumentedThreads{ 0 };
+std::uint64_t traceEpoch = 0;
+
+thread_local InstrumentationBlock* localInstrumentation = nullptr;
+
+std::string stageReportPath;
+std::string tracePath;
+volatile std::sig_atomic_t instrumentationReportRequested = 0;
+
+std::uint64_t InstrumentationClock()
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()) | 1;
+}
+
+InstrumentationBlock* LocalInstrumentation()
+{
+    if (!localInstrumentation) {
+        InstrumentationBlock* block = new InstrumentationBlock();
+        block->spans = tracingEnabled.load(std::memory_order_relaxed) ? new TraceSpan[traceSpanCapacity] : nullptr;
+        block->thread = instrumentedThreads.fetch_add(1, std::memory_order_relaxed) + 1;
+        block->next = instrumentationBlocks.load(std::memory_order_relaxed);
+        while (!instrumentationBlocks.compare_exchange_weak(block->next, block, std::memory_order_release,
+            std::memory_order_relaxed)) {
+        }
+        localInstrumentation = block;
+    }
+    return localInstrumentation;
+}
+
+void AddTo(std::atomic<std::uint64_t>& counter, std::uint64_t amount)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void RecordStage(Stage stage, std::uint64_t start, std::uint64_t end)
+{
+    InstrumentationBlock* block = LocalInstrumentation();
+    const std::size_t s = static_cast<std::size_t>(stage);
+    const std::uint64_t duration = end > start ? end - start : 0;
+    AddTo(block->buckets[s][HistogramBucket(duration)], 1);
+    AddTo(block->totals[s], duration);
+    if (duration > block->maxima[s].load(std::memory_order_relaxed)) {
+        block->maxima[s].store(duration, std::memory_order_relaxed);
+    }
+    if (block->spans) {
+        const std::size_t count = block->spanCount.load(std::memory_order_relaxed);
+        if (count < traceSpanCapacity) {
+            block->spans[count] = { start, end, stage };
+            block->spanCount.store(count + 1, std::memory_order_release);
+        }
+        else {
+            AddTo(block->droppedSpans, 1);
+        }
+    }
+}
+
+void EnableInstrumentation(bool trace)
+{
+    traceEpoch = InstrumentationClock();
+    tracingEnabled.store(trace || tracingEnabled.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    instrumentationEnabled.store(true, std::memory_order_relaxed);
+}
+
+// The p-th percentile of a merged histogram: the top of the bucket holding the sample of
+// that rank, but no more than the largest sample seen.
+std::uint64_t HistogramPercentile(const std::vector<std::uint64_t>& buckets, std::uint64_t count, double p,
+    std::uint64_t maximum)
+{
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(p * static_cast<double>(count) + 0.999999));
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < buckets.size(); ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            return std::min(HistogramBucketHigh(b), maximum);
+        }
+    }
+    return maximum;
+}
+
+void WriteStageReport(std::ostream& out)
+{
+    out << "stage,count,mean_ns,p50_ns,p99_ns,p999_ns,max_ns\n";
+    std::vector<std::uint64_t> buckets(histogramBucketCount);
+    for (std::size_t s = 0; s < stageCount; ++s) {
+        std::fill(buckets.begin(), buckets.end(), 0);
+        std::uint64_t count = 0;
+        std::uint64_t total = 0;
+        std::uint64_t maximum = 0;
+        for (InstrumentationBlock* block = instrumentationBlocks.load(std::memory_order_acquire); block; block = block->next) {
+            for (std::size_t b = 0; b < histogramBucketCount; ++b) {
+                buckets[b] += block->buckets[s][b].load(std::memory_order_relaxed);
+            }
+            total += block->totals[s].load(std::memory_order_relaxed);
+            maximum = std::max(maximum, block->maxima[s].load(std::memory_order_relaxed));
+        }
+        // The buckets are the counts that are sure to be consistent with each other.
+        for (const std::uint64_t n : buckets) {
+            count += n;
+        }
+        if (count == 0) {
+            continue;
+        }
+        out << StageName(static_cast<Stage>(s)) << ',' << count << ',' << total / count << ','
+            << HistogramPercentile(buckets, count, 0.50, maximum) << ','
+            << HistogramPercentile(buckets, count, 0.99, maximum) << ','
+            << HistogramPercentile(buckets, count, 0.999, maximum) << ',' << maximum << '\n';
+    }
+}
+
+void WriteTrace(std::ostream& out)
+{
+    // Chrome wants microseconds; three decimals keep the nanoseconds.
+    auto micros = [&out](std::uint64_t nanoseconds) {
+        out << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+    };
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    std::uint64_t dropped = 0;
+    for (InstrumentationBlock* block = instrumentationBlocks.load(std::memory_order_acquire); block; block = block->next) {
+        out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << block->thread
+            << ",\"args\":{\"name\":\"thread " << block->thread << "\"}}";
+        first = false;
+        const std::size_t count = block->spans ? block->spanCount.load(std::memory_order_acquire) : 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const TraceSpan& span = block->spans[i];
+            out << ",\n{\"name\":\"" << StageName(span.stage) << "\",\"cat\":\"advisor\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << block->thread << ",\"ts\":";
+            micros(span.start > traceEpoch ? span.start - traceEpoch : 0);
+            out << ",\"dur\":";
+            micros(span.end - span.start);
+            out << "}";
+        }
+        dropped += block->droppedSpans.load(std::memory_order_relaxed);
+    }
+    out << "\n],\"otherData\":{\"droppedSpans\":" << dropped << "}}\n";
+}
+
+bool WriteInstrumentationFile(const std::string& path, void (*write)(std::ostream&))
+{
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        write(file);
+        if (!file.flush()) {
+            std::cerr << "Cannot write " << temporary << "\n";
+            return false;
+        }
+    }
+    std::string error;
+    if (!RenameOver(temporary, path, error)) {
+        std::cerr << error << "\n";
+        return false;
+    }
+    return true;
+}
+
+void RequestInstrumentationReport(int)
+{
+    instrumentationReportRequested = 1;
+}
+
+void EnableInstrumentationSignal()
+{
+#ifdef SIGUSR2
+    std::signal(SIGUSR2, RequestInstrumentationReport);
+#endif
+}
+
+void SaveInstrumentation()
+{
+    if (!stageReportPath.empty()) {
+        WriteInstrumentationFile(stageReportPath, WriteStageReport);
+    }
+    if (!tracePath.empty()) {
+        WriteInstrumentationFile(tracePath, WriteTrace);
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Where the time of an advisor session goes. Stages nest: a session line contains the
+// menu or questionnaire step it answers, which may contain scoring, catalog lookups and
+// so on.
+enum class Stage : std::uint8_t
+{
+    SessionLine,     // one line of input handled by an AdvisorSession
+    Menu,            // a menu choice
+    Questionnaire,   // a degree question answered
+    DegreeScoring,
+    MajorSelection,  // GetMajorSelection, including building it the first time
+    MajorQuestions,  // a major question answered
+    MajorScoring,
+    CatalogLookup,   // one of the catalog getters
+    Display,         // one of the Display functions
+    Render,          // a finished screen written out
+    Count
+};
+
+const char* StageName(Stage stage);
+
+// Durations are kept in log-linear buckets, as HDR histograms do: exact below 32 ns, then
+// 32 buckets per power of two, so any recorded value is within about 3% of its bucket.
+const int histogramSubBucketBits = 5;
+const int histogramMaxExponent = 40;  // about 18 minutes in nanoseconds; longer is clamped
+const std::size_t histogramBucketCount =
+    static_cast<std::size_t>(histogramMaxExponent - histogramSubBucketBits + 2) << histogramSubBucketBits;
+
+std::size_t HistogramBucket(std::uint64_t value);
+// The largest value that lands in `bucket`.
+std::uint64_t HistogramBucketHigh(std::size_t bucket);
+
+// The runtime switches. Both are off unless turned on at startup; when off, a StageTimer
+// costs one relaxed load and a branch, and never reads the clock.
+extern std::atomic<bool> instrumentationEnabled;  // per-stage histograms
+extern std::atomic<bool> tracingEnabled;          // every stage as a trace span, too
+
+// Nanoseconds on a steady clock; never zero.
+std::uint64_t InstrumentationClock();
+void RecordStage(Stage stage, std::uint64_t start, std::uint64_t end);
+
+// Times its scope, or up to Stop(), as one run of `stage`.
+class StageTimer
+{
+public:
+    explicit StageTimer(Stage stage)
+        : stage(stage), start(instrumentationEnabled.load(std::memory_order_relaxed) ? InstrumentationClock() : 0)
+    {
+    }
+    ~StageTimer() { Stop(); }
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    void Stop()
+    {
+        if (start != 0) {
+            RecordStage(stage, start, InstrumentationClock());
+            start = 0;
+        }
+    }
+
+private:
+    Stage stage;
+    std::uint64_t start;
+};
+
+// Turns on histograms, and spans as well when `trace` is set. Spans are kept per thread,
+// up to traceSpanCapacity each; later ones are counted as dropped.
+const std::size_t traceSpanCapacity = 1 << 16;
+void EnableInstrumentation(bool trace);
+
+// One CSV row per stage that ran: count, mean, p50, p99, p99.9 and max in nanoseconds.
+// A percentile is the top of the bucket it falls in, so it never understates.
+void WriteStageReport(std::ostream& out);
+// Every span recorded so far in the Chrome trace-event format, for chrome://tracing or
+// Perfetto.
+void WriteTrace(std::ostream& out);
+
+// Where --profile and --trace send their output; empty means nowhere.
+extern std::string stageReportPath;
+extern std::string tracePath;
+// Set by SIGUSR2 once EnableInstrumentationSignal has run; long-running modes poll it.
+extern volatile std::sig_atomic_t instrumentationReportRequested;
+void EnableInstrumentationSignal();
+// Writes the report and the trace to their paths, if set, reporting failures on std::cerr.
+void SaveInstrumentation();
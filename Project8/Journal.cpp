@@ -0,0 +1,560 @@
+#include "Journal.h"
+
+#include "Analytics.h"
+#include "Catalog.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Checkpoints are the session's bytes as they sit in memory, so a journal is only read
+// back by the build that wrote it; the header records enough to tell.
+static_assert(std::is_trivially_copyable<AdvisorSession>::value, "sessions are checkpointed by copying their bytes");
+
+constexpr char journalMagic[4] = { 'A', 'D', 'V', 'J' };
+const std::uint32_t journalVersion = 2;
+const std::size_t journalHeaderSize = 16;
+
+// A session logs a checkpoint before its next line once this many lines have piled up.
+const std::size_t journalCheckpointLines = 16;
+// The file is rewritten once it is at least this big and four times what is still live.
+const std::uint64_t journalCompactMinimum = 256 * 1024;
+
+// Record layout: CRC-32 of the rest (4 bytes, little-endian), type, session id and
+// payload length as varints, then the payload.
+const char recordBegin = 'B';
+const char recordCheckpoint = 'C';
+const char recordLine = 'L';
+const char recordEnd = 'E';
+
+std::uint32_t Crc32(std::string_view data)
+{
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> result{};
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            result[n] = c;
+        }
+        return result;
+    }();
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (const char c : data) {
+        crc = table[(crc ^ static_cast<unsigned char>(c)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void AppendVarint(std::string& out, std::uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool ReadVarint(std::string_view& in, std::uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && !in.empty(); shift += 7) {
+        const unsigned char byte = static_cast<unsigned char>(in.front());
+        in.remove_prefix(1);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AppendUint32(std::string& out, std::uint32_t value)
+{
+    for (int k = 0; k < 4; ++k) {
+        out.push_back(static_cast<char>((value >> (8 * k)) & 0xFF));
+    }
+}
+
+std::uint32_t ReadUint32(std::string_view in)
+{
+    std::uint32_t value = 0;
+    for (int k = 0; k < 4; ++k) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(in[k])) << (8 * k);
+    }
+    return value;
+}
+
+std::string JournalHeader()
+{
+    std::string header(journalMagic, sizeof(journalMagic));
+    AppendUint32(header, journalVersion);
+    AppendUint32(header, static_cast<std::uint32_t>(sizeof(AdvisorSession)));
+    AppendUint32(header, AdvisorSession::CheckpointLayout());
+    return header;
+}
+
+void AppendRecord(std::string& out, char type, std::uint64_t session, std::string_view payload)
+{
+    const std::size_t start = out.size();
+    AppendUint32(out, 0);
+    out.push_back(type);
+    AppendVarint(out, session);
+    AppendVarint(out, payload.size());
+    out.append(payload);
+    const std::uint32_t crc = Crc32(std::string_view(out).substr(start + 4));
+    for (int k = 0; k < 4; ++k) {
+        out[start + k] = static_cast<char>((crc >> (8 * k)) & 0xFF);
+    }
+}
+
+std::string_view SessionBytes(const AdvisorSession& session)
+{
+    return std::string_view(reinterpret_cast<const char*>(&session), sizeof(session));
+}
+
+int OpenJournalFile(const std::string& path, bool truncate)
+{
+#ifdef _WIN32
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY | (truncate ? _O_TRUNC : 0), 0644);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+#endif
+}
+
+bool SyncJournalFile(int fd)
+{
+#ifdef _WIN32
+    return ::_commit(fd) == 0;
+#else
+    return ::fdatasync(fd) == 0;
+#endif
+}
+
+void CloseJournalFile(int fd)
+{
+#ifdef _WIN32
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+// A rename is only durable once the directory holding it is synced.
+void SyncDirectoryOf(const std::string& path)
+{
+#ifndef _WIN32
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    const int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#endif
+}
+
+SessionJournal::SessionJournal()
+    : fd(-1), failed(false), stopping(false), appended(0), committed(0), fileBytes(0), liveBytes(0),
+      compactAt(journalCompactMinimum), nextSession(1)
+{
+}
+
+SessionJournal::~SessionJournal()
+{
+    Close();
+}
+
+bool SessionJournal::Open(const std::string& path, std::string& error)
+{
+    this->path = path;
+    std::string contents;
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (in) {
+            contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+    }
+
+    const std::string header = JournalHeader();
+    std::size_t good = 0;
+    if (!contents.empty()) {
+        if (contents.size() < journalHeaderSize || contents.compare(0, sizeof(journalMagic), journalMagic, sizeof(journalMagic)) != 0) {
+            error = path + " is not a session journal";
+            return false;
+        }
+        if (contents.compare(0, journalHeaderSize, header) != 0) {
+            error = path + " was written by a different build of the advisor";
+            return false;
+        }
+        // Replay records up to the first one that is cut short or fails its checksum;
+        // that is where the previous run stopped writing.
+        good = journalHeaderSize;
+        std::string_view rest = std::string_view(contents).substr(good);
+        while (rest.size() > 4) {
+            const std::uint32_t crc = ReadUint32(rest);
+            std::string_view body = rest.substr(4);
+            std::uint64_t session = 0;
+            std::uint64_t length = 0;
+            const char type = body.front();
+            body.remove_prefix(1);
+            if (!ReadVarint(body, session) || !ReadVarint(body, length) || length > body.size()) {
+                break;
+            }
+            const std::size_t recordSize = 4 + (rest.size() - 4 - body.size()) + static_cast<std::size_t>(length);
+            if (Crc32(rest.substr(4, recordSize - 4)) != crc) {
+                break;
+            }
+            ApplyRecord(type, session, body.substr(0, static_cast<std::size_t>(length)), recordSize);
+            good += recordSize;
+            rest.remove_prefix(recordSize);
+        }
+    }
+
+    std::error_code resized;
+    if (good > 0 && good < contents.size()) {
+        std::filesystem::resize_file(path, good, resized);
+    }
+    fd = OpenJournalFile(path, good == 0);
+    if (fd < 0 || resized) {
+        error = "cannot open " + path + ": " + (resized ? resized.message() : std::string(std::strerror(errno)));
+        return false;
+    }
+    if (good == 0 && (!WriteAll(fd, header) || !SyncJournalFile(fd))) {
+        error = "cannot write " + path;
+        return false;
+    }
+    fileBytes = good == 0 ? header.size() : good;
+    writer = std::thread([this]() { WriterLoop(); });
+    return true;
+}
+
+void SessionJournal::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWriter.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    if (fd >= 0) {
+        CloseJournalFile(fd);
+        fd = -1;
+    }
+}
+
+// Keeps the in-memory picture of the live sessions, and the size a compacted file would
+// have, in step with the log.
+void SessionJournal::ApplyRecord(char type, std::uint64_t session, std::string_view payload, std::size_t recordSize)
+{
+    if (type == recordBegin) {
+        sessions[session] = JournaledSession();
+        sessions[session].bytes = recordSize;
+        liveBytes += recordSize;
+        nextSession = std::max(nextSession, session + 1);
+        return;
+    }
+    const auto it = sessions.find(session);
+    if (it == sessions.end()) {
+        return;
+    }
+    JournaledSession& state = it->second;
+    if (type == recordCheckpoint && payload.size() == sizeof(AdvisorSession)) {
+        std::memcpy(static_cast<void*>(&state.checkpoint), payload.data(), payload.size());
+        state.hasCheckpoint = true;
+        state.lines.clear();
+        liveBytes -= state.bytes;
+        state.bytes = recordSize;
+        liveBytes += recordSize;
+    }
+    else if (type == recordLine) {
+        state.lines.emplace_back(payload);
+        state.bytes += recordSize;
+        liveBytes += recordSize;
+    }
+    else if (type == recordEnd) {
+        liveBytes -= state.bytes;
+        sessions.erase(it);
+    }
+}
+
+std::uint64_t SessionJournal::Append(char type, std::uint64_t session, std::string_view payload)
+{
+    const std::size_t before = pending.size();
+    AppendRecord(pending, type, session, payload);
+    ApplyRecord(type, session, payload, pending.size() - before);
+    wakeWriter.notify_one();
+    return ++appended;
+}
+
+std::uint64_t SessionJournal::Begin(std::uint64_t& session)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    session = nextSession++;
+    const std::uint64_t sequence = Append(recordBegin, session, std::string_view());
+    sessions[session].claimed = true;
+    return sequence;
+}
+
+// `before` is the session as it was before handling `line`, which is what a checkpoint
+// has to hold for the line to be replayed on top of it.
+std::uint64_t SessionJournal::Line(std::uint64_t session, const AdvisorSession& before, std::string_view line)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = sessions.find(session);
+    if (it != sessions.end() && it->second.lines.size() >= journalCheckpointLines) {
+        Append(recordCheckpoint, session, SessionBytes(before));
+    }
+    return Append(recordLine, session, line);
+}
+
+std::uint64_t SessionJournal::End(std::uint64_t session)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return Append(recordEnd, session, std::string_view());
+}
+
+// Returns false if the journal can no longer be written.
+bool SessionJournal::WaitDurable(std::uint64_t sequence)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    durable.wait(lock, [&]() { return committed >= sequence || failed; });
+    return !failed;
+}
+
+bool SessionJournal::Claim(std::uint64_t& session, JournaledSession& state)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = sessions.end();
+    if (session != 0) {
+        found = sessions.find(session);
+    }
+    else {
+        for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+            if (!it->second.claimed && (found == sessions.end() || it->first > found->first)) {
+                found = it;
+            }
+        }
+    }
+    if (found == sessions.end() || found->second.claimed) {
+        return false;
+    }
+    found->second.claimed = true;
+    session = found->first;
+    state = found->second;
+    return true;
+}
+
+void SessionJournal::Release(std::uint64_t session)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = sessions.find(session);
+    if (it != sessions.end()) {
+        it->second.claimed = false;
+    }
+}
+
+std::size_t SessionJournal::LiveSessions() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return sessions.size();
+}
+
+std::uint64_t SessionJournal::FileBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return fileBytes;
+}
+
+bool SessionJournal::WriteAll(int fd, std::string_view data)
+{
+    while (!data.empty()) {
+#ifdef _WIN32
+        const int written = ::_write(fd, data.data(), static_cast<unsigned int>(std::min<std::size_t>(data.size(), 1 << 30)));
+#else
+        const ssize_t written = ::write(fd, data.data(), data.size());
+#endif
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
+
+// Group commit: everything appended while the previous batch was being synced goes out
+// in the next write and shares its fsync.
+void SessionJournal::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeWriter.wait(lock, [&]() { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return;
+        }
+        if (!failed && fileBytes >= compactAt && fileBytes > 4 * liveBytes) {
+            if (Compact(lock)) {
+                continue;
+            }
+            compactAt = 2 * fileBytes;  // try again once the file has doubled
+        }
+        std::string batch;
+        batch.swap(pending);
+        const std::uint64_t sequence = appended;
+        lock.unlock();
+        const bool written = WriteAll(fd, batch) && SyncJournalFile(fd);
+        lock.lock();
+        failed = failed || !written;
+        fileBytes += batch.size();
+        committed = sequence;
+        durable.notify_all();
+    }
+}
+
+// Writes the live sessions, each as its checkpoint and the lines since, to a new file and
+// renames it over the journal. Records still pending are already part of that picture, so
+// they are dropped. Appends go on while the new file is written and land in it after.
+bool SessionJournal::Compact(std::unique_lock<std::mutex>& lock)
+{
+    std::string image = JournalHeader();
+    for (const auto& [session, state] : sessions) {
+        AppendRecord(image, recordBegin, session, std::string_view());
+        if (state.hasCheckpoint) {
+            AppendRecord(image, recordCheckpoint, session, SessionBytes(state.checkpoint));
+        }
+        for (const std::string& line : state.lines) {
+            AppendRecord(image, recordLine, session, line);
+        }
+    }
+    std::string dropped;
+    dropped.swap(pending);
+    const std::uint64_t sequence = appended;
+    lock.unlock();
+
+    const std::string compactPath = path + ".compact";
+    const int compactFd = OpenJournalFile(compactPath, true);
+    bool ok = compactFd >= 0 && WriteAll(compactFd, image) && SyncJournalFile(compactFd);
+    std::error_code renamed;
+    if (ok) {
+        std::filesystem::rename(compactPath, path, renamed);
+        ok = !renamed;
+    }
+    if (ok) {
+        SyncDirectoryOf(path);
+    }
+
+    lock.lock();
+    if (!ok) {
+        // Keep the old file and write the dropped records to it after all.
+        if (compactFd >= 0) {
+            CloseJournalFile(compactFd);
+        }
+        pending.insert(0, dropped);
+        return false;
+    }
+    CloseJournalFile(fd);
+    fd = compactFd;
+    fileBytes = image.size();
+    compactAt = journalCompactMinimum;
+    committed = std::max(committed, sequence);
+    durable.notify_all();
+    return true;
+}
+
+// Rebuilds a session from its checkpoint and lines. Only the reply to the last line is
+// written to `out`, which ends with the prompt the student was looking at.
+void ResumeSession(const JournaledSession& state, AdvisorSession& session, std::ostream& out)
+{
+    session = state.hasCheckpoint ? state.checkpoint : AdvisorSession();
+    if (state.lines.empty()) {
+        // A checkpoint is written just before its line, so a crash between the two leaves
+        // a session part way through with no lines to replay.
+        if (state.hasCheckpoint) {
+            session.Reprompt(out);
+        }
+        else {
+            session.Start(out);
+        }
+        return;
+    }
+    // The lines were counted when they were first answered.
+    AnalyticsPause pause;
+    std::ostringstream discarded;
+    for (std::size_t i = 0; i + 1 < state.lines.size(); ++i) {
+        session.HandleLine(state.lines[i], discarded);
+        discarded.str(std::string());
+    }
+    session.HandleLine(state.lines.back(), out);
+}
+
+int RunJournaledKiosk(const std::string& path)
+{
+    SessionJournal journal;
+    std::string error;
+    if (!journal.Open(path, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    std::string line;
+    bool input = true;
+    while (input) {
+        ReloadCatalogIfRequested();
+        const std::shared_ptr<const MappedCatalog> catalog = PublishedCatalog();
+        CatalogScope catalogScope(catalog.get());
+        AdvisorSession session;
+        std::uint64_t id = 0;
+        JournaledSession state;
+        std::size_t handled = 0;
+        if (journal.Claim(id, state)) {
+            std::cout << "Welcome back! Continuing where you left off.\n";
+            ResumeSession(state, session, std::cout);
+            handled = state.lines.size();
+        }
+        else {
+            journal.Begin(id);
+            session.Start(std::cout);
+        }
+        std::cout.flush();
+
+        while (!session.IsFinished() && (input = static_cast<bool>(std::getline(std::cin, line)))) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            // The answer is on disk before the student sees what it led to.
+            const std::uint64_t sequence = journal.Line(id, session, line);
+            session.HandleLine(line, std::cout);
+            handled++;
+            if (!journal.WaitDurable(sequence)) {
+                std::cerr << "Cannot write " << path << "\n";
+                return 1;
+            }
+            std::cout.flush();
+        }
+        if (session.IsFinished() || handled == 0) {
+            journal.WaitDurable(journal.End(id));
+        }
+    }
+    return 0;
+}
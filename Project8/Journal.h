@@ -0,0 +1,93 @@
+#pragma once
+
+#include "AdvisorSession.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// What the journal still knows about a session that has not finished: the session as of
+// its last checkpoint, if any, and every line it handled since.
+struct JournaledSession
+{
+    bool hasCheckpoint = false;
+    AdvisorSession checkpoint;
+    std::vector<std::string> lines;
+    bool claimed = false;    // being driven by a terminal or connection right now
+    std::uint64_t bytes = 0;  // journal bytes that describe it
+};
+
+// An append-only binary log of every line each AdvisorSession handles, so a session cut
+// off by a crash or a dropped connection can be rebuilt and continued. Every few lines a
+// session also logs a checkpoint of its whole state, which bounds how much is replayed.
+//
+// Appends only copy the record into a pending buffer. A writer thread writes whatever has
+// piled up in one go and syncs it to disk once, so one fsync covers many appends; callers
+// that must not run ahead of the disk wait for their sequence number with WaitDurable.
+// Once the file is mostly finished sessions, the writer rewrites it with only the live
+// ones and swaps it in, without holding up appends.
+class SessionJournal
+{
+public:
+    SessionJournal();
+    ~SessionJournal();
+    SessionJournal(const SessionJournal&) = delete;
+    SessionJournal& operator=(const SessionJournal&) = delete;
+
+    // Reads back whatever a previous run left, dropping a torn record at the end, and
+    // starts the writer thread.
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+
+    // Each returns the sequence number of the record it appended.
+    std::uint64_t Begin(std::uint64_t& session);
+    std::uint64_t Line(std::uint64_t session, const AdvisorSession& before, std::string_view line);
+    std::uint64_t End(std::uint64_t session);
+    bool WaitDurable(std::uint64_t sequence);
+
+    // Hands an unfinished session to one caller at a time; newest first for session 0.
+    bool Claim(std::uint64_t& session, JournaledSession& state);
+    void Release(std::uint64_t session);
+
+    std::size_t LiveSessions() const;
+    std::uint64_t FileBytes() const;
+
+private:
+    std::uint64_t Append(char type, std::uint64_t session, std::string_view payload);
+    void ApplyRecord(char type, std::uint64_t session, std::string_view payload, std::size_t recordSize);
+    void WriterLoop();
+    bool WriteAll(int fd, std::string_view data);
+    bool Compact(std::unique_lock<std::mutex>& lock);
+
+    std::string path;
+    int fd;
+    bool failed;
+    bool stopping;
+    std::thread writer;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeWriter;
+    std::condition_variable durable;
+    std::string pending;
+    std::uint64_t appended;   // sequence number of the last record appended
+    std::uint64_t committed;  // sequence number of the last record on disk
+    std::uint64_t fileBytes;
+    std::uint64_t liveBytes;  // what a compacted file would hold
+    std::uint64_t compactAt;
+    std::uint64_t nextSession;
+    std::unordered_map<std::uint64_t, JournaledSession> sessions;
+};
+
+// Rebuilds a claimed session and writes the screen the student was last shown.
+void ResumeSession(const JournaledSession& state, AdvisorSession& session, std::ostream& out);
+
+// Runs one advisor session at a time on the terminal, journaled to `path`, first
+// continuing the session a previous run left unfinished.
+int RunJournaledKiosk(const std::string& path);
@@ -0,0 +1,397 @@
+#include "MajorRanking.h"
+
+#include "Training.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+const MajorRanking* activeMajorRanking = nullptr;
+
+std::uint16_t MajorRanking::AddMajor(std::string_view degree, std::string_view name, const std::vector<MajorQuestion>& questions)
+{
+    if (degreeNamesAdded.empty() || degreeNamesAdded.back() != degree) {
+        degreeNamesAdded.emplace_back(degree);
+    }
+    if (questionStarts.empty()) {
+        questionStarts.push_back(0);
+    }
+    majorNames.emplace_back(name);
+    majorDegrees.push_back(static_cast<std::uint16_t>(degreeNamesAdded.size() - 1));
+    for (const MajorQuestion& question : questions) {
+        questionTexts.push_back(question.text);
+        questionWeights.push_back(question.weight);
+    }
+    questionStarts.push_back(static_cast<std::uint32_t>(questionTexts.size()));
+    return static_cast<std::uint16_t>(majorNames.size() - 1);
+}
+
+// Degrees list their majors in MajorId order, so each major is added as its own id.
+void MajorRanking::AddCatalog()
+{
+    for (std::size_t d = 0; d < degreeIdCount; ++d) {
+        const MajorSelectionLogic& logic = GetMajorSelection(static_cast<DegreeId>(d));
+        for (const MajorId major : logic.GetMajors()) {
+            AddMajor(degreeNames[d], Name(major), logic.GetMajorQuestions(major));
+        }
+    }
+}
+
+bool MajorRanking::LoadWeights(const std::string& path, std::string& error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::vector<int> loaded = questionWeights;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        const std::string where = path + ": line " + std::to_string(lineNumber) + ": ";
+        const std::size_t tab = line.find('\t');
+        const std::string name = line.substr(0, tab);
+        const auto found = std::find(majorNames.begin(), majorNames.end(), name);
+        if (found == majorNames.end()) {
+            error = where + "unknown major \"" + name + "\"";
+            return false;
+        }
+        const auto questions = MajorQuestions(static_cast<std::uint16_t>(found - majorNames.begin()));
+        std::istringstream fields(tab == std::string::npos ? std::string() : line.substr(tab + 1));
+        std::vector<int> row;
+        int weight;
+        while (fields >> weight) {
+            row.push_back(weight);
+        }
+        if (!fields.eof() || row.size() != questions.second - questions.first) {
+            error = where + "expected " + std::to_string(questions.second - questions.first) + " integer weights";
+            return false;
+        }
+        std::copy(row.begin(), row.end(), loaded.begin() + questions.first);
+    }
+    questionWeights = std::move(loaded);
+    BuildOutcomes();
+    return true;
+}
+
+void MajorRanking::ScaleWeights(int factor)
+{
+    for (int& weight : questionWeights) {
+        weight *= factor;
+    }
+    BuildOutcomes();
+}
+
+std::size_t MajorRanking::MajorCount() const
+{
+    return majorNames.size();
+}
+
+std::size_t MajorRanking::QuestionCount() const
+{
+    return questionTexts.size();
+}
+
+std::size_t MajorRanking::AnswerWords() const
+{
+    return (questionTexts.size() + 63) / 64;
+}
+
+std::string_view MajorRanking::MajorName(std::uint16_t major) const
+{
+    return majorNames[major];
+}
+
+std::string_view MajorRanking::MajorDegree(std::uint16_t major) const
+{
+    return degreeNamesAdded[majorDegrees[major]];
+}
+
+std::string_view MajorRanking::QuestionText(std::uint32_t question) const
+{
+    return questionTexts[question];
+}
+
+int MajorRanking::QuestionWeight(std::uint32_t question) const
+{
+    return questionWeights[question];
+}
+
+std::pair<std::uint16_t, std::uint16_t> MajorRanking::DegreeMajors(std::string_view degree) const
+{
+    std::size_t first = 0;
+    while (first < majorNames.size() && MajorDegree(static_cast<std::uint16_t>(first)) != degree) {
+        ++first;
+    }
+    std::size_t last = first;
+    while (last < majorNames.size() && MajorDegree(static_cast<std::uint16_t>(last)) == degree) {
+        ++last;
+    }
+    return { static_cast<std::uint16_t>(first), static_cast<std::uint16_t>(last) };
+}
+
+std::pair<std::uint16_t, std::uint16_t> MajorRanking::DegreeMajors(DegreeId degree) const
+{
+    const auto majors = MajorsOf(degree);
+    return { static_cast<std::uint16_t>(Index(majors.first)), static_cast<std::uint16_t>(Index(majors.second)) };
+}
+
+std::pair<std::uint32_t, std::uint32_t> MajorRanking::MajorQuestions(std::uint16_t major) const
+{
+    return { questionStarts[major], questionStarts[major + 1] };
+}
+
+// Each major sums the weights of its own questions, masked by the answer bits, so there
+// is no branch on the answers and no scattering into the score array.
+void MajorRanking::Score(const std::uint64_t* answers, int* scores) const
+{
+    for (std::size_t major = 0; major < majorNames.size(); ++major) {
+        int total = 0;
+        for (std::uint32_t q = questionStarts[major]; q < questionStarts[major + 1]; ++q) {
+            const int select = -static_cast<int>((answers[q / 64] >> (q % 64)) & 1);
+            total += questionWeights[q] & select;
+        }
+        scores[major] = total;
+    }
+}
+
+// Keeps the best `limit` majors in `out` by insertion; a later major only moves ahead of
+// a strictly lower score, so ties stay in the order the majors were added.
+std::size_t RankInto(const int* scores, std::uint16_t first, std::uint16_t last, std::size_t limit, RankedMajor* out)
+{
+    std::size_t count = 0;
+    for (std::uint16_t major = first; major < last; ++major) {
+        const int score = scores[major];
+        std::size_t position = count;
+        while (position > 0 && out[position - 1].score < score) {
+            --position;
+        }
+        if (position >= limit) {
+            continue;
+        }
+        const std::size_t end = std::min(count, limit - 1);
+        std::copy_backward(out + position, out + end, out + end + 1);
+        out[position] = { major, score, 0 };
+        count = std::min(count + 1, limit);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i].rank = i > 0 && out[i].score == out[i - 1].score ? out[i - 1].rank : static_cast<std::uint16_t>(i + 1);
+    }
+    return count;
+}
+
+void MajorRanking::Rank(const int* scores, std::uint16_t first, std::uint16_t last, std::size_t limit,
+    std::vector<RankedMajor>& ranked) const
+{
+    ranked.resize(std::min<std::size_t>(limit, last > first ? last - first : 0));
+    ranked.resize(RankInto(scores, first, last, ranked.size(), ranked.data()));
+}
+
+void MajorRanking::BuildOutcomes()
+{
+    outcomeStarts.assign(1, 0);
+    outcomes.clear();
+    for (std::size_t first = 0; first < majorNames.size();) {
+        std::size_t last = first;
+        while (last < majorNames.size() && majorDegrees[last] == majorDegrees[first]) {
+            ++last;
+        }
+        const auto majors = std::make_pair(static_cast<std::uint16_t>(first), static_cast<std::uint16_t>(last));
+        const std::uint32_t questionCount = questionStarts[last] - questionStarts[first];
+        if (questionCount <= majorOutcomeQuestionLimit) {
+            for (std::uint64_t answers = 0; answers < (std::uint64_t(1) << questionCount); ++answers) {
+                outcomes.push_back(ScoreOutcome(majors, answers));
+            }
+        }
+        outcomeStarts.push_back(static_cast<std::uint32_t>(outcomes.size()));
+        first = last;
+    }
+}
+
+MajorOutcome MajorRanking::Outcome(std::pair<std::uint16_t, std::uint16_t> majors, std::uint64_t answers) const
+{
+    if (majors.first == majors.second) {
+        return { majors.first, OutcomeFallback::None };
+    }
+    const std::uint16_t degree = majorDegrees[majors.first];
+    const std::uint32_t start = outcomeStarts[degree];
+    const std::uint32_t size = outcomeStarts[degree + 1] - start;
+    if (size == 0) {
+        return ScoreOutcome(majors, answers);
+    }
+    return outcomes[start + (answers & (size - 1))];
+}
+
+// The major questions as main() always scored them: every major's total and the best one.
+// The fallbacks go by the answers, not the totals, so they hold whatever the weights:
+// every question answered "no", or every one answered "yes".
+MajorOutcome MajorRanking::ScoreOutcome(std::pair<std::uint16_t, std::uint16_t> majors, std::uint64_t answers) const
+{
+    if (majors.first == majors.second) {
+        return { majors.first, OutcomeFallback::None };
+    }
+    const std::uint32_t firstQuestion = questionStarts[majors.first];
+    const std::uint32_t questionCount = questionStarts[majors.second] - firstQuestion;
+    std::vector<std::uint64_t> words(AnswerWords(), 0);
+    for (std::uint32_t q = 0; q < questionCount && q < 64; ++q) {
+        const std::uint32_t id = firstQuestion + q;
+        words[id / 64] |= ((answers >> q) & 1) << (id % 64);
+    }
+    std::vector<int> scores(MajorCount());
+    Score(words.data(), scores.data());
+    RankedMajor best;
+    RankInto(scores.data(), majors.first, majors.second, 1, &best);
+
+    const std::uint64_t asked = questionCount >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << questionCount) - 1;
+    const bool allNo = (answers & asked) == 0;
+    const bool allYes = questionCount > 0 && (answers & asked) == asked;
+    return { best.major, allNo ? OutcomeFallback::AllNo : allYes ? OutcomeFallback::AllYes : OutcomeFallback::None };
+}
+
+const MajorRanking& GetMajorRanking()
+{
+    static const MajorRanking builtin = [] {
+        MajorRanking result;
+        result.AddCatalog();
+        result.BuildOutcomes();
+        return result;
+    }();
+    return activeMajorRanking ? *activeMajorRanking : builtin;
+}
+
+void RankMajorsBatch(const MajorRanking& ranking, const std::uint64_t* answers, std::size_t count,
+    std::size_t limit, MajorRankBatch& results)
+{
+    const std::size_t majorCount = ranking.MajorCount();
+    const std::size_t words = ranking.AnswerWords();
+    limit = std::min(limit, majorCount);
+    results.limit = limit;
+    if (results.scores.size() < count * majorCount) {
+        results.scores.resize(count * majorCount);
+    }
+    if (results.ranked.size() < count * limit) {
+        results.ranked.resize(count * limit);
+    }
+    for (std::size_t n = 0; n < count; ++n) {
+        int* scores = results.scores.data() + n * majorCount;
+        ranking.Score(answers + n * words, scores);
+        RankInto(scores, 0, static_cast<std::uint16_t>(majorCount), limit, results.ranked.data() + n * limit);
+    }
+}
+
+int RankMajors(std::string_view answers, std::size_t limit)
+{
+    const MajorRanking& ranking = GetMajorRanking();
+    if (answers.size() != ranking.QuestionCount() || answers.find_first_not_of("yn") != std::string_view::npos) {
+        std::cerr << "Expected " << ranking.QuestionCount() << " answers, each y or n, one per question:\n";
+        for (std::uint32_t q = 0; q < ranking.QuestionCount(); ++q) {
+            std::cerr << q + 1 << ". " << ranking.QuestionText(q) << "\n";
+        }
+        return 1;
+    }
+
+    std::vector<std::uint64_t> bits(ranking.AnswerWords(), 0);
+    for (std::size_t q = 0; q < answers.size(); ++q) {
+        bits[q / 64] |= static_cast<std::uint64_t>(answers[q] == 'y') << (q % 64);
+    }
+    std::vector<int> scores(ranking.MajorCount());
+    ranking.Score(bits.data(), scores.data());
+    std::vector<RankedMajor> ranked;
+    ranking.Rank(scores.data(), 0, static_cast<std::uint16_t>(ranking.MajorCount()), limit, ranked);
+
+    for (std::size_t i = 0; i < ranked.size(); ++i) {
+        const bool tied = (i > 0 && ranked[i - 1].rank == ranked[i].rank) ||
+            (i + 1 < ranked.size() && ranked[i + 1].rank == ranked[i].rank);
+        std::cout << ranked[i].rank << ". " << ranking.MajorName(ranked[i].major)
+                  << " (" << ranking.MajorDegree(ranked[i].major) << "): " << ranked[i].score
+                  << (tied ? " (tied)" : "") << "\n";
+    }
+    return 0;
+}
+
+bool SamePercentage(double a, double b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+int CheckOutcomeTables()
+{
+    const DegreeWeights& weights = ActiveDegreeWeights();
+    std::vector<double> percentages(weights.DegreeCount());
+    std::size_t degreeMismatches = 0;
+    for (std::size_t mask = 0; mask < degreeAnswerCount; ++mask) {
+        const AnswerMask answers = static_cast<AnswerMask>(mask);
+        const DegreeOutcome live = ScoreDegreeOutcome(answers, weights, percentages.data());
+        const DegreeOutcome& table = weights.Outcome(answers);
+        bool same = live.recommended == table.recommended && live.fallback == table.fallback;
+        for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+            same = same && SamePercentage(percentages[d], weights.Percentages(answers)[d]);
+        }
+        if (!same) {
+            if (degreeMismatches == 0) {
+                std::cout << "Degree answers " << mask << " differ from live scoring.\n";
+            }
+            degreeMismatches++;
+        }
+    }
+    std::cout << "Degree outcomes: " << degreeAnswerCount << " answer sets checked, " << degreeMismatches << " differ.\n";
+
+    const MajorRanking& ranking = GetMajorRanking();
+    std::size_t majorChecked = 0;
+    std::size_t majorMismatches = 0;
+    for (std::uint16_t first = 0; first < ranking.MajorCount();) {
+        const auto majors = ranking.DegreeMajors(ranking.MajorDegree(first));
+        const std::uint32_t questionCount = ranking.MajorQuestions(majors.second - 1).second - ranking.MajorQuestions(first).first;
+        if (questionCount <= majorOutcomeQuestionLimit) {
+            for (std::uint64_t answers = 0; answers < (std::uint64_t(1) << questionCount); ++answers) {
+                const MajorOutcome live = ranking.ScoreOutcome(majors, answers);
+                const MajorOutcome table = ranking.Outcome(majors, answers);
+                if (live.major != table.major || live.fallback != table.fallback) {
+                    if (majorMismatches == 0) {
+                        std::cout << ranking.MajorDegree(first) << " answers " << answers << " differ from live scoring.\n";
+                    }
+                    majorMismatches++;
+                }
+                majorChecked++;
+            }
+        }
+        first = majors.second;
+    }
+    std::cout << "Major outcomes: " << majorChecked << " answer sets checked, " << majorMismatches << " differ.\n";
+
+    // Trained weights are scaled up from small integers, which must leave every outcome,
+    // fallbacks included, as it was.
+    MajorRanking trained = ranking;
+    trained.ScaleWeights(trainedWeightScale);
+    std::size_t trainedChecked = 0;
+    std::size_t trainedMismatches = 0;
+    for (std::uint16_t first = 0; first < ranking.MajorCount();) {
+        const auto majors = ranking.DegreeMajors(ranking.MajorDegree(first));
+        const std::uint32_t questionCount = ranking.MajorQuestions(majors.second - 1).second - ranking.MajorQuestions(first).first;
+        if (questionCount <= majorOutcomeQuestionLimit) {
+            for (std::uint64_t answers = 0; answers < (std::uint64_t(1) << questionCount); ++answers) {
+                const MajorOutcome expected = ranking.Outcome(majors, answers);
+                const MajorOutcome scaled = trained.Outcome(majors, answers);
+                if (expected.major != scaled.major || expected.fallback != scaled.fallback) {
+                    if (trainedMismatches == 0) {
+                        std::cout << ranking.MajorDegree(first) << " answers " << answers << " differ with trained weights.\n";
+                    }
+                    trainedMismatches++;
+                }
+                trainedChecked++;
+            }
+        }
+        first = majors.second;
+    }
+    std::cout << "Major outcomes with trained weights: " << trainedChecked << " answer sets checked, " << trainedMismatches << " differ.\n";
+    return degreeMismatches + majorMismatches + trainedMismatches == 0 ? 0 : 1;
+}
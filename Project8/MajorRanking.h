@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Advisor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct RankedMajor
+{
+    std::uint16_t major;
+    int score;
+    std::uint16_t rank;  // 1 for the best score; majors with equal scores share a rank
+};
+
+// What the advisor does with a degree's finished major questions.
+struct MajorOutcome
+{
+    std::uint16_t major;  // the degree's best major; ties go to the one added first
+    OutcomeFallback fallback;
+};
+
+// Degrees with at most this many major questions get an outcome table.
+const std::uint32_t majorOutcomeQuestionLimit = 16;
+
+// Every major of every degree with its own weighted questions, all numbered in one
+// sequence. A degree's majors are contiguous and so are each major's questions, so a
+// student's answers are one bitset over question ids (bit q of word q / 64 is the answer
+// to question q) and scores land in an int array indexed by major.
+class MajorRanking
+{
+public:
+    // A degree's majors must be added one after another.
+    std::uint16_t AddMajor(std::string_view degree, std::string_view name, const std::vector<MajorQuestion>& questions);
+    void AddCatalog();
+    // Replaces the question weights of the majors listed in a weight file and rebuilds the
+    // outcome tables. Each line is a major's name, then a tab-separated weight per question
+    // in the order they are asked; blank lines and lines starting with '#' are skipped, and
+    // majors left out keep their weights.
+    bool LoadWeights(const std::string& path, std::string& error);
+    // Multiplies every question weight by `factor`, as the weight trainer's scaling does, and
+    // rebuilds the outcome tables.
+    void ScaleWeights(int factor);
+
+    std::size_t MajorCount() const;
+    std::size_t QuestionCount() const;
+    std::size_t AnswerWords() const;
+    std::string_view MajorName(std::uint16_t major) const;
+    std::string_view MajorDegree(std::uint16_t major) const;
+    std::string_view QuestionText(std::uint32_t question) const;
+    int QuestionWeight(std::uint32_t question) const;
+    // Majors of `degree` are [first, second); empty for an unknown degree.
+    std::pair<std::uint16_t, std::uint16_t> DegreeMajors(std::string_view degree) const;
+    // After AddCatalog alone a major's id is its MajorId, so this is MajorsOf(degree).
+    std::pair<std::uint16_t, std::uint16_t> DegreeMajors(DegreeId degree) const;
+    // Questions of `major` are [first, second), in the order they are asked.
+    std::pair<std::uint32_t, std::uint32_t> MajorQuestions(std::uint16_t major) const;
+
+    // Fills MajorCount() scores from AnswerWords() words of answers.
+    void Score(const std::uint64_t* answers, int* scores) const;
+    // The best `limit` majors of [first, last), highest score first. Equal scores keep the
+    // order the majors were added in and share a rank.
+    void Rank(const int* scores, std::uint16_t first, std::uint16_t last, std::size_t limit,
+        std::vector<RankedMajor>& ranked) const;
+
+    // Works out the outcome of every combination of answers to each degree's questions,
+    // so Outcome is a single indexed load. Call once every major has been added.
+    void BuildOutcomes();
+    // `answers` has bit q set for a "yes" to the q-th question of the degree whose majors
+    // are [first, second). Degrees without a table are scored on the spot.
+    MajorOutcome Outcome(std::pair<std::uint16_t, std::uint16_t> majors, std::uint64_t answers) const;
+    // Always scores on the spot; the tables are built from, and checked against, this.
+    MajorOutcome ScoreOutcome(std::pair<std::uint16_t, std::uint16_t> majors, std::uint64_t answers) const;
+
+private:
+    std::vector<std::string> majorNames;
+    std::vector<std::uint16_t> majorDegrees;  // index into degreeNamesAdded
+    std::vector<std::string> degreeNamesAdded;
+    std::vector<std::uint32_t> questionStarts;  // MajorCount() + 1 entries
+    std::vector<std::string> questionTexts;
+    std::vector<int> questionWeights;
+    // The outcomes of degree degreeNamesAdded[i] are outcomes[outcomeStarts[i] ..
+    // outcomeStarts[i + 1]), indexed by answers; an empty range means no table.
+    std::vector<std::uint32_t> outcomeStarts;
+    std::vector<MajorOutcome> outcomes;
+};
+
+// The majors and questions of every built-in degree, shared by all sessions, with the
+// weights loaded at startup or the built-in ones.
+extern const MajorRanking* activeMajorRanking;
+const MajorRanking& GetMajorRanking();
+
+// Ranks of a whole cohort at once: student n's answers are words [n * AnswerWords(), ...),
+// its scores are MajorCount() entries from n * MajorCount(), and its best `limit` majors
+// across every degree are `limit` entries from n * limit. Output vectors are only grown.
+struct MajorRankBatch
+{
+    std::size_t limit = 0;
+    std::vector<int> scores;
+    std::vector<RankedMajor> ranked;
+};
+
+void RankMajorsBatch(const MajorRanking& ranking, const std::uint64_t* answers, std::size_t count,
+    std::size_t limit, MajorRankBatch& results);
+
+// Prints the ranking for ANSWERS, one y or n per major question across every degree.
+int RankMajors(std::string_view answers, std::size_t limit);
+
+// Compares every precomputed degree and major outcome with live scoring, and the major
+// outcomes with those under the same weights scaled as trained ones are, and reports how
+// many differ; nonzero when any do.
+int CheckOutcomeTables();
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// A file mapped read-only into memory. Reading it costs no copies and no allocations; the
+// pages come in as they are touched. An empty file opens as an empty view.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+    const char* Data() const { return data; }
+    std::size_t Size() const { return size; }
+    std::string_view View() const { return std::string_view(data, size); }
+    // Hints that the whole pages within [offset, offset + length) will not be read again,
+    // so they stop counting against the process. Reading them anyway brings them back.
+    void Release(std::size_t offset, std::size_t length) const;
+
+private:
+    const char* data;
+    std::size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+// Renames `temporary` over `path`, replacing any file there in one step, so a reader sees
+// either the old file or the new one. On failure `path` is left as it was.
+bool RenameOver(const std::string& temporary, const std::string& path, std::string& error);
@@ -0,0 +1,388 @@
+#include "Messages.h"
+
+#include "CatalogCompiler.h"
+#include "MajorRanking.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct BuiltinMessageEntry
+{
+    std::string_view key;
+    std::string_view text;  // empty for the questions, which come from the advisor
+};
+
+// Indexed by MessageId.
+const BuiltinMessageEntry builtinMessages[] = {
+    { "main_menu", "Choose an option:\n1. View available bachelor's degrees\n2. Take the degree recommendation questionnaire\n"
+        "3. Learn about Computer Science and Computer Technology degrees\n4. Exit\nEnter your choice (1-4): " },
+    { "invalid_number", "Invalid input. Please enter a number between {0} and {1}: " },
+    { "invalid_answer", "Invalid input. Please enter 'y', 'n', or 'back': " },
+    { "choice_prompt", "Enter your choice (1-{0}): " },
+    { "goodbye", "Thank you for using our program. Goodbye!\n" },
+    { "degree_info_menu", "\nChoose a degree to learn more about:\n1. Computer Science\n2. Computer Technology\nEnter your choice (1-2): " },
+    { "degree_info_title", "\nInformation about {0} degree:\n" },
+    { "degree_info_missing", "\nInformation not available for the specified degree.\n" },
+    { "bachelor_degrees_title", "{0} degrees:\n" },
+    { "degree_question_prompt", "{0} (y/n/back): " },
+    { "degree_results_title", "\nBased on your answers:\n" },
+    { "degree_percentage", "{0}: {1}%\n" },
+    { "degree_all_no", "\nIt seems you answered 'no' to all questions. Let's explore both degrees.\n" },
+    { "degree_all_yes", "\nIt seems you answered 'yes' to all questions. Both degrees might be a good fit for you.\n" },
+    { "degree_fallback_prompt", "Which degree would you like to explore further?\n" },
+    { "recommended_degree", "Recommended degree: {0}\n\nWould you like to explore the recommended degree or choose a different one?\n"
+        "1. Explore {0}\n2. Choose a different degree\nEnter your choice (1-2): " },
+    { "other_degree_prompt", "\nWhich degree would you like to explore?\n" },
+    { "no_majors_listed", "\nNo majors are listed for {0} yet.\nWhich degree would you like to explore?\n" },
+    { "possible_majors_title", "\nPossible majors for {0}:\n" },
+    { "scholarship_menu", "\nDo you want to check available scholarships or proceed to the major-specific questions?\n"
+        "1. Check available scholarships\n2. Proceed to the major-specific questions\nEnter your choice (1-2): " },
+    { "scholarship_major_prompt", "Enter the number of the major to check scholarships: " },
+    { "proceeding_to_majors", "Proceeding to the major-specific questions...\n" },
+    { "scholarship_year_prompt", "Enter the year of study (1-4): " },
+    { "scholarship_major_missing", "\nMajor not found in the scholarship database.\n" },
+    { "no_scholarships", "\nNo scholarships available for {0} (Year {1}).\n" },
+    { "scholarships_title", "\nAvailable scholarships for {0} (Year {1}):\n" },
+    { "major_question_prompt", "\n{0} (y/n/back): " },
+    { "major_all_no", "\nIt seems you answered 'no' to all questions about majors.\nLet's explore all the majors for {0}.\n"
+        "Which major would you like to learn more about?\n" },
+    { "major_all_yes", "\nIt seems you answered 'yes' to all questions about majors.\nAll majors in {0} might be a good fit for you.\n"
+        "Which major would you like to explore further?\n" },
+    { "recommended_major", "\nBased on your answers, we recommend the major: {0}\n" },
+    { "next_step_menu", "\nWhat would you like to do next?\n1. Learn more about {0}\n2. View roadmap and career guide for {0}\n"
+        "3. Go back to major selection\n4. Go back to degree question\n5. Opportunity\n6. View subjects for {0}\n7. Exit\n"
+        "Enter your choice (1-7): " },
+    { "major_info_title", "\nInformation about {0}:\n" },
+    { "major_title", "Major: {0}" },
+    { "major_description_title", "Description:\n" },
+    { "roadmap_title", "\nRoadmap for {0}:\n" },
+    { "career_guide", "\nCareer Guide:\nThis is where you would provide career guide information for {0}.\n" },
+    { "opportunity", "\nBased on your major chosen, The opportunities you can get are: {0}\n" },
+    { "subject_year_menu", "\nChoose a year to view subjects for {0}:\n1. First Year\n2. Second Year\n3. Third Year\n4. Fourth Year\n"
+        "Enter your choice (1-4): " },
+    { "subjects_title", "\nSubjects for {0} (Year {1}):\n" },
+    { "degree_question_1", "" },
+    { "degree_question_2", "" },
+    { "degree_question_3", "" },
+    { "degree_question_4", "" },
+    { "degree_question_5", "" },
+    { "degree_question_6", "" },
+    { "degree_question_7", "" },
+    { "degree_question_8", "" },
+    { "degree_question_9", "" },
+    { "degree_question_10", "" },
+    { "major_question_1", "" },
+    { "major_question_2", "" },
+    { "major_question_3", "" },
+    { "major_question_4", "" },
+    { "major_question_5", "" },
+    { "major_question_6", "" },
+    { "major_question_7", "" },
+    { "major_question_8", "" },
+    { "major_question_9", "" },
+    { "major_question_10", "" },
+    { "major_question_11", "" },
+    { "major_question_12", "" },
+    { "major_question_13", "" },
+    { "major_question_14", "" },
+};
+
+static_assert(sizeof(builtinMessages) / sizeof(builtinMessages[0]) == messageIdCount, "a message has no built-in entry");
+
+std::string messagesPath;
+
+std::string_view MessageKey(MessageId id)
+{
+    return builtinMessages[static_cast<std::size_t>(id)].key;
+}
+
+bool FindMessageId(std::string_view key, MessageId& id)
+{
+    for (std::size_t m = 0; m < messageIdCount; ++m) {
+        if (builtinMessages[m].key == key) {
+            id = static_cast<MessageId>(m);
+            return true;
+        }
+    }
+    return false;
+}
+
+MessageId DegreeQuestionMessage(int question)
+{
+    return static_cast<MessageId>(static_cast<int>(MessageId::DegreeQuestion1) + question);
+}
+
+MessageId MajorQuestionMessage(std::uint32_t question)
+{
+    return question < builtinMajorQuestionCount ?
+        static_cast<MessageId>(static_cast<std::uint32_t>(MessageId::MajorQuestion1) + question) : MessageId::Count;
+}
+
+std::string_view BuiltinMessage(MessageId id)
+{
+    const std::size_t index = static_cast<std::size_t>(id);
+    const std::size_t degreeQuestion = static_cast<std::size_t>(MessageId::DegreeQuestion1);
+    const std::size_t majorQuestion = static_cast<std::size_t>(MessageId::MajorQuestion1);
+    if (index >= majorQuestion) {
+        const MajorRanking& ranking = GetMajorRanking();
+        return index - majorQuestion < ranking.QuestionCount() ?
+            ranking.QuestionText(static_cast<std::uint32_t>(index - majorQuestion)) : std::string_view();
+    }
+    if (index >= degreeQuestion) {
+        return GetDegreeQuestion(static_cast<int>(index - degreeQuestion));
+    }
+    return builtinMessages[index].text;
+}
+
+bool MessageTable::Open(const std::string& path, std::string& error)
+{
+    if (!file.Open(path, error)) {
+        return false;
+    }
+    const char* data = file.Data();
+    const std::size_t size = file.Size();
+    const MessageFileHeader* header = reinterpret_cast<const MessageFileHeader*>(data);
+    auto tableFits = [size](const CatalogTable& table, std::size_t recordSize) {
+        return table.offset % 4 == 0 && table.offset <= size && table.count <= (size - table.offset) / recordSize;
+    };
+    if (size < sizeof(MessageFileHeader) || std::memcmp(header->magic, messageFileMagic, sizeof(messageFileMagic)) != 0) {
+        error = path + " is not a message file";
+        return false;
+    }
+    if (header->version != messageFileVersion) {
+        error = path + " has message version " + std::to_string(header->version) + ", expected " + std::to_string(messageFileVersion);
+        return false;
+    }
+    if (header->fileSize != size || !tableFits(header->messages, sizeof(MessageRecord)) || !tableFits(header->strings, 1)) {
+        error = path + " is truncated or corrupt";
+        return false;
+    }
+    const char* strings = data + header->strings.offset;
+    auto view = [&](const CatalogStringRef& ref, std::string_view& text) {
+        if (ref.offset > header->strings.count || ref.length > header->strings.count - ref.offset) {
+            return false;
+        }
+        text = std::string_view(strings + ref.offset, ref.length);
+        return true;
+    };
+    // Keys this program does not know, from a newer file, are passed over.
+    const MessageRecord* records = reinterpret_cast<const MessageRecord*>(data + header->messages.offset);
+    for (std::uint32_t r = 0; r < header->messages.count; ++r) {
+        std::string_view key;
+        std::string_view text;
+        MessageId id = MessageId::Count;
+        if (!view(records[r].key, key) || !view(records[r].text, text)) {
+            error = path + " is truncated or corrupt";
+            return false;
+        }
+        if (FindMessageId(key, id)) {
+            // A view of an empty string still has to read as present.
+            texts[static_cast<std::size_t>(id)] = text.empty() ? std::string_view("", 0) : text;
+        }
+    }
+    return true;
+}
+
+std::size_t MessageTable::TranslatedCount() const
+{
+    std::size_t count = 0;
+    for (const std::string_view text : texts) {
+        count += text.data() != nullptr;
+    }
+    return count;
+}
+
+const MessageTable* LocaleMessages(const std::string& path, std::string& error)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::unique_ptr<MessageTable>> tables;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = tables.find(path);
+    if (found != tables.end()) {
+        return found->second.get();
+    }
+    std::unique_ptr<MessageTable> table(new MessageTable());
+    if (!table->Open(path, error)) {
+        return nullptr;
+    }
+    return tables.emplace(path, std::move(table)).first->second.get();
+}
+
+// Every message in the locale named by messagesPath, with English for any it lacks. The
+// file is mapped, and this filled in, by whichever thread looks a message up first.
+const std::string_view* ActiveMessageTexts()
+{
+    static const std::vector<std::string_view> texts = []() {
+        const MessageTable* messages = nullptr;
+        if (!messagesPath.empty()) {
+            std::string error;
+            messages = LocaleMessages(messagesPath, error);
+            if (!messages) {
+                std::cerr << error << "; using the built-in English\n";
+            }
+        }
+        std::vector<std::string_view> resolved(messageIdCount);
+        for (std::size_t m = 0; m < messageIdCount; ++m) {
+            const MessageId id = static_cast<MessageId>(m);
+            resolved[m] = messages && messages->Find(id).data() ? messages->Find(id) : BuiltinMessage(id);
+        }
+        return resolved;
+    }();
+    return texts.data();
+}
+
+std::string_view MessageText(MessageId id)
+{
+    return id < MessageId::Count ? ActiveMessageTexts()[static_cast<std::size_t>(id)] : std::string_view();
+}
+
+void MessageArg::Write(std::ostream& out) const
+{
+    if (kind == Kind::Text) {
+        out << text;
+    }
+    else if (kind == Kind::Integer) {
+        out << integer;
+    }
+    else {
+        out << real;
+    }
+}
+
+void WriteMessage(std::ostream& out, MessageId id, std::initializer_list<MessageArg> args)
+{
+    const std::string_view text = MessageText(id);
+    if (args.size() == 0) {
+        out << text;
+        return;
+    }
+    std::size_t written = 0;
+    std::size_t brace = text.find('{');
+    while (brace != std::string_view::npos) {
+        // Only "{N}" with N naming an argument is replaced; any other brace is text.
+        if (brace + 2 < text.size() && text[brace + 2] == '}' && text[brace + 1] >= '0' &&
+            static_cast<std::size_t>(text[brace + 1] - '0') < args.size()) {
+            if (brace > written) {
+                out << text.substr(written, brace - written);
+            }
+            args.begin()[text[brace + 1] - '0'].Write(out);
+            written = brace + 3;
+        }
+        brace = text.find('{', brace + 1);
+    }
+    if (written < text.size()) {
+        out << text.substr(written);
+    }
+}
+
+void WriteBuiltinMessageSource(std::ostream& out)
+{
+    out << "# Advisor message source.\n";
+    out << "# Compile with: Project8 --compile-messages messages.txt messages.bin\n";
+    out << "# Each line is a message key and its text; \\n, \\\\ and \\xHH are the only escapes.\n";
+    out << "# {0}, {1} and so on stand for the message's arguments. A message left out is shown in English.\n";
+    for (std::size_t m = 0; m < messageIdCount; ++m) {
+        out << builtinMessages[m].key << " " << EscapeCatalogValue(BuiltinMessage(static_cast<MessageId>(m))) << "\n";
+    }
+}
+
+// Lays the messages out in the binary format, in key order.
+bool WriteMessageFile(const std::map<std::string, std::string>& messages, const std::string& path, std::string& error)
+{
+    std::string strings;
+    std::vector<MessageRecord> records;
+    auto addString = [&strings](const std::string& text) {
+        const CatalogStringRef ref{ static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(text.size()) };
+        strings += text;
+        return ref;
+    };
+    for (const auto& message : messages) {
+        const CatalogStringRef key = addString(message.first);
+        records.push_back({ key, addString(message.second) });
+    }
+
+    MessageFileHeader header;
+    std::memcpy(header.magic, messageFileMagic, sizeof(messageFileMagic));
+    header.version = messageFileVersion;
+    header.messages = { static_cast<std::uint32_t>(sizeof(MessageFileHeader)), static_cast<std::uint32_t>(records.size()) };
+    const std::uint64_t stringsOffset = sizeof(MessageFileHeader) + records.size() * sizeof(MessageRecord);
+    const std::uint64_t fileSize = stringsOffset + strings.size();
+    if (fileSize > UINT32_MAX) {
+        error = "messages are larger than 4 GiB";
+        return false;
+    }
+    header.strings = { static_cast<std::uint32_t>(stringsOffset), static_cast<std::uint32_t>(strings.size()) };
+    header.fileSize = static_cast<std::uint32_t>(fileSize);
+
+    std::string image(header.fileSize, '\0');
+    std::memcpy(&image[0], &header, sizeof(header));
+    if (!records.empty()) {
+        std::memcpy(&image[header.messages.offset], records.data(), records.size() * sizeof(MessageRecord));
+    }
+    if (!strings.empty()) {
+        std::memcpy(&image[header.strings.offset], strings.data(), strings.size());
+    }
+
+    // Running advisors may have the old file mapped, so it is replaced rather than rewritten.
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(image.data(), static_cast<std::streamsize>(image.size())) || !file.flush()) {
+            error = "cannot write " + temporary;
+            return false;
+        }
+    }
+    return RenameOver(temporary, path, error);
+}
+
+int CompileMessages(const std::string& sourcePath, const std::string& outputPath)
+{
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << sourcePath << "\n";
+        return 1;
+    }
+    std::map<std::string, std::string> messages;
+    std::string line;
+    std::string text;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        const std::size_t space = line.find(' ');
+        const std::string key = line.substr(0, space);
+        const std::string_view value = space == std::string::npos ? std::string_view() : std::string_view(line).substr(space + 1);
+        MessageId id = MessageId::Count;
+        std::string problem;
+        if (!FindMessageId(key, id)) {
+            problem = "unknown message \"" + key + "\"";
+        }
+        else if (!UnescapeCatalogValue(value, text)) {
+            problem = "bad escape sequence";
+        }
+        else if (!messages.emplace(key, text).second) {
+            problem = "message \"" + key + "\" is defined twice";
+        }
+        if (!problem.empty()) {
+            std::cerr << sourcePath << ": line " << lineNumber << ": " << problem << "\n";
+            return 1;
+        }
+    }
+    std::string error;
+    if (!WriteMessageFile(messages, outputPath, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    std::cout << "Compiled " << messages.size() << " of " << messageIdCount << " messages into " << outputPath << "\n";
+    return 0;
+}
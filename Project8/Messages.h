@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Advisor.h"
+#include "Catalog.h"
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Questions of the built-in major ranking.
+const std::uint32_t builtinMajorQuestionCount = 14;
+
+// Every piece of text the advisor itself writes, as opposed to catalog content (degree
+// and major descriptions, roadmaps, subjects, scholarships), which is translated by
+// compiling a catalog in that language. "{0}", "{1}" and so on in a message are replaced
+// by its arguments, so a translation may reorder them.
+enum class MessageId : std::uint16_t
+{
+    MainMenu,
+    InvalidNumber,
+    InvalidAnswer,
+    ChoicePrompt,
+    Goodbye,
+    DegreeInfoMenu,
+    DegreeInfoTitle,
+    DegreeInfoMissing,
+    BachelorDegreesTitle,
+    DegreeQuestionPrompt,
+    DegreeResultsTitle,
+    DegreePercentage,
+    DegreeAllNo,
+    DegreeAllYes,
+    DegreeFallbackPrompt,
+    RecommendedDegree,
+    OtherDegreePrompt,
+    NoMajorsListed,
+    PossibleMajorsTitle,
+    ScholarshipMenu,
+    ScholarshipMajorPrompt,
+    ProceedingToMajors,
+    ScholarshipYearPrompt,
+    ScholarshipMajorMissing,
+    NoScholarships,
+    ScholarshipsTitle,
+    MajorQuestionPrompt,
+    MajorAllNo,
+    MajorAllYes,
+    RecommendedMajor,
+    NextStepMenu,
+    MajorInfoTitle,
+    MajorTitle,
+    MajorDescriptionTitle,
+    RoadmapTitle,
+    CareerGuide,
+    Opportunity,
+    SubjectYearMenu,
+    SubjectsTitle,
+    // The questions themselves; their English is GetDegreeQuestion's and the built-in
+    // MajorRanking's.
+    DegreeQuestion1,
+    MajorQuestion1 = DegreeQuestion1 + degreeQuestionCount,
+    Count = MajorQuestion1 + builtinMajorQuestionCount
+};
+
+const std::size_t messageIdCount = static_cast<std::size_t>(MessageId::Count);
+
+// The name a message goes by in message source and files, such as "main_menu".
+std::string_view MessageKey(MessageId id);
+bool FindMessageId(std::string_view key, MessageId& id);
+MessageId DegreeQuestionMessage(int question);
+// For a question id of GetMajorRanking(); Count past the built-in questions.
+MessageId MajorQuestionMessage(std::uint32_t question);
+std::string_view BuiltinMessage(MessageId id);
+
+// Binary message file, produced by --compile-messages and mapped read-only. It is laid
+// out like a catalog file: a header, then (key, text) records as string refs into one
+// byte blob. Keys are resolved to ids once, on Open, so a file built for another version
+// of the program still lines up; a key it lacks falls back to the built-in English.
+const char messageFileMagic[8] = { 'S', 'M', 'S', 'M', 'S', 'G', 'S', '1' };
+const std::uint32_t messageFileVersion = 1;
+
+struct MessageFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t fileSize;
+    CatalogTable messages;
+    CatalogTable strings;
+};
+
+struct MessageRecord
+{
+    CatalogStringRef key;
+    CatalogStringRef text;
+};
+
+static_assert(sizeof(MessageFileHeader) == 32, "message header layout changed");
+
+// One locale's messages, mapped. Every process that maps the same file shares its pages;
+// what each keeps of its own is one view per message id.
+class MessageTable
+{
+public:
+    MessageTable() = default;
+    MessageTable(const MessageTable&) = delete;
+    MessageTable& operator=(const MessageTable&) = delete;
+
+    bool Open(const std::string& path, std::string& error);
+    // A null view when the file has no such message.
+    std::string_view Find(MessageId id) const { return texts[static_cast<std::size_t>(id)]; }
+    std::size_t TranslatedCount() const;
+
+private:
+    MappedFile file;
+    std::string_view texts[messageIdCount];
+};
+
+// The messages file of a locale, mapped the first time any thread asks for it and kept
+// until exit; locales nobody asks for are never mapped.
+const MessageTable* LocaleMessages(const std::string& path, std::string& error);
+
+// Set by --messages FILE. The file is mapped on the first lookup rather than at startup.
+extern std::string messagesPath;
+
+// The text of `id` in the locale in use, or the built-in English.
+std::string_view MessageText(MessageId id);
+
+// An argument to a message: text or a number. Numbers are written with the stream's
+// formatting, so std::fixed and the like apply.
+class MessageArg
+{
+public:
+    MessageArg(std::string_view text) : kind(Kind::Text), text(text), integer(0), real(0) {}
+    MessageArg(const std::string& text) : MessageArg(std::string_view(text)) {}
+    MessageArg(const char* text) : MessageArg(std::string_view(text)) {}
+    template <typename Integer, typename = std::enable_if_t<std::is_integral<Integer>::value>>
+    MessageArg(Integer value) : kind(Kind::Integer), integer(static_cast<long long>(value)), real(0) {}
+    MessageArg(double value) : kind(Kind::Real), integer(0), real(value) {}
+
+    void Write(std::ostream& out) const;
+
+private:
+    enum class Kind : std::uint8_t
+    {
+        Text,
+        Integer,
+        Real
+    };
+
+    Kind kind;
+    std::string_view text;
+    long long integer;
+    double real;
+};
+
+// Writes the message with each "{N}" replaced by args[N]; copies nothing.
+void WriteMessage(std::ostream& out, MessageId id, std::initializer_list<MessageArg> args = {});
+
+// The built-in English in message source form: one "key text" line per message, with the
+// catalog source escapes. A translation is a copy with the texts replaced.
+void WriteBuiltinMessageSource(std::ostream& out);
+int CompileMessages(const std::string& sourcePath, const std::string& outputPath);
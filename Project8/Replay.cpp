@@ -0,0 +1,184 @@
+#include "Replay.h"
+
+#include "AdvisorSession.h"
+#include "Catalog.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Hashes what is written to it with 64-bit FNV-1a and keeps nothing.
+class DigestBuffer : public std::streambuf
+{
+public:
+    DigestBuffer() : hash(fnvOffset) {}
+
+    // The hash of everything written since the last call, starting afresh.
+    std::uint64_t Take()
+    {
+        const std::uint64_t value = hash;
+        hash = fnvOffset;
+        return value;
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            Add(static_cast<unsigned char>(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override
+    {
+        for (std::streamsize i = 0; i < count; ++i) {
+            Add(static_cast<unsigned char>(data[i]));
+        }
+        return count;
+    }
+
+private:
+    static const std::uint64_t fnvOffset = 14695981039346656037ull;
+    static const std::uint64_t fnvPrime = 1099511628211ull;
+
+    void Add(unsigned char byte)
+    {
+        hash = (hash ^ byte) * fnvPrime;
+    }
+
+    std::uint64_t hash;
+};
+
+struct ReplayTotals
+{
+    std::uint64_t sessions = 0;
+    std::uint64_t finished = 0;
+    std::uint64_t lines = 0;
+    std::uint64_t digest = 0;
+};
+
+// The line starting at `offset`, without its line ending, and where the next one starts.
+std::string_view NextLine(std::string_view text, std::size_t& offset)
+{
+    const std::size_t begin = offset;
+    std::size_t end = text.find('\n', begin);
+    if (end == std::string_view::npos) {
+        end = text.size();
+        offset = end;
+    }
+    else {
+        offset = end + 1;
+    }
+    if (end > begin && text[end - 1] == '\r') {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+// The first place at or after `offset` where a thread may start: just past an empty line,
+// so that no session is split between two threads.
+std::size_t SessionBoundary(std::string_view text, std::size_t offset)
+{
+    if (offset == 0 || offset >= text.size()) {
+        return std::min(offset, text.size());
+    }
+    // Back up to the start of the line `offset` falls in.
+    const std::size_t previous = text.rfind('\n', offset - 1);
+    std::size_t next = previous == std::string_view::npos ? 0 : previous + 1;
+    while (next < text.size()) {
+        if (NextLine(text, next).empty()) {
+            return next;
+        }
+    }
+    return text.size();
+}
+
+// Replays every session in text[begin, end), which starts and ends at session boundaries.
+void ReplaySessions(std::string_view text, std::size_t begin, std::size_t end, ReplayTotals& totals)
+{
+    DigestBuffer digest;
+    std::ostream out(&digest);
+    std::size_t offset = begin;
+    while (offset < end) {
+        std::string_view line = NextLine(text, offset);
+        if (line.empty()) {
+            continue;
+        }
+        AdvisorSession session;
+        session.Start(out);
+        while (true) {
+            session.HandleLine(line, out);
+            totals.lines++;
+            if (offset >= end) {
+                break;
+            }
+            line = NextLine(text, offset);
+            if (line.empty()) {
+                break;
+            }
+        }
+        totals.sessions++;
+        totals.finished += session.IsFinished();
+        totals.digest += digest.Take();
+    }
+}
+
+int ReplayTranscript(const std::string& path, long repeat, int threadCount)
+{
+    MappedFile transcript;
+    std::string error;
+    if (!transcript.Open(path, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    repeat = std::max(1L, repeat);
+    threadCount = std::max(1, threadCount);
+    const std::string_view text = transcript.View();
+
+    std::vector<std::size_t> boundaries;
+    for (int t = 0; t <= threadCount; ++t) {
+        boundaries.push_back(SessionBoundary(text, text.size() * t / threadCount));
+    }
+    std::vector<ReplayTotals> totals(threadCount);
+    const MappedCatalog* catalog = activeCatalog;
+
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            CatalogScope catalogScope(catalog);
+            ReplayTotals local;
+            for (long r = 0; r < repeat; ++r) {
+                ReplaySessions(text, boundaries[t], boundaries[t + 1], local);
+            }
+            totals[t] = local;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    ReplayTotals sum;
+    for (const ReplayTotals& part : totals) {
+        sum.sessions += part.sessions;
+        sum.finished += part.finished;
+        sum.lines += part.lines;
+        sum.digest += part.digest;
+    }
+    std::cout << "sessions=" << sum.sessions << " finished=" << sum.finished << " lines=" << sum.lines
+        << " threads=" << threadCount << std::fixed << std::setprecision(3) << " seconds=" << seconds
+        << " sessions_per_second=" << (seconds > 0 ? sum.sessions / seconds : 0.0)
+        << " digest=" << std::hex << std::setw(16) << std::setfill('0') << sum.digest << std::dec << "\n";
+    return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+// Replays recorded sessions from a transcript file through AdvisorSession, as fast as one
+// or more threads can, and reports sessions per second.
+//
+// A transcript is plain text: each line is one line a student typed, and sessions are
+// separated by one or more empty lines. Lines after a session has finished are ignored.
+// The file is mapped rather than read and lines are handed over as views into it, so
+// tokenizing allocates nothing however big the transcript is.
+//
+// Each thread takes a contiguous run of sessions and replays it `repeat` times. Every
+// screen is hashed instead of kept; the reported digest adds up the hash of each session's
+// output, so it depends only on the transcript and the advisor, not on the thread count,
+// and two builds that answer alike report the same digest.
+int ReplayTranscript(const std::string& path, long repeat, int threadCount);
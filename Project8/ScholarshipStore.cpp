@@ -0,0 +1,447 @@
+#include "ScholarshipStore.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+const std::size_t denseTermMinimum = 256;
+
+// Portable population count; the compiler builtin turns into a library call unless the
+// target is known to have a popcount instruction.
+int CountBits(std::uint64_t bits)
+{
+    bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+    bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+    bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<int>((bits * 0x0101010101010101ull) >> 56);
+}
+
+int LowestBit(std::uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// First position in [first, last) not less than `row`. Probes 1, 2, 4, ... ahead before
+// binary searching, so walking a list in order costs little when matches are close.
+std::vector<std::uint32_t>::const_iterator Gallop(std::vector<std::uint32_t>::const_iterator first,
+    std::vector<std::uint32_t>::const_iterator last, std::uint32_t row)
+{
+    std::ptrdiff_t step = 1;
+    while (last - first > step && first[step] < row) {
+        first += step;
+        step *= 2;
+    }
+    return std::lower_bound(first, std::min(first + step + 1, last), row);
+}
+
+// Calls `callback` with each lower-cased run of ASCII letters and digits in `value`.
+template <typename Callback>
+void ForEachTerm(std::string_view value, std::string& term, Callback callback)
+{
+    term.clear();
+    for (const char c : value) {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        if (byte < 0x80 && std::isalnum(byte)) {
+            term.push_back(static_cast<char>(std::tolower(byte)));
+        }
+        else if (!term.empty()) {
+            callback(term);
+            term.clear();
+        }
+    }
+    if (!term.empty()) {
+        callback(term);
+    }
+}
+
+std::uint32_t ScholarshipStore::Add(std::string_view major, int year, std::string_view name, std::string_view description)
+{
+    const std::uint32_t row = static_cast<std::uint32_t>(majorColumn.size());
+
+    // Major and year bitmaps always have one word per 64 rows.
+    const std::size_t words = row / 64 + 1;
+    if (row % 64 == 0) {
+        for (Bitmap& bitmap : majorBitmaps) {
+            bitmap.resize(words, 0);
+        }
+        for (Bitmap& bitmap : yearBitmaps) {
+            bitmap.resize(words, 0);
+        }
+    }
+    auto majorIt = majorIds.find(major);
+    if (majorIt == majorIds.end()) {
+        majorIt = majorIds.emplace(std::string(major), static_cast<std::uint16_t>(majorNames.size())).first;
+        majorNames.emplace_back(major);
+        majorBitmaps.emplace_back(words, 0);
+    }
+    const std::uint8_t yearValue = static_cast<std::uint8_t>(year);
+    if (yearBitmaps.size() <= yearValue) {
+        yearBitmaps.resize(yearValue + 1, Bitmap(words, 0));
+    }
+
+    majorColumn.push_back(majorIt->second);
+    yearColumn.push_back(yearValue);
+    nameColumn.push_back(AppendText(name));
+    descriptionColumn.push_back(AppendText(description));
+
+    majorBitmaps[majorIt->second][row / 64] |= std::uint64_t(1) << (row % 64);
+    yearBitmaps[yearValue][row / 64] |= std::uint64_t(1) << (row % 64);
+    IndexTerms(name, row);
+    IndexTerms(description, row);
+    return row;
+}
+
+// Adds every scholarship in the active catalog, in the order DisplayScholarships lists them.
+void ScholarshipStore::AddCatalog()
+{
+    for (std::size_t m = 0; m < majorIdCount; ++m) {
+        if (activeCatalog) {
+            const CatalogScholarshipMajorRecord* major = activeCatalog->ScholarshipMajor(static_cast<MajorId>(m));
+            if (!major) {
+                continue;
+            }
+            for (const CatalogScholarshipRecord* scholarship = activeCatalog->ScholarshipsBegin(*major);
+                 scholarship != activeCatalog->ScholarshipsEnd(*major); ++scholarship) {
+                Add(majorNames[m], static_cast<int>(scholarship->year),
+                    activeCatalog->String(scholarship->name), activeCatalog->String(scholarship->description));
+            }
+            continue;
+        }
+        for (const auto& year : scholarshipDatabase[m]) {
+            for (const auto& scholarship : year.second) {
+                Add(majorNames[m], year.first, scholarship.name, scholarship.description);
+            }
+        }
+    }
+}
+
+// Reads one scholarship per line as MAJOR<TAB>YEAR<TAB>NAME<TAB>DESCRIPTION. Blank lines
+// and lines starting with '#' are skipped.
+bool ScholarshipStore::LoadFile(const std::string& path, std::string& error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::string_view fields[4];
+        std::string_view rest = line;
+        std::size_t count = 0;
+        while (count < 3) {
+            const std::size_t tab = rest.find('\t');
+            if (tab == std::string_view::npos) {
+                break;
+            }
+            fields[count++] = rest.substr(0, tab);
+            rest.remove_prefix(tab + 1);
+        }
+        fields[count++] = rest;
+        if (count != 4 || fields[0].empty() || fields[2].empty()) {
+            error = path + ": line " + std::to_string(lineNumber) + ": expected MAJOR, YEAR, NAME and DESCRIPTION separated by tabs";
+            return false;
+        }
+        const int year = std::atoi(std::string(fields[1]).c_str());
+        if (year < 1 || year > 255) {
+            error = path + ": line " + std::to_string(lineNumber) + ": year must be between 1 and 255";
+            return false;
+        }
+        if (majorColumn.size() == UINT32_MAX || (majorIds.find(fields[0]) == majorIds.end() && majorNames.size() == UINT16_MAX)) {
+            error = path + ": too many scholarships or majors";
+            return false;
+        }
+        Add(fields[0], year, fields[2], fields[3]);
+    }
+    return true;
+}
+
+std::size_t ScholarshipStore::Size() const
+{
+    return majorColumn.size();
+}
+
+std::string_view ScholarshipStore::Major(std::uint32_t row) const
+{
+    return majorNames[majorColumn[row]];
+}
+
+int ScholarshipStore::Year(std::uint32_t row) const
+{
+    return yearColumn[row];
+}
+
+std::string_view ScholarshipStore::Name(std::uint32_t row) const
+{
+    return Text(nameColumn[row]);
+}
+
+std::string_view ScholarshipStore::Description(std::uint32_t row) const
+{
+    return Text(descriptionColumn[row]);
+}
+
+CatalogStringRef ScholarshipStore::AppendText(std::string_view value)
+{
+    const CatalogStringRef ref = { static_cast<std::uint32_t>(text.size()), static_cast<std::uint32_t>(value.size()) };
+    text.append(value);
+    return ref;
+}
+
+std::string_view ScholarshipStore::Text(const CatalogStringRef& ref) const
+{
+    return std::string_view(text).substr(ref.offset, ref.length);
+}
+
+// Each word keeps its rows in order. Once a word is on more than 1 in 32 rows, and at
+// least denseTermMinimum of them, it also gets a bitmap that runs up to its last row.
+void ScholarshipStore::IndexTerms(std::string_view value, std::uint32_t row)
+{
+    std::string term;
+    ForEachTerm(value, term, [this, row](const std::string& word) {
+        TermPostings& entry = postings[word];
+        if (!entry.rows.empty() && entry.rows.back() == row) {
+            return;
+        }
+        entry.rows.push_back(row);
+        if (!entry.bitmap.empty()) {
+            entry.bitmap.resize(row / 64 + 1, 0);
+            entry.bitmap[row / 64] |= std::uint64_t(1) << (row % 64);
+        }
+        else if (entry.rows.size() >= denseTermMinimum && entry.rows.size() * 32 > Size()) {
+            entry.bitmap.assign(row / 64 + 1, 0);
+            for (const std::uint32_t posted : entry.rows) {
+                entry.bitmap[posted / 64] |= std::uint64_t(1) << (posted % 64);
+            }
+        }
+    });
+}
+
+std::size_t ScholarshipStore::Query(const ScholarshipQuery& query, std::vector<std::uint32_t>& page) const
+{
+    page.clear();
+
+    std::vector<const Bitmap*> required;
+    std::uint16_t majorId = 0;
+    if (!query.major.empty()) {
+        const auto majorIt = majorIds.find(query.major);
+        if (majorIt == majorIds.end()) {
+            return 0;
+        }
+        majorId = majorIt->second;
+        required.push_back(&majorBitmaps[majorId]);
+    }
+
+    const int lastKnownYear = static_cast<int>(yearBitmaps.size()) - 1;
+    const int firstYear = std::max(query.firstYear, 1);
+    const int lastYear = query.lastYear > 0 ? std::min(query.lastYear, lastKnownYear) : lastKnownYear;
+    if (firstYear > lastYear) {
+        return 0;
+    }
+
+    std::vector<const TermPostings*> sparse;
+    bool unknownTerm = false;
+    std::string term;
+    ForEachTerm(query.keywords, term, [&](const std::string& word) {
+        const auto it = postings.find(word);
+        if (it == postings.end()) {
+            unknownTerm = true;
+        }
+        else if (!it->second.bitmap.empty()) {
+            required.push_back(&it->second.bitmap);
+        }
+        else {
+            sparse.push_back(&it->second);
+        }
+    });
+    if (unknownTerm) {
+        return 0;
+    }
+    if (sparse.empty()) {
+        return QueryBitmaps(required, firstYear, lastYear, query, page);
+    }
+
+    // Walk the rarest word's rows. Common words and the major are bitmap lookups, the year
+    // comes straight from its column, and the other sparse lists only move forward.
+    std::sort(sparse.begin(), sparse.end(),
+        [](const TermPostings* a, const TermPostings* b) { return a->rows.size() < b->rows.size(); });
+    std::vector<std::vector<std::uint32_t>::const_iterator> cursors;
+    for (const TermPostings* list : sparse) {
+        cursors.push_back(list->rows.begin());
+    }
+
+    std::size_t total = 0;
+    for (const std::uint32_t row : sparse[0]->rows) {
+        if (yearColumn[row] < firstYear || yearColumn[row] > lastYear) {
+            continue;
+        }
+        const std::uint64_t bit = std::uint64_t(1) << (row % 64);
+        bool match = true;
+        for (std::size_t i = 0; i < required.size() && match; ++i) {
+            match = row / 64 < required[i]->size() && ((*required[i])[row / 64] & bit) != 0;
+        }
+        for (std::size_t i = 1; i < sparse.size() && match; ++i) {
+            cursors[i] = Gallop(cursors[i], sparse[i]->rows.end(), row);
+            match = cursors[i] != sparse[i]->rows.end() && *cursors[i] == row;
+        }
+        if (!match) {
+            continue;
+        }
+        if (total >= query.offset && page.size() < query.limit) {
+            page.push_back(row);
+        }
+        ++total;
+    }
+    return total;
+}
+
+// With only bitmaps to consult, a query is the AND of the required bitmaps and the OR of
+// the year bitmaps in range, computed 64 rows at a time; only words overlapping the
+// requested page are expanded into rows.
+std::size_t ScholarshipStore::QueryBitmaps(const std::vector<const Bitmap*>& required, int firstYear, int lastYear,
+    const ScholarshipQuery& query, std::vector<std::uint32_t>& page) const
+{
+    const std::size_t rows = Size();
+    const bool allYears = firstYear == 1 && lastYear == static_cast<int>(yearBitmaps.size()) - 1;
+    if (required.empty() && allYears) {
+        for (std::size_t row = query.offset; row < rows && page.size() < query.limit; ++row) {
+            page.push_back(static_cast<std::uint32_t>(row));
+        }
+        return rows;
+    }
+
+    const std::uint64_t* years[256];
+    int yearCount = 0;
+    if (!allYears) {
+        for (int year = firstYear; year <= lastYear; ++year) {
+            years[yearCount++] = yearBitmaps[year].data();
+        }
+    }
+
+    // A word's bitmap stops at the last row that has it, so nothing past the shortest
+    // required bitmap can match.
+    std::size_t words = (rows + 63) / 64;
+    for (const Bitmap* bitmap : required) {
+        words = std::min(words, bitmap->size());
+    }
+    std::size_t total = 0;
+    for (std::size_t word = 0; word < words; ++word) {
+        std::uint64_t bits = ~std::uint64_t(0);
+        for (const Bitmap* bitmap : required) {
+            bits &= (*bitmap)[word];
+        }
+        if (yearCount > 0) {
+            std::uint64_t inRange = 0;
+            for (int year = 0; year < yearCount; ++year) {
+                inRange |= years[year][word];
+            }
+            bits &= inRange;
+        }
+        const std::size_t count = static_cast<std::size_t>(CountBits(bits));
+        if (total + count > query.offset && page.size() < query.limit) {
+            std::size_t skip = total < query.offset ? query.offset - total : 0;
+            while (bits && page.size() < query.limit) {
+                const int bit = LowestBit(bits);
+                bits &= bits - 1;
+                if (skip > 0) {
+                    --skip;
+                    continue;
+                }
+                page.push_back(static_cast<std::uint32_t>(word * 64 + bit));
+            }
+        }
+        total += count;
+    }
+    return total;
+}
+
+int FindScholarships(int argc, char* argv[])
+{
+    ScholarshipStore store;
+    store.AddCatalog();
+
+    std::string major;
+    std::string keywords;
+    ScholarshipQuery query;
+    std::size_t pageNumber = 1;
+    for (int i = 0; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << option << "\n";
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (option == "--file") {
+            std::string error;
+            if (!store.LoadFile(value, error)) {
+                std::cerr << error << "\n";
+                return 1;
+            }
+        }
+        else if (option == "--major") {
+            major = value;
+        }
+        else if (option == "--years") {
+            const std::size_t dash = value.find('-');
+            query.firstYear = std::atoi(value.substr(0, dash).c_str());
+            query.lastYear = dash == std::string::npos ? query.firstYear : std::atoi(value.substr(dash + 1).c_str());
+        }
+        else if (option == "--keywords") {
+            keywords = value;
+        }
+        else if (option == "--page") {
+            pageNumber = static_cast<std::size_t>(std::max(1, std::atoi(value.c_str())));
+        }
+        else if (option == "--page-size") {
+            query.limit = static_cast<std::size_t>(std::max(1, std::atoi(value.c_str())));
+        }
+        else {
+            std::cerr << "Unknown option " << option << "\n";
+            return 1;
+        }
+    }
+    query.major = major;
+    query.keywords = keywords;
+    query.offset = (pageNumber - 1) * query.limit;
+
+    std::vector<std::uint32_t> page;
+    const auto started = std::chrono::steady_clock::now();
+    const std::size_t total = store.Query(query, page);
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+
+    if (page.empty()) {
+        std::cout << "No scholarships match (" << total << " in total).\n";
+    }
+    else {
+        std::cout << "Scholarships " << query.offset + 1 << "-" << query.offset + page.size() << " of " << total << ":\n";
+        for (const std::uint32_t row : page) {
+            std::cout << "- " << store.Name(row) << ": " << store.Description(row)
+                << " (" << store.Major(row) << ", Year " << store.Year(row) << ")\n";
+        }
+    }
+    std::cerr << "Searched " << store.Size() << " scholarships in " << std::fixed << std::setprecision(1)
+        << std::chrono::duration<double, std::micro>(elapsed).count() << " us\n";
+    return 0;
+}
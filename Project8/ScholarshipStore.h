@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Catalog.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Bit helpers, also used by the curriculum closures.
+int CountBits(std::uint64_t bits);
+int LowestBit(std::uint64_t bits);
+
+// Any combination of filters; a field left at its default matches everything.
+struct ScholarshipQuery
+{
+    std::string_view major;
+    int firstYear = 0;
+    int lastYear = 0;
+    std::string_view keywords;  // every word must appear in the name or description
+    std::size_t offset = 0;
+    std::size_t limit = 20;
+};
+
+// Scholarships from every sponsor, stored column by column and indexed for queries that
+// combine major, year range and keywords. Majors and years each get a bitmap with one bit
+// per scholarship; every word of a name or description gets a sorted posting list, and
+// common words a bitmap as well. Queries AND bitmaps 64 rows at a time, or walk the
+// rarest word's posting list, and only expand the rows on the requested page.
+class ScholarshipStore
+{
+public:
+    std::uint32_t Add(std::string_view major, int year, std::string_view name, std::string_view description);
+    void AddCatalog();
+    bool LoadFile(const std::string& path, std::string& error);
+
+    std::size_t Size() const;
+    std::string_view Major(std::uint32_t row) const;
+    int Year(std::uint32_t row) const;
+    std::string_view Name(std::uint32_t row) const;
+    std::string_view Description(std::uint32_t row) const;
+
+    // Fills `page` with the matching rows from query.offset on, at most query.limit of
+    // them, in the order they were added. Returns how many rows match in total.
+    std::size_t Query(const ScholarshipQuery& query, std::vector<std::uint32_t>& page) const;
+
+private:
+    typedef std::vector<std::uint64_t> Bitmap;
+
+    struct TermPostings
+    {
+        std::vector<std::uint32_t> rows;
+        Bitmap bitmap;  // empty until the word is common
+    };
+
+    CatalogStringRef AppendText(std::string_view value);
+    std::string_view Text(const CatalogStringRef& ref) const;
+    void IndexTerms(std::string_view value, std::uint32_t row);
+    std::size_t QueryBitmaps(const std::vector<const Bitmap*>& required, int firstYear, int lastYear,
+        const ScholarshipQuery& query, std::vector<std::uint32_t>& page) const;
+
+    std::vector<std::uint16_t> majorColumn;
+    std::vector<std::uint8_t> yearColumn;
+    std::vector<CatalogStringRef> nameColumn;
+    std::vector<CatalogStringRef> descriptionColumn;
+    std::string text;
+
+    std::vector<std::string> majorNames;
+    std::map<std::string, std::uint16_t, std::less<>> majorIds;
+    std::vector<Bitmap> majorBitmaps;
+    std::vector<Bitmap> yearBitmaps;  // indexed by year
+    std::unordered_map<std::string, TermPostings> postings;
+};
+
+// Prints one page of scholarships matching the options that follow --find-scholarships.
+int FindScholarships(int argc, char* argv[]);
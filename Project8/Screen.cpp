@@ -0,0 +1,122 @@
+#include "Screen.h"
+
+#include "Instrumentation.h"
+
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// A screen never comes close to this. Only a runaway loop, such as prompting again and
+// again after input has ended, gets here, and then the output is sent instead of kept.
+const std::size_t screenSendThreshold = 64 * 1024;
+
+ScreenStream::ScreenBuffer::ScreenBuffer(int fd, std::ostream* sink) : fd(fd), sink(sink)
+{
+}
+
+std::string_view ScreenStream::ScreenBuffer::View() const
+{
+    return screen;
+}
+
+void ScreenStream::ScreenBuffer::Clear()
+{
+    screen.clear();
+}
+
+ScreenStream::ScreenBuffer::int_type ScreenStream::ScreenBuffer::overflow(int_type c)
+{
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+        return traits_type::not_eof(c);
+    }
+    screen.push_back(traits_type::to_char_type(c));
+    if (screen.size() >= screenSendThreshold && !Send()) {
+        return traits_type::eof();
+    }
+    return c;
+}
+
+std::streamsize ScreenStream::ScreenBuffer::xsputn(const char* data, std::streamsize count)
+{
+    screen.append(data, static_cast<std::size_t>(count));
+    if (screen.size() >= screenSendThreshold && !Send()) {
+        return 0;
+    }
+    return count;
+}
+
+int ScreenStream::ScreenBuffer::sync()
+{
+    return Send() ? 0 : -1;
+}
+
+// Writes the pending screen to the sink and empties the buffer. With no sink the screen
+// stays put for the caller to collect.
+bool ScreenStream::ScreenBuffer::Send()
+{
+    if (screen.empty()) {
+        return true;
+    }
+    StageTimer timer(Stage::Render);
+    if (sink) {
+        sink->write(screen.data(), static_cast<std::streamsize>(screen.size()));
+        sink->flush();
+        screen.clear();
+        return sink->good();
+    }
+    if (fd < 0) {
+        return true;
+    }
+    std::size_t written = 0;
+    while (written < screen.size()) {
+#ifdef _WIN32
+        const int result = ::_write(fd, screen.data() + written, static_cast<unsigned int>(screen.size() - written));
+#else
+        const ssize_t result = ::write(fd, screen.data() + written, screen.size() - written);
+#endif
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            screen.clear();
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    screen.clear();
+    return true;
+}
+
+ScreenStream::ScreenStream() : std::ostream(nullptr), buffer(-1, nullptr)
+{
+    rdbuf(&buffer);
+}
+
+ScreenStream::ScreenStream(int fd) : std::ostream(nullptr), buffer(fd, nullptr)
+{
+    rdbuf(&buffer);
+}
+
+ScreenStream::ScreenStream(std::ostream& sink) : std::ostream(nullptr), buffer(-1, &sink)
+{
+    rdbuf(&buffer);
+}
+
+ScreenStream::~ScreenStream()
+{
+    buffer.pubsync();
+}
+
+std::string_view ScreenStream::View() const
+{
+    return buffer.View();
+}
+
+void ScreenStream::Clear()
+{
+    buffer.Clear();
+}
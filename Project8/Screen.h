@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+constexpr int standardOutputFd = 1;
+
+// An output stream that renders one screen at a time into a reusable buffer. Nothing
+// reaches the sink until flush() is called, either directly or by an input stream tied
+// to this one, and then the whole screen goes out in a single write. The buffer keeps
+// its capacity between screens, so steady-state rendering does not allocate.
+//
+// Without a sink the caller takes View() and calls Clear() itself; the server does this
+// to queue replies for a socket.
+class ScreenStream : public std::ostream
+{
+public:
+    ScreenStream();
+    explicit ScreenStream(int fd);
+    explicit ScreenStream(std::ostream& sink);
+    ~ScreenStream();
+
+    std::string_view View() const;
+    void Clear();
+
+private:
+    class ScreenBuffer : public std::streambuf
+    {
+    public:
+        ScreenBuffer(int fd, std::ostream* sink);
+        std::string_view View() const;
+        void Clear();
+
+    protected:
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char* data, std::streamsize count) override;
+        int sync() override;
+
+    private:
+        bool Send();
+
+        std::string screen;
+        int fd;
+        std::ostream* sink;
+    };
+
+    ScreenBuffer buffer;
+};
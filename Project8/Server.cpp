@@ -0,0 +1,553 @@
+#include "Server.h"
+
+#include <iostream>
+
+#ifdef __linux__
+#include "AdvisorSession.h"
+#include "Analytics.h"
+#include "Catalog.h"
+#include "Instrumentation.h"
+#include "Journal.h"
+#include "Screen.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+// Server mode: every connection is an AdvisorSession driven by line-oriented input.
+// Per-connection buffers are capped, and a client that stops reading its replies
+// stops being read from until it catches up.
+const std::size_t serverInputLimit = 4096;
+const std::size_t serverOutputLimit = 16384;
+const int serverEventBatch = 256;
+
+volatile std::sig_atomic_t serverStopRequested = 0;
+
+void RequestServerStop(int)
+{
+    serverStopRequested = 1;
+}
+
+// "unix:PATH" or anything containing '/' is a Unix socket path; otherwise "[HOST:]PORT"
+// on IPv4, with HOST defaulting to 127.0.0.1.
+bool ParseSocketAddress(const std::string& address, sockaddr_storage& storage, socklen_t& length)
+{
+    std::memset(&storage, 0, sizeof(storage));
+    std::string path = address.compare(0, 5, "unix:") == 0 ? address.substr(5) : address;
+    if (address.compare(0, 5, "unix:") == 0 || address.find('/') != std::string::npos) {
+        sockaddr_un* unixAddress = reinterpret_cast<sockaddr_un*>(&storage);
+        if (path.empty() || path.size() >= sizeof(unixAddress->sun_path)) {
+            return false;
+        }
+        unixAddress->sun_family = AF_UNIX;
+        std::memcpy(unixAddress->sun_path, path.c_str(), path.size() + 1);
+        length = sizeof(sockaddr_un);
+        return true;
+    }
+
+    std::string host = "127.0.0.1";
+    std::string port = address;
+    const std::size_t colon = address.rfind(':');
+    if (colon != std::string::npos) {
+        host = address.substr(0, colon);
+        port = address.substr(colon + 1);
+    }
+    int portNumber = 0;
+    if (std::from_chars(port.data(), port.data() + port.size(), portNumber).ec != std::errc() ||
+        portNumber <= 0 || portNumber > 65535) {
+        return false;
+    }
+    sockaddr_in* inetAddress = reinterpret_cast<sockaddr_in*>(&storage);
+    inetAddress->sin_family = AF_INET;
+    inetAddress->sin_port = htons(static_cast<std::uint16_t>(portNumber));
+    if (inet_pton(AF_INET, host.c_str(), &inetAddress->sin_addr) != 1) {
+        return false;
+    }
+    length = sizeof(sockaddr_in);
+    return true;
+}
+
+// Thousands of sessions need thousands of descriptors; take whatever the hard limit allows.
+void RaiseDescriptorLimit()
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+struct ServerConnection
+{
+    int fd;
+    std::uint32_t events;
+    AdvisorSession session;
+    std::string input;
+    std::string output;
+    std::size_t outputSent;
+    std::uint64_t journalSession;  // 0 without a journal
+    bool answered;                 // has handled a line, so "resume" is no longer accepted
+    bool inputClosed;              // the client has shut down its side; what it sent is still answered
+    std::shared_ptr<const MappedCatalog> catalog;  // the snapshot this session reads throughout
+};
+
+class ServerWorker
+{
+public:
+    ServerWorker(int listenFd, SessionJournal* journal);
+    ~ServerWorker();
+    void Run();
+
+private:
+    void AcceptConnections();
+    bool ServiceConnection(ServerConnection& connection, bool readable);
+    void Render(ServerConnection& connection);
+    void HandleLine(ServerConnection& connection, std::string_view line);
+    void CloseConnection(ServerConnection* connection);
+
+    int listenFd;
+    int epollFd;
+    SessionJournal* journal;
+    ScreenStream render;
+    std::unordered_set<ServerConnection*> connections;
+};
+
+ServerWorker::ServerWorker(int listenFd, SessionJournal* journal)
+    : listenFd(listenFd), epollFd(epoll_create1(EPOLL_CLOEXEC)), journal(journal)
+{
+    // EPOLLEXCLUSIVE wakes one worker per incoming connection instead of all of them.
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLEXCLUSIVE;
+    event.data.ptr = nullptr;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+}
+
+ServerWorker::~ServerWorker()
+{
+    for (ServerConnection* connection : connections) {
+        close(connection->fd);
+        delete connection;
+    }
+    close(epollFd);
+}
+
+void ServerWorker::Run()
+{
+    epoll_event events[serverEventBatch];
+    while (!serverStopRequested) {
+        const int ready = epoll_wait(epollFd, events, serverEventBatch, 200);
+        for (int n = 0; n < ready; ++n) {
+            ServerConnection* connection = static_cast<ServerConnection*>(events[n].data.ptr);
+            if (connection == nullptr) {
+                AcceptConnections();
+                continue;
+            }
+            const bool failed = (events[n].events & (EPOLLERR | EPOLLHUP)) != 0;
+            if (failed || !ServiceConnection(*connection, (events[n].events & EPOLLIN) != 0)) {
+                CloseConnection(connection);
+            }
+        }
+    }
+}
+
+void ServerWorker::AcceptConnections()
+{
+    while (true) {
+        const int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        ServerConnection* connection = new ServerConnection{ fd, EPOLLIN, AdvisorSession(), std::string(), std::string(), 0, 0, false,
+            false, PublishedCatalog() };
+        epoll_event event{};
+        event.events = connection->events;
+        event.data.ptr = connection;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            delete connection;
+            continue;
+        }
+        connections.insert(connection);
+        if (journal) {
+            journal->Begin(connection->journalSession);
+            render << "Session " << connection->journalSession << ". If you get disconnected, reconnect and send \"resume "
+                   << connection->journalSession << "\" to continue.\n";
+        }
+        {
+            CatalogScope catalogScope(connection->catalog.get());
+            connection->session.Start(render);
+        }
+        Render(*connection);
+        if (!ServiceConnection(*connection, false)) {
+            CloseConnection(connection);
+        }
+    }
+}
+
+void ServerWorker::Render(ServerConnection& connection)
+{
+    StageTimer timer(Stage::Render);
+    connection.output.append(render.View());
+    render.Clear();
+}
+
+// Reads what is available, answers every complete line while there is room for the
+// reply, and writes as much as the socket takes. Returns false once the connection
+// should be closed: the session is over, or the client has stopped sending and every
+// line it sent has been answered, and the replies are all written.
+bool ServerWorker::ServiceConnection(ServerConnection& connection, bool readable)
+{
+    if (readable && !connection.inputClosed && connection.input.size() < serverInputLimit) {
+        char buffer[serverInputLimit];
+        const ssize_t received = recv(connection.fd, buffer, serverInputLimit - connection.input.size(), 0);
+        if (received == 0) {
+            connection.inputClosed = true;
+        }
+        if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            return false;
+        }
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<std::size_t>(received));
+        }
+    }
+
+    bool progress = true;
+    while (progress) {
+        progress = false;
+
+        std::size_t consumed = 0;
+        while (!connection.session.IsFinished() && connection.output.size() - connection.outputSent < serverOutputLimit) {
+            const std::size_t newline = connection.input.find('\n', consumed);
+            if (newline == std::string::npos) {
+                break;
+            }
+            HandleLine(connection, std::string_view(connection.input).substr(consumed, newline - consumed));
+            Render(connection);
+            consumed = newline + 1;
+        }
+        connection.input.erase(0, consumed);
+        if (connection.input.size() >= serverInputLimit && connection.input.find('\n') == std::string::npos) {
+            return false; // a line longer than the whole input buffer is not a menu answer
+        }
+
+        while (connection.outputSent < connection.output.size()) {
+            const ssize_t sent = send(connection.fd, connection.output.data() + connection.outputSent,
+                connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            connection.outputSent += static_cast<std::size_t>(sent);
+        }
+        if (connection.outputSent == connection.output.size()) {
+            connection.output.clear();
+            connection.outputSent = 0;
+            // Draining the output may have unblocked lines that were already buffered.
+            progress = !connection.session.IsFinished() && connection.input.find('\n') != std::string::npos;
+        }
+    }
+
+    const bool pending = !connection.output.empty();
+    const bool answeredAll = connection.session.IsFinished() ||
+        (connection.inputClosed && connection.input.find('\n') == std::string::npos);
+    if (answeredAll && !pending) {
+        return false;
+    }
+    // Lines left waiting for room in the output are not read past: reading resumes once
+    // the output drains and they have been answered.
+    const bool paused = (pending && connection.output.size() - connection.outputSent >= serverOutputLimit) ||
+        connection.input.size() >= serverInputLimit;
+    const bool reading = !paused && !connection.inputClosed;
+    const std::uint32_t wanted = (reading ? static_cast<std::uint32_t>(EPOLLIN) : 0u) | (pending ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+    if (wanted != connection.events) {
+        epoll_event event{};
+        event.events = wanted;
+        event.data.ptr = &connection;
+        if (epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event) != 0) {
+            return false;
+        }
+        connection.events = wanted;
+    }
+    return true;
+}
+
+// Journals the line before handling it. Replies do not wait for the disk: a crash can lose
+// the last group commit's worth of answers, which the student then gives again.
+void ServerWorker::HandleLine(ServerConnection& connection, std::string_view line)
+{
+    CatalogScope catalogScope(connection.catalog.get());
+    if (!journal) {
+        connection.session.HandleLine(line, render);
+        return;
+    }
+    if (!connection.answered && line.compare(0, 7, "resume ") == 0) {
+        std::uint64_t session = 0;
+        JournaledSession state;
+        const std::string_view number = line.substr(7);
+        if (std::from_chars(number.data(), number.data() + number.size(), session).ec == std::errc() &&
+            session != 0 && session != connection.journalSession && journal->Claim(session, state)) {
+            journal->End(connection.journalSession);
+            connection.journalSession = session;
+            connection.answered = true;
+            render << "Welcome back! Continuing where you left off.\n";
+            ResumeSession(state, connection.session, render);
+            return;
+        }
+        render << "There is no session " << number << " to continue.\n";
+    }
+    connection.answered = true;
+    journal->Line(connection.journalSession, connection.session, line);
+    connection.session.HandleLine(line, render);
+}
+
+void ServerWorker::CloseConnection(ServerConnection* connection)
+{
+    if (journal && connection->session.IsFinished()) {
+        journal->End(connection->journalSession);
+    }
+    else if (journal) {
+        journal->Release(connection->journalSession);
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+    close(connection->fd);
+    connections.erase(connection);
+    delete connection;
+}
+
+int RunServer(const std::string& address, int threadCount, SessionJournal* journal)
+{
+    sockaddr_storage storage;
+    socklen_t length = 0;
+    if (!ParseSocketAddress(address, storage, length)) {
+        std::cerr << "Invalid server address: " << address << "\n";
+        return 1;
+    }
+    RaiseDescriptorLimit();
+
+    const int listenFd = socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    const int enable = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (storage.ss_family == AF_UNIX) {
+        unlink(reinterpret_cast<sockaddr_un*>(&storage)->sun_path);
+    }
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&storage), length) != 0 || listen(listenFd, SOMAXCONN) != 0) {
+        std::cerr << "Cannot listen on " << address << ": " << std::strerror(errno) << "\n";
+        close(listenFd);
+        return 1;
+    }
+
+    std::signal(SIGINT, RequestServerStop);
+    std::signal(SIGTERM, RequestServerStop);
+
+    threadCount = std::max(threadCount, 1);
+    std::cout << "Serving on " << address << " with " << threadCount << " thread(s). Press Ctrl+C to stop.\n" << std::flush;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([listenFd, journal]() {
+            ServerWorker worker(listenFd, journal);
+            worker.Run();
+        });
+    }
+    // The workers stop on their own; meanwhile this thread reloads the catalog and writes
+    // analytics and stage reports when asked, so none of it holds up a session.
+    while (!serverStopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        ReloadCatalogIfRequested();
+        if (analyticsSnapshotRequested) {
+            analyticsSnapshotRequested = 0;
+            SaveAnalytics();
+        }
+        if (instrumentationReportRequested) {
+            instrumentationReportRequested = 0;
+            SaveInstrumentation();
+        }
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    close(listenFd);
+    if (storage.ss_family == AF_UNIX) {
+        unlink(reinterpret_cast<sockaddr_un*>(&storage)->sun_path);
+    }
+    return 0;
+}
+
+// Scripted session for the load client: a "back" in the degree questionnaire, the
+// recommended degree (Computer Technology), no scholarship lookup, six major answers, exit.
+constexpr std::string_view loadClientScript =
+    "2\ny\nn\ny\nback\ny\nn\ny\nn\ny\nn\ny\nn\n1\n2\ny\nn\nn\nn\nn\nn\n7\n";
+constexpr std::string_view loadClientGoodbye = "Thank you for using our program. Goodbye!\n";
+
+struct LoadConnection
+{
+    int fd;
+    std::size_t sent;
+    std::string tail;
+    std::chrono::steady_clock::time_point started;
+};
+
+int RunLoadClient(const std::string& address, int concurrency, long totalSessions)
+{
+    sockaddr_storage storage;
+    socklen_t length = 0;
+    if (!ParseSocketAddress(address, storage, length) || concurrency < 1 || totalSessions < 1) {
+        std::cerr << "Invalid load client arguments.\n";
+        return 1;
+    }
+    RaiseDescriptorLimit();
+
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    long started = 0;
+    long completed = 0;
+    long failed = 0;
+    int open = 0;
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(totalSessions));
+
+    auto startSession = [&]() {
+        const int fd = socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        started++;
+        if (fd < 0) {
+            failed++;
+            return;
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&storage), length) != 0 && errno != EINPROGRESS) {
+            close(fd);
+            failed++;
+            return;
+        }
+        LoadConnection* connection = new LoadConnection{ fd, 0, std::string(), std::chrono::steady_clock::now() };
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT;
+        event.data.ptr = connection;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        open++;
+    };
+    auto finishSession = [&](LoadConnection* connection, bool ok) {
+        if (ok) {
+            completed++;
+            latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - connection->started).count());
+        }
+        else {
+            failed++;
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+        close(connection->fd);
+        delete connection;
+        open--;
+    };
+
+    const auto begin = std::chrono::steady_clock::now();
+    while (started < totalSessions && open < concurrency) {
+        startSession();
+    }
+
+    epoll_event events[serverEventBatch];
+    char buffer[16384];
+    while (open > 0) {
+        const int ready = epoll_wait(epollFd, events, serverEventBatch, 1000);
+        for (int n = 0; n < ready; ++n) {
+            LoadConnection* connection = static_cast<LoadConnection*>(events[n].data.ptr);
+            bool done = false;
+            bool ok = false;
+            if (events[n].events & EPOLLERR) {
+                done = true;
+            }
+            if (!done && (events[n].events & EPOLLOUT) && connection->sent < loadClientScript.size()) {
+                const ssize_t sent = send(connection->fd, loadClientScript.data() + connection->sent,
+                    loadClientScript.size() - connection->sent, MSG_NOSIGNAL);
+                if (sent > 0) {
+                    connection->sent += static_cast<std::size_t>(sent);
+                }
+                else if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                    done = true;
+                }
+                if (connection->sent == loadClientScript.size()) {
+                    epoll_event event{};
+                    event.events = EPOLLIN;
+                    event.data.ptr = connection;
+                    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+                }
+            }
+            while (!done && (events[n].events & (EPOLLIN | EPOLLHUP))) {
+                const ssize_t received = recv(connection->fd, buffer, sizeof(buffer), 0);
+                if (received > 0) {
+                    connection->tail.append(buffer, static_cast<std::size_t>(received));
+                    if (connection->tail.size() > loadClientGoodbye.size()) {
+                        connection->tail.erase(0, connection->tail.size() - loadClientGoodbye.size());
+                    }
+                    continue;
+                }
+                if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    break;
+                }
+                done = true;
+                ok = received == 0 && connection->tail == loadClientGoodbye;
+            }
+            if (done) {
+                finishSession(connection, ok);
+                while (started < totalSessions && open < concurrency) {
+                    startSession();
+                }
+            }
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    close(epollFd);
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies.empty() ? 0.0 : latencies[static_cast<std::size_t>(p * (latencies.size() - 1))];
+    };
+    std::cout << "sessions=" << completed << " failed=" << failed << " concurrency=" << concurrency
+        << std::fixed << std::setprecision(3) << " seconds=" << seconds
+        << " sessions_per_second=" << (seconds > 0 ? completed / seconds : 0.0)
+        << " p50_ms=" << percentile(0.50) << " p99_ms=" << percentile(0.99) << "\n";
+    return failed == 0 ? 0 : 1;
+}
+
+#else
+
+int RunServer(const std::string&, int, SessionJournal*)
+{
+    std::cerr << "Server mode is only available on Linux.\n";
+    return 1;
+}
+
+int RunLoadClient(const std::string&, int, long)
+{
+    std::cerr << "The load client is only available on Linux.\n";
+    return 1;
+}
+
+#endif
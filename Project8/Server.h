@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+class SessionJournal;
+
+// Serves AdvisorSessions over a socket until interrupted. Linux only. With a journal, each
+// connection is told its session number, and a connection whose first line is
+// "resume N" continues session N where it was cut off.
+int RunServer(const std::string& address, int threadCount, SessionJournal* journal = nullptr);
+
+// Keeps `concurrency` sessions open against a server until `totalSessions` have run,
+// then reports throughput and session latency.
+int RunLoadClient(const std::string& address, int concurrency, long totalSessions);
@@ -0,0 +1,384 @@
+#include "SessionExport.h"
+
+#include "Analytics.h"
+#include "MajorRanking.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+
+struct SessionExport
+{
+    std::mutex mutex;
+    ColumnarWriter writer;
+    std::vector<SessionResult> pending;
+    std::vector<ColumnValues> values;  // reused for every row group
+    bool failed = false;
+};
+
+// Set once by OpenSessionExport, before any session runs.
+SessionExport* sessionExport = nullptr;
+
+std::int64_t SessionClock()
+{
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+std::string_view FallbackName(OutcomeFallback fallback)
+{
+    switch (fallback) {
+    case OutcomeFallback::AllNo:
+        return "all_no";
+    case OutcomeFallback::AllYes:
+        return "all_yes";
+    default:
+        return "none";
+    }
+}
+
+std::vector<ColumnSpec> SessionExportColumns()
+{
+    const DegreeWeights& weights = ActiveDegreeWeights();
+    const MajorRanking& ranking = GetMajorRanking();
+    std::vector<ColumnSpec> columns = {
+        { "start_time", ColumnType::Int64 },
+        { "end_time", ColumnType::Int64 },
+        { "degree_answered", ColumnType::Bool },
+    };
+    for (int k = 0; k < degreeQuestionCount; ++k) {
+        columns.push_back({ "degree_q" + std::to_string(k + 1), ColumnType::Bool });
+    }
+    columns.push_back({ "degree_fallback", ColumnType::String });
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        columns.push_back({ "degree_score." + weights.DegreeName(d), ColumnType::Int32 });
+    }
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        columns.push_back({ "degree_percent." + weights.DegreeName(d), ColumnType::Float64 });
+    }
+    columns.push_back({ "recommended_degree", ColumnType::String });
+    columns.push_back({ "chosen_degree", ColumnType::String });
+    columns.push_back({ "majors_answered", ColumnType::Bool });
+    for (std::uint32_t q = 0; q < ranking.QuestionCount(); ++q) {
+        columns.push_back({ "major_q" + std::to_string(q + 1), ColumnType::Bool });
+    }
+    columns.push_back({ "major_fallback", ColumnType::String });
+    for (std::uint16_t m = 0; m < ranking.MajorCount(); ++m) {
+        columns.push_back({ "major_score." + std::string(ranking.MajorName(m)), ColumnType::Int32 });
+    }
+    columns.push_back({ "final_major", ColumnType::String });
+    columns.push_back({ "scholarship_queries", ColumnType::Int32 });
+    for (std::size_t k = 0; k < sessionScholarshipQueryLimit; ++k) {
+        columns.push_back({ "scholarship_major_" + std::to_string(k + 1), ColumnType::String });
+        columns.push_back({ "scholarship_year_" + std::to_string(k + 1), ColumnType::Int32 });
+    }
+    return columns;
+}
+
+void FillSessionColumns(const SessionResult* results, std::size_t count, std::vector<ColumnValues>& values)
+{
+    const DegreeWeights& weights = ActiveDegreeWeights();
+    const MajorRanking& ranking = GetMajorRanking();
+    const std::size_t degrees = weights.DegreeCount();
+    const std::size_t majors = ranking.MajorCount();
+    values.resize(SessionExportColumns().size());
+    for (ColumnValues& column : values) {
+        column.Clear();
+    }
+    std::vector<int> degreeScores(weights.Stride());
+    std::vector<int> majorScores(majors);
+    std::vector<std::uint64_t> majorWords(ranking.AnswerWords());
+    for (std::size_t r = 0; r < count; ++r) {
+        const SessionResult& result = results[r];
+        std::size_t c = 0;
+        values[c++].ints.push_back(result.startTime);
+        values[c++].ints.push_back(result.endTime);
+
+        values[c++].bools.push_back(result.degreeAnswered);
+        for (int k = 0; k < degreeQuestionCount; ++k) {
+            values[c++].bools.push_back((result.degreeAnswers >> k) & 1);
+        }
+        values[c++].strings.push_back(result.degreeAnswered ? FallbackName(result.degreeFallback) : std::string_view());
+        std::fill(degreeScores.begin(), degreeScores.end(), 0);
+        if (result.degreeAnswered) {
+            weights.Score(result.degreeAnswers, degreeScores.data());
+        }
+        for (std::size_t d = 0; d < degrees; ++d) {
+            values[c++].ints.push_back(degreeScores[d]);
+        }
+        const double* percentages = weights.Percentages(result.degreeAnswers);
+        for (std::size_t d = 0; d < degrees; ++d) {
+            values[c++].doubles.push_back(result.degreeAnswered ? percentages[d] : std::numeric_limits<double>::quiet_NaN());
+        }
+        values[c++].strings.push_back(result.degreeRecommended ? std::string_view(weights.DegreeName(result.recommendedDegree)) : std::string_view());
+        values[c++].strings.push_back(result.degreeChosen ? std::string_view(weights.DegreeName(result.chosenDegree)) : std::string_view());
+
+        // Session major answers count from the chosen degree's first question.
+        std::fill(majorWords.begin(), majorWords.end(), 0);
+        if (result.majorsAnswered && result.degreeChosen) {
+            const auto degreeMajors = ranking.DegreeMajors(weights.CatalogId(result.chosenDegree));
+            if (degreeMajors.first != degreeMajors.second) {
+                const std::uint32_t first = ranking.MajorQuestions(degreeMajors.first).first;
+                const std::uint32_t last = ranking.MajorQuestions(degreeMajors.second - 1).second;
+                for (std::uint32_t q = first; q < last; ++q) {
+                    majorWords[q / 64] |= ((result.majorAnswers >> (q - first)) & 1) << (q % 64);
+                }
+            }
+        }
+        values[c++].bools.push_back(result.majorsAnswered);
+        for (std::uint32_t q = 0; q < ranking.QuestionCount(); ++q) {
+            values[c++].bools.push_back((majorWords[q / 64] >> (q % 64)) & 1);
+        }
+        values[c++].strings.push_back(result.majorsAnswered ? FallbackName(result.majorFallback) : std::string_view());
+        ranking.Score(majorWords.data(), majorScores.data());
+        for (std::size_t m = 0; m < majors; ++m) {
+            values[c++].ints.push_back(majorScores[m]);
+        }
+        values[c++].strings.push_back(result.majorChosen ? ranking.MajorName(result.finalMajor) : std::string_view());
+
+        values[c++].ints.push_back(result.scholarshipQueryCount);
+        for (std::size_t k = 0; k < sessionScholarshipQueryLimit; ++k) {
+            const bool kept = k < result.scholarshipQueryCount;
+            values[c++].strings.push_back(kept ? Name(static_cast<MajorId>(result.scholarshipMajors[k])) : std::string_view());
+            values[c++].ints.push_back(kept ? result.scholarshipYears[k] : 0);
+        }
+    }
+}
+
+// Called with the export's mutex held.
+void WritePendingSessions(SessionExport& target)
+{
+    if (target.pending.empty()) {
+        return;
+    }
+    std::string error;
+    FillSessionColumns(target.pending.data(), target.pending.size(), target.values);
+    if (!target.failed && !target.writer.WriteRowGroup(target.values, target.pending.size(), error)) {
+        std::cerr << "Session export: " << error << "\n";
+        target.failed = true;
+    }
+    target.pending.clear();
+}
+
+bool OpenSessionExport(const std::string& path, std::string& error)
+{
+    SessionExport* target = new SessionExport();
+    if (!target->writer.Open(path, SessionExportColumns(), error)) {
+        delete target;
+        return false;
+    }
+    target->pending.reserve(sessionExportGroupRows);
+    sessionExport = target;
+    return true;
+}
+
+void RecordSessionResult(const SessionResult& result)
+{
+    if (!sessionExport || AnalyticsPaused()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sessionExport->mutex);
+    if (!sessionExport->writer.IsOpen()) {
+        return;
+    }
+    sessionExport->pending.push_back(result);
+    if (sessionExport->pending.size() == sessionExportGroupRows) {
+        WritePendingSessions(*sessionExport);
+    }
+}
+
+void CloseSessionExport()
+{
+    if (!sessionExport) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sessionExport->mutex);
+    WritePendingSessions(*sessionExport);
+    std::string error;
+    if (!sessionExport->failed && !sessionExport->writer.Close(error)) {
+        std::cerr << "Session export: " << error << "\n";
+        sessionExport->failed = true;
+    }
+}
+
+void PrintColumnValue(const ColumnSpec& column, const ColumnValues& values, std::size_t row)
+{
+    switch (column.type) {
+    case ColumnType::Bool:
+        std::cout << static_cast<int>(values.bools[row]);
+        break;
+    case ColumnType::Int32:
+    case ColumnType::Int64:
+        std::cout << values.ints[row];
+        break;
+    case ColumnType::Float64:
+        std::cout << values.doubles[row];
+        break;
+    case ColumnType::String:
+        std::cout << values.strings[row];
+        break;
+    }
+}
+
+int PrintSessionExport(const std::string& path, const std::vector<std::string>& names)
+{
+    ColumnarReader reader;
+    std::string error;
+    if (!reader.Open(path, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    const std::vector<ColumnSpec>& columns = reader.Columns();
+    std::vector<std::size_t> selected;
+    for (const std::string& name : names) {
+        std::size_t c = 0;
+        while (c < columns.size() && columns[c].name != name) {
+            ++c;
+        }
+        if (c == columns.size()) {
+            std::cerr << path << " has no column " << name << "; its columns are:\n";
+            for (const ColumnSpec& column : columns) {
+                std::cerr << column.name << "\n";
+            }
+            return 1;
+        }
+        selected.push_back(c);
+    }
+    if (names.empty()) {
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            selected.push_back(c);
+        }
+    }
+
+    for (std::size_t i = 0; i < selected.size(); ++i) {
+        std::cout << (i ? "\t" : "") << columns[selected[i]].name;
+    }
+    std::cout << "\n";
+    std::vector<ColumnValues> values(selected.size());
+    for (std::size_t group = 0; group < reader.RowGroupCount(); ++group) {
+        for (std::size_t i = 0; i < selected.size(); ++i) {
+            if (!reader.ReadColumn(group, selected[i], values[i], error)) {
+                std::cerr << path << ": " << error << "\n";
+                return 1;
+            }
+        }
+        for (std::size_t row = 0; row < reader.RowGroupRows(group); ++row) {
+            for (std::size_t i = 0; i < selected.size(); ++i) {
+                if (i) {
+                    std::cout << '\t';
+                }
+                PrintColumnValue(columns[selected[i]], values[i], row);
+            }
+            std::cout << '\n';
+        }
+    }
+    return 0;
+}
+
+bool SameColumnValue(ColumnType type, const ColumnValues& expected, const ColumnValues& actual, std::size_t row)
+{
+    switch (type) {
+    case ColumnType::Bool:
+        return expected.bools[row] == actual.bools[row];
+    case ColumnType::Int32:
+    case ColumnType::Int64:
+        return expected.ints[row] == actual.ints[row];
+    case ColumnType::Float64:
+        return std::memcmp(&expected.doubles[row], &actual.doubles[row], sizeof(double)) == 0;
+    case ColumnType::String:
+        return expected.strings[row] == actual.strings[row];
+    }
+    return false;
+}
+
+// Results with every field in range, set or not at random, finishing in roughly time
+// order with the odd clock step backwards.
+std::vector<SessionResult> MakeSessionResults(std::size_t rows)
+{
+    const DegreeWeights& weights = ActiveDegreeWeights();
+    const MajorRanking& ranking = GetMajorRanking();
+    std::mt19937_64 random(1);
+    std::vector<SessionResult> results(rows);
+    std::int64_t clock = SessionClock();
+    for (SessionResult& result : results) {
+        std::memset(&result, 0, sizeof(result));
+        clock += static_cast<std::int64_t>(random() % 5000000000ull) - (random() % 64 == 0 ? 8000000000ll : 0);
+        result.startTime = clock - static_cast<std::int64_t>(random() % 600000000000ull);
+        result.endTime = clock;
+        result.degreeAnswered = random() % 4 != 0;
+        if (result.degreeAnswered) {
+            result.degreeAnswers = static_cast<AnswerMask>(random() % degreeAnswerCount);
+            result.degreeFallback = weights.Outcome(result.degreeAnswers).fallback;
+            result.degreeRecommended = result.degreeFallback == OutcomeFallback::None;
+            result.recommendedDegree = weights.Outcome(result.degreeAnswers).recommended;
+        }
+        result.degreeChosen = result.degreeAnswered && random() % 3 != 0;
+        result.chosenDegree = static_cast<std::uint8_t>(random() % weights.DegreeCount());
+        result.majorsAnswered = result.degreeChosen && random() % 2 == 0;
+        if (result.majorsAnswered) {
+            result.majorAnswers = random() & 0xFF;
+            result.majorFallback = static_cast<OutcomeFallback>(random() % 3);
+        }
+        result.majorChosen = result.majorsAnswered && random() % 4 != 0;
+        result.finalMajor = static_cast<std::uint16_t>(random() % ranking.MajorCount());
+        result.scholarshipQueryCount = static_cast<std::uint8_t>(random() % 7);
+        for (std::size_t k = 0; k < sessionScholarshipQueryLimit; ++k) {
+            result.scholarshipMajors[k] = static_cast<std::uint8_t>(random() % majorIdCount);
+            result.scholarshipYears[k] = static_cast<std::uint8_t>(1 + random() % 4);
+        }
+    }
+    return results;
+}
+
+int CheckSessionExport(const std::string& path, std::size_t rows)
+{
+    const std::vector<SessionResult> results = MakeSessionResults(rows);
+    std::string error;
+    if (!OpenSessionExport(path, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    for (const SessionResult& result : results) {
+        RecordSessionResult(result);
+    }
+    CloseSessionExport();
+
+    ColumnarReader reader;
+    if (!reader.Open(path, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    const std::vector<ColumnSpec> columns = SessionExportColumns();
+    bool sameSchema = reader.Columns().size() == columns.size() && reader.RowCount() == rows;
+    for (std::size_t c = 0; sameSchema && c < columns.size(); ++c) {
+        sameSchema = reader.Columns()[c].name == columns[c].name && reader.Columns()[c].type == columns[c].type;
+    }
+    if (!sameSchema) {
+        std::cerr << path << " does not have the columns and rows written\n";
+        return 1;
+    }
+    std::uint64_t differ = 0;
+    std::size_t first = 0;
+    std::vector<ColumnValues> expected;
+    ColumnValues actual;
+    for (std::size_t group = 0; group < reader.RowGroupCount(); ++group) {
+        const std::size_t groupRows = reader.RowGroupRows(group);
+        FillSessionColumns(results.data() + first, groupRows, expected);
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            if (!reader.ReadColumn(group, c, actual, error)) {
+                std::cerr << path << ": " << error << "\n";
+                return 1;
+            }
+            for (std::size_t row = 0; row < groupRows; ++row) {
+                differ += !SameColumnValue(columns[c].type, expected[c], actual, row);
+            }
+        }
+        first += groupRows;
+    }
+    std::cout << "Session export: " << rows << " rows in " << reader.RowGroupCount() << " row groups of "
+              << columns.size() << " columns read back, " << differ << " values differ.\n";
+    return differ == 0 ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "AdvisorSession.h"
+#include "ColumnarFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Finished sessions are buffered and written this many to a row group, which bounds what
+// an export holds in memory however long the process runs.
+const std::size_t sessionExportGroupRows = 8192;
+
+// Nanoseconds since the Unix epoch.
+std::int64_t SessionClock();
+// How a fallback is written: none, all_no or all_yes.
+std::string_view FallbackName(OutcomeFallback fallback);
+
+// The columns of a session export, for the active degree weights and major ranking:
+//
+//   start_time, end_time                  Int64, nanoseconds since the Unix epoch
+//   degree_answered, degree_q1..          Bool, the raw degree answers
+//   degree_fallback                       String: none, all_no or all_yes; empty if unanswered
+//   degree_score.NAME, degree_percent.NAME  one of each per degree
+//   recommended_degree, chosen_degree     String, empty when there was none
+//   majors_answered, major_q1..           Bool, one per question in GetMajorRanking()
+//   major_fallback                        String, as degree_fallback
+//   major_score.NAME                      Int32 per major; only the chosen degree's can score
+//   final_major                           String, recommended or picked after a fallback
+//   scholarship_queries                   Int32, every lookup made
+//   scholarship_major_K, scholarship_year_K  the first lookups; empty and 0 past the count
+std::vector<ColumnSpec> SessionExportColumns();
+// Fills one ColumnValues per SessionExportColumns() column from `count` results. Strings
+// point at names that live as long as the process.
+void FillSessionColumns(const SessionResult* results, std::size_t count, std::vector<ColumnValues>& values);
+
+// Streams every session that finishes from here on into a columnar file at `path`. Call
+// before any session starts; sessions being replayed under an AnalyticsPause are skipped,
+// as they were recorded the first time round.
+bool OpenSessionExport(const std::string& path, std::string& error);
+void RecordSessionResult(const SessionResult& result);
+// Writes what is buffered and the footer, reporting failures on std::cerr. The file only
+// appears under its name once this has run.
+void CloseSessionExport();
+
+// Prints the named columns of an export, or all of them, as tab-separated text.
+int PrintSessionExport(const std::string& path, const std::vector<std::string>& columns);
+// Streams `rows` made-up results through the exporter into `path`, reads every column
+// back and reports how many values differ; nonzero when any do.
+int CheckSessionExport(const std::string& path, std::size_t rows);
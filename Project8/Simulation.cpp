@@ -0,0 +1,437 @@
+#include "Simulation.h"
+
+#include "WorkPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+const std::uint32_t philoxMultiplier0 = 0xD2511F53;
+const std::uint32_t philoxMultiplier1 = 0xCD9E8D57;
+const std::uint32_t philoxWeyl0 = 0x9E3779B9;
+const std::uint32_t philoxWeyl1 = 0xBB67AE85;
+const int philoxRounds = 10;
+
+// Calls of the generator per sample: the first few cover the degree questions, the rest
+// the major questions, four answers to a call.
+const std::uint32_t degreeCalls = (degreeQuestionCount + 3) / 4;
+const std::uint32_t majorCalls = (majorOutcomeQuestionLimit + 3) / 4;
+
+// z for a two-sided 95% interval.
+const double confidenceZ = 1.959963984540054;
+
+void Philox4x32(const std::uint32_t counter[4], std::uint64_t key, std::uint32_t result[4])
+{
+    std::uint32_t c0 = counter[0];
+    std::uint32_t c1 = counter[1];
+    std::uint32_t c2 = counter[2];
+    std::uint32_t c3 = counter[3];
+    std::uint32_t k0 = static_cast<std::uint32_t>(key);
+    std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+    for (int round = 0; round < philoxRounds; ++round) {
+        const std::uint64_t product0 = std::uint64_t(philoxMultiplier0) * c0;
+        const std::uint64_t product1 = std::uint64_t(philoxMultiplier1) * c2;
+        c0 = static_cast<std::uint32_t>(product1 >> 32) ^ c1 ^ k0;
+        c2 = static_cast<std::uint32_t>(product0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<std::uint32_t>(product1);
+        c3 = static_cast<std::uint32_t>(product0);
+        k0 += philoxWeyl0;
+        k1 += philoxWeyl1;
+    }
+    result[0] = c0;
+    result[1] = c1;
+    result[2] = c2;
+    result[3] = c3;
+}
+
+// Philox4x32 for simulationLanes samples from `first` at once: words[w][i] is word w of
+// call `call` for sample first + i. The same arithmetic as Philox4x32, a lane at a time.
+void PhiloxLanes(std::uint64_t first, std::uint32_t call, std::uint64_t key, std::uint32_t words[4][simulationLanes])
+{
+    std::uint32_t* c0 = words[0];
+    std::uint32_t* c1 = words[1];
+    std::uint32_t* c2 = words[2];
+    std::uint32_t* c3 = words[3];
+    for (std::size_t i = 0; i < simulationLanes; ++i) {
+        c0[i] = static_cast<std::uint32_t>(first + i);
+        c1[i] = static_cast<std::uint32_t>((first + i) >> 32);
+        c2[i] = call;
+        c3[i] = 0;
+    }
+    std::uint32_t k0 = static_cast<std::uint32_t>(key);
+    std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+    for (int round = 0; round < philoxRounds; ++round) {
+        for (std::size_t i = 0; i < simulationLanes; ++i) {
+            const std::uint64_t product0 = std::uint64_t(philoxMultiplier0) * c0[i];
+            const std::uint64_t product1 = std::uint64_t(philoxMultiplier1) * c2[i];
+            c0[i] = static_cast<std::uint32_t>(product1 >> 32) ^ c1[i] ^ k0;
+            c2[i] = static_cast<std::uint32_t>(product0 >> 32) ^ c3[i] ^ k1;
+            c1[i] = static_cast<std::uint32_t>(product1);
+            c3[i] = static_cast<std::uint32_t>(product0);
+        }
+        k0 += philoxWeyl0;
+        k1 += philoxWeyl1;
+    }
+}
+
+bool SimulationSetup::Prepare(const DegreeWeights& weights, const MajorRanking& ranking, std::string& error)
+{
+    if (degreeProbabilities.empty()) {
+        degreeProbabilities.assign(degreeQuestionCount, 0.5);
+    }
+    if (majorProbabilities.empty()) {
+        majorProbabilities.assign(ranking.QuestionCount(), 0.5);
+    }
+    if (degreeProbabilities.size() != static_cast<std::size_t>(degreeQuestionCount) ||
+        majorProbabilities.size() != ranking.QuestionCount()) {
+        error = "expected " + std::to_string(degreeQuestionCount) + " probabilities, or " +
+            std::to_string(degreeQuestionCount + ranking.QuestionCount()) + " with the major questions";
+        return false;
+    }
+    // A draw is a 32-bit word, so probability p is "below p * 2^32", which 1 always is.
+    auto threshold = [](double p) { return static_cast<std::uint64_t>(std::llround(p * 4294967296.0)); };
+    degreeThresholds.clear();
+    majorThresholds.clear();
+    for (const double p : degreeProbabilities) {
+        if (!(p >= 0 && p <= 1)) {
+            error = "probabilities must be between 0 and 1";
+            return false;
+        }
+        degreeThresholds.push_back(threshold(p));
+    }
+    for (const double p : majorProbabilities) {
+        if (!(p >= 0 && p <= 1)) {
+            error = "probabilities must be between 0 and 1";
+            return false;
+        }
+        majorThresholds.push_back(threshold(p));
+    }
+
+    degreeMajors.clear();
+    majorQuestionFirst.clear();
+    majorQuestionCount.clear();
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        const auto majors = ranking.DegreeMajors(weights.CatalogId(d));
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+        if (majors.first != majors.second) {
+            first = ranking.MajorQuestions(majors.first).first;
+            count = ranking.MajorQuestions(static_cast<std::uint16_t>(majors.second - 1)).second - first;
+        }
+        if (count > majorOutcomeQuestionLimit) {
+            error = weights.DegreeName(d) + " has more than " + std::to_string(majorOutcomeQuestionLimit) + " major questions";
+            return false;
+        }
+        degreeMajors.push_back(majors);
+        majorQuestionFirst.push_back(first);
+        majorQuestionCount.push_back(count);
+    }
+    return true;
+}
+
+void SimulationCounts::Reset(const SimulationSetup& setup)
+{
+    degreeMasks.assign(degreeAnswerCount, 0);
+    majorMasks.resize(setup.majorQuestionCount.size());
+    for (std::size_t d = 0; d < majorMasks.size(); ++d) {
+        majorMasks[d].assign(std::size_t(1) << setup.majorQuestionCount[d], 0);
+    }
+}
+
+void SimulationCounts::Add(const SimulationCounts& other)
+{
+    for (std::size_t m = 0; m < degreeMasks.size(); ++m) {
+        degreeMasks[m] += other.degreeMasks[m];
+    }
+    for (std::size_t d = 0; d < majorMasks.size(); ++d) {
+        for (std::size_t m = 0; m < majorMasks[d].size(); ++m) {
+            majorMasks[d][m] += other.majorMasks[d][m];
+        }
+    }
+}
+
+void SimulateSamples(const SimulationSetup& setup, const DegreeWeights& weights, std::uint64_t first,
+    std::uint64_t count, SimulationCounts& counts)
+{
+    std::uint32_t degreeWords[degreeCalls][4][simulationLanes];
+    std::uint32_t majorWords[majorCalls][4][simulationLanes];
+    AnswerMask masks[simulationLanes];
+    std::uint32_t callsNeeded = 0;
+    for (const std::uint32_t questions : setup.majorQuestionCount) {
+        callsNeeded = std::max(callsNeeded, (questions + 3) / 4);
+    }
+
+    for (std::uint64_t batch = 0; batch < count; batch += simulationLanes) {
+        const std::uint64_t start = first + batch;
+        const std::size_t lanes = static_cast<std::size_t>(std::min<std::uint64_t>(simulationLanes, count - batch));
+        for (std::uint32_t call = 0; call < degreeCalls; ++call) {
+            PhiloxLanes(start, call, setup.seed, degreeWords[call]);
+        }
+        for (std::uint32_t call = 0; call < callsNeeded; ++call) {
+            PhiloxLanes(start, degreeCalls + call, setup.seed, majorWords[call]);
+        }
+        for (std::size_t i = 0; i < simulationLanes; ++i) {
+            masks[i] = 0;
+        }
+        for (int k = 0; k < degreeQuestionCount; ++k) {
+            const std::uint32_t* words = degreeWords[k / 4][k % 4];
+            const std::uint64_t threshold = setup.degreeThresholds[k];
+            for (std::size_t i = 0; i < simulationLanes; ++i) {
+                masks[i] |= static_cast<AnswerMask>(static_cast<AnswerMask>(words[i] < threshold) << k);
+            }
+        }
+
+        for (std::size_t i = 0; i < lanes; ++i) {
+            counts.degreeMasks[masks[i]]++;
+            const DegreeOutcome& outcome = weights.Outcome(masks[i]);
+            if (outcome.fallback != OutcomeFallback::None) {
+                continue;
+            }
+            const std::size_t degree = outcome.recommended;
+            const std::uint32_t questions = setup.majorQuestionCount[degree];
+            if (questions == 0) {
+                continue;
+            }
+            const std::uint64_t* thresholds = setup.majorThresholds.data() + setup.majorQuestionFirst[degree];
+            std::uint32_t majorMask = 0;
+            for (std::uint32_t q = 0; q < questions; ++q) {
+                majorMask |= static_cast<std::uint32_t>(majorWords[q / 4][q % 4][i] < thresholds[q]) << q;
+            }
+            counts.majorMasks[degree][majorMask]++;
+        }
+    }
+}
+
+// A share of `total` with its Wilson score interval, and the exact value.
+void PrintShare(const std::string& label, std::uint64_t hits, std::uint64_t total, double exact)
+{
+    const double n = static_cast<double>(total);
+    const double p = total ? hits / n : 0.0;
+    double low = 0;
+    double high = 0;
+    if (total) {
+        const double z2 = confidenceZ * confidenceZ;
+        const double centre = (p + z2 / (2 * n)) / (1 + z2 / n);
+        const double half = confidenceZ / (1 + z2 / n) * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n));
+        low = std::max(0.0, centre - half);
+        high = std::min(1.0, centre + half);
+    }
+    std::cout << "  " << std::left << std::setw(36) << label << std::right << std::fixed << std::setprecision(6)
+        << std::setw(10) << p << "  [" << low << ", " << high << "]  " << exact << "\n";
+}
+
+void PrintShareHeader(const std::string& title)
+{
+    std::cout << "\n" << title << "\n  " << std::left << std::setw(36) << "" << std::right << std::setw(10) << "share"
+        << "  95% CI" << std::setw(22) << "exact" << "\n";
+}
+
+// Probability of answer mask `mask` over `count` questions answered independently.
+double MaskProbability(std::uint32_t mask, const double* probabilities, std::uint32_t count)
+{
+    double probability = 1;
+    for (std::uint32_t q = 0; q < count; ++q) {
+        probability *= (mask >> q) & 1 ? probabilities[q] : 1 - probabilities[q];
+    }
+    return probability;
+}
+
+// The outcome as one number, so two can be compared: a degree or major index, or past
+// them a fallback.
+std::size_t OutcomeKey(std::size_t chosen, OutcomeFallback fallback, std::size_t choices)
+{
+    return fallback == OutcomeFallback::None ? chosen : choices + static_cast<std::size_t>(fallback);
+}
+
+void PrintDegreeReport(const SimulationSetup& setup, const DegreeWeights& weights, const SimulationCounts& counts,
+    std::uint64_t samples)
+{
+    const std::size_t degreeCount = weights.DegreeCount();
+    std::vector<std::uint64_t> outcomes(degreeCount + 3, 0);
+    std::vector<double> exactOutcomes(degreeCount + 3, 0);
+    std::uint64_t ties = 0;
+    double exactTies = 0;
+    std::vector<std::uint64_t> pivotal(degreeQuestionCount, 0);
+    std::vector<double> exactPivotal(degreeQuestionCount, 0);
+    std::vector<int> scores(weights.Stride());
+
+    for (std::uint32_t mask = 0; mask < degreeAnswerCount; ++mask) {
+        const std::uint64_t hits = counts.degreeMasks[mask];
+        const double probability = MaskProbability(mask, setup.degreeProbabilities.data(), degreeQuestionCount);
+        const DegreeOutcome& outcome = weights.Outcome(static_cast<AnswerMask>(mask));
+        const std::size_t key = OutcomeKey(outcome.recommended, outcome.fallback, degreeCount);
+        outcomes[key] += hits;
+        exactOutcomes[key] += probability;
+
+        weights.Score(static_cast<AnswerMask>(mask), scores.data());
+        const int best = *std::max_element(scores.begin(), scores.begin() + degreeCount);
+        if (outcome.fallback == OutcomeFallback::None && std::count(scores.begin(), scores.begin() + degreeCount, best) > 1) {
+            ties += hits;
+            exactTies += probability;
+        }
+        for (int k = 0; k < degreeQuestionCount; ++k) {
+            const DegreeOutcome& flipped = weights.Outcome(static_cast<AnswerMask>(mask ^ (1u << k)));
+            if (OutcomeKey(flipped.recommended, flipped.fallback, degreeCount) != key) {
+                pivotal[k] += hits;
+                exactPivotal[k] += probability;
+            }
+        }
+    }
+
+    PrintShareHeader("Degree outcomes over " + std::to_string(samples) + " samples");
+    for (std::size_t d = 0; d < degreeCount; ++d) {
+        PrintShare(weights.DegreeName(d), outcomes[d], samples, exactOutcomes[d]);
+    }
+    PrintShare("all no (student picks)", outcomes[degreeCount + static_cast<std::size_t>(OutcomeFallback::AllNo)],
+        samples, exactOutcomes[degreeCount + static_cast<std::size_t>(OutcomeFallback::AllNo)]);
+    PrintShare("all yes (student picks)", outcomes[degreeCount + static_cast<std::size_t>(OutcomeFallback::AllYes)],
+        samples, exactOutcomes[degreeCount + static_cast<std::size_t>(OutcomeFallback::AllYes)]);
+    PrintShare("decided by the tie rule", ties, samples, exactTies);
+    std::cout << "Degree answers that alone change the outcome\n";
+    for (int k = 0; k < degreeQuestionCount; ++k) {
+        PrintShare("question " + std::to_string(k + 1) + " (yes " + std::to_string(setup.degreeProbabilities[k]).substr(0, 4) + ")",
+            pivotal[k], samples, exactPivotal[k]);
+    }
+}
+
+// Major outcomes among the samples each degree was recommended to. Major answers are drawn
+// apart from degree answers, so the exact values need no conditioning on the degree.
+void PrintMajorReport(const SimulationSetup& setup, const DegreeWeights& weights, const MajorRanking& ranking,
+    const SimulationCounts& counts)
+{
+    for (std::size_t d = 0; d < setup.degreeMajors.size(); ++d) {
+        const std::uint32_t questions = setup.majorQuestionCount[d];
+        if (questions == 0) {
+            continue;
+        }
+        const auto majors = setup.degreeMajors[d];
+        const std::size_t majorCount = majors.second - majors.first;
+        const double* probabilities = setup.majorProbabilities.data() + setup.majorQuestionFirst[d];
+        std::uint64_t samples = 0;
+        for (const std::uint64_t hits : counts.majorMasks[d]) {
+            samples += hits;
+        }
+        std::vector<std::uint64_t> outcomes(majorCount + 3, 0);
+        std::vector<double> exactOutcomes(majorCount + 3, 0);
+        std::uint64_t ties = 0;
+        double exactTies = 0;
+        std::vector<std::uint64_t> pivotal(questions, 0);
+        std::vector<double> exactPivotal(questions, 0);
+        std::vector<int> scores(majorCount);
+
+        for (std::uint32_t mask = 0; mask < (1u << questions); ++mask) {
+            const std::uint64_t hits = counts.majorMasks[d][mask];
+            const double probability = MaskProbability(mask, probabilities, questions);
+            const MajorOutcome outcome = ranking.Outcome(majors, mask);
+            const std::size_t key = OutcomeKey(outcome.major - majors.first, outcome.fallback, majorCount);
+            outcomes[key] += hits;
+            exactOutcomes[key] += probability;
+
+            std::fill(scores.begin(), scores.end(), 0);
+            for (std::uint16_t m = majors.first; m < majors.second; ++m) {
+                const auto range = ranking.MajorQuestions(m);
+                for (std::uint32_t q = range.first; q < range.second; ++q) {
+                    scores[m - majors.first] += (mask >> (q - setup.majorQuestionFirst[d])) & 1 ? ranking.QuestionWeight(q) : 0;
+                }
+            }
+            const int best = *std::max_element(scores.begin(), scores.end());
+            if (outcome.fallback == OutcomeFallback::None && std::count(scores.begin(), scores.end(), best) > 1) {
+                ties += hits;
+                exactTies += probability;
+            }
+            for (std::uint32_t q = 0; q < questions; ++q) {
+                const MajorOutcome flipped = ranking.Outcome(majors, mask ^ (1u << q));
+                if (OutcomeKey(flipped.major - majors.first, flipped.fallback, majorCount) != key) {
+                    pivotal[q] += hits;
+                    exactPivotal[q] += probability;
+                }
+            }
+        }
+
+        PrintShareHeader("Major outcomes among " + std::to_string(samples) + " samples recommended " + weights.DegreeName(d));
+        for (std::size_t m = 0; m < majorCount; ++m) {
+            PrintShare(std::string(ranking.MajorName(static_cast<std::uint16_t>(majors.first + m))), outcomes[m], samples,
+                exactOutcomes[m]);
+        }
+        PrintShare("all no (student picks)", outcomes[majorCount + static_cast<std::size_t>(OutcomeFallback::AllNo)],
+            samples, exactOutcomes[majorCount + static_cast<std::size_t>(OutcomeFallback::AllNo)]);
+        PrintShare("all yes (student picks)", outcomes[majorCount + static_cast<std::size_t>(OutcomeFallback::AllYes)],
+            samples, exactOutcomes[majorCount + static_cast<std::size_t>(OutcomeFallback::AllYes)]);
+        PrintShare("decided by the tie rule", ties, samples, exactTies);
+        std::cout << "Major answers that alone change the outcome\n";
+        for (std::uint32_t q = 0; q < questions; ++q) {
+            PrintShare("question " + std::to_string(setup.majorQuestionFirst[d] + q + 1) + " (yes " +
+                std::to_string(probabilities[q]).substr(0, 4) + ")", pivotal[q], samples, exactPivotal[q]);
+        }
+    }
+}
+
+int RunSimulation(std::uint64_t samples, std::uint64_t seed, int threadCount, const std::string& probabilities)
+{
+    const DegreeWeights& weights = ActiveDegreeWeights();
+    const MajorRanking& ranking = GetMajorRanking();
+    SimulationSetup setup;
+    setup.seed = seed;
+    std::size_t begin = 0;
+    while (begin < probabilities.size()) {
+        const std::size_t comma = std::min(probabilities.find(',', begin), probabilities.size());
+        const std::string field = probabilities.substr(begin, comma - begin);
+        char* end = nullptr;
+        const double value = std::strtod(field.c_str(), &end);
+        if (field.empty() || *end != '\0') {
+            std::cerr << "\"" << field << "\" is not a probability\n";
+            return 1;
+        }
+        if (setup.degreeProbabilities.size() < static_cast<std::size_t>(degreeQuestionCount)) {
+            setup.degreeProbabilities.push_back(value);
+        }
+        else {
+            setup.majorProbabilities.push_back(value);
+        }
+        begin = comma + 1;
+    }
+    std::string error;
+    if (!setup.Prepare(weights, ranking, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    threadCount = std::max(1, threadCount);
+    const std::uint64_t blocks = (samples + simulationBlockSamples - 1) / simulationBlockSamples;
+    std::atomic<std::uint64_t> nextBlock(0);
+    std::mutex totalMutex;
+    SimulationCounts total;
+    total.Reset(setup);
+    const auto started = std::chrono::steady_clock::now();
+    {
+        // Each worker takes blocks in turn; the counts add up the same in any order.
+        WorkStealingPool pool(threadCount);
+        for (int t = 0; t < threadCount; ++t) {
+            pool.Submit([&]() {
+                SimulationCounts local;
+                local.Reset(setup);
+                for (std::uint64_t block = nextBlock++; block < blocks; block = nextBlock++) {
+                    const std::uint64_t first = block * simulationBlockSamples;
+                    SimulateSamples(setup, weights, first, std::min(simulationBlockSamples, samples - first), local);
+                }
+                std::lock_guard<std::mutex> lock(totalMutex);
+                total.Add(local);
+            });
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::cout << "samples=" << samples << " seed=" << seed << " threads=" << threadCount << std::fixed
+        << std::setprecision(3) << " seconds=" << seconds
+        << " samples_per_second=" << std::setprecision(0) << (seconds > 0 ? samples / seconds : 0.0) << "\n";
+    std::cout << "Shares are of the samples shown, with 95% Wilson intervals; exact is worked out from every\n"
+        << "answer mask's probability, answers being independent.\n";
+    PrintDegreeReport(setup, weights, total, samples);
+    PrintMajorReport(setup, weights, ranking, total);
+    return 0;
+}
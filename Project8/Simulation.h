@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Advisor.h"
+#include "MajorRanking.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Monte Carlo sensitivity analysis of the recommendation weights: students are drawn
+// answering "yes" to each question with its own probability, and the report shows how
+// often each degree and major comes out, how often the tie rule decides, and how often
+// each answer is pivotal (flipping it alone would change the outcome).
+//
+// Sample n's answers come from a counter-based generator keyed by the seed and indexed by
+// n, so a run is reproducible from its seed whatever the thread count or block order.
+// Every degree answer mask is scored once up front, as is every answer mask of each
+// degree's major questions, so a sample costs its random draws and a table lookup; the
+// draws and the masks they make are computed a batch of lanes at a time so they vectorize.
+
+// Samples are handed out in blocks of this many.
+const std::uint64_t simulationBlockSamples = std::uint64_t(1) << 20;
+// Samples whose random draws are computed together.
+const std::size_t simulationLanes = 64;
+
+// Philox4x32-10: four 32-bit random words from a 128-bit counter and a 64-bit key.
+void Philox4x32(const std::uint32_t counter[4], std::uint64_t key, std::uint32_t result[4]);
+
+struct SimulationSetup
+{
+    std::uint64_t seed = 1;
+    // Probability of "yes" to each degree question, then to each GetMajorRanking() question.
+    std::vector<double> degreeProbabilities;
+    std::vector<double> majorProbabilities;
+
+    // Derived by Prepare.
+    std::vector<std::uint64_t> degreeThresholds;  // "yes" when a draw is below this
+    std::vector<std::uint64_t> majorThresholds;
+    // For each degree with majors: its majors, its first question and how many it has.
+    std::vector<std::pair<std::uint16_t, std::uint16_t>> degreeMajors;
+    std::vector<std::uint32_t> majorQuestionFirst;
+    std::vector<std::uint32_t> majorQuestionCount;
+
+    // Fills the thresholds and major ranges; false if a probability is out of range or a
+    // degree has more major questions than an outcome table covers.
+    bool Prepare(const DegreeWeights& weights, const MajorRanking& ranking, std::string& error);
+};
+
+// How many samples landed on each answer mask: degree masks, and for each degree the
+// masks of its major questions among the samples it was recommended to.
+struct SimulationCounts
+{
+    std::vector<std::uint64_t> degreeMasks;
+    std::vector<std::vector<std::uint64_t>> majorMasks;
+
+    void Reset(const SimulationSetup& setup);
+    void Add(const SimulationCounts& other);
+};
+
+// Draws samples [first, first + count) and counts their masks into `counts`.
+void SimulateSamples(const SimulationSetup& setup, const DegreeWeights& weights, std::uint64_t first,
+    std::uint64_t count, SimulationCounts& counts);
+
+// Runs `samples` samples on `threadCount` threads and prints the report. `probabilities`
+// is empty for 0.5 everywhere, or comma-separated values: one per degree question,
+// optionally followed by one per --rank-majors question.
+int RunSimulation(std::uint64_t samples, std::uint64_t seed, int threadCount, const std::string& probabilities);
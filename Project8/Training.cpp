@@ -0,0 +1,727 @@
+#include "Training.h"
+
+#include "Advisor.h"
+#include "Cohort.h"
+#include "MajorRanking.h"
+#include "MappedFile.h"
+#include "WorkPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string_view>
+
+// Records are cut into chunks at the first line end past this many bytes.
+const std::size_t trainingChunkBytes = std::size_t(1) << 20;
+// Rejected records reported by line; the rest are only counted.
+const std::size_t trainingErrorLimit = 10;
+// The fit stops once the gradient is this small, or after this many steps.
+const double softmaxTolerance = 1e-7;
+const int softmaxIterationLimit = 10000;
+
+// What every task shares: the tables records are checked against.
+struct TrainingContext
+{
+    std::string_view text;
+    const DegreeWeights* weights;
+    const MajorRanking* ranking;
+    std::size_t answerCount;  // degree questions, then every major question
+    // For each degree: its majors, and the first and number of their questions; no
+    // questions when it has none or too many to count every combination of.
+    std::vector<std::pair<std::uint16_t, std::uint16_t>> degreeMajors;
+    std::vector<std::uint32_t> majorQuestionFirst;
+    std::vector<std::uint32_t> majorQuestionCount;
+};
+
+// Students per answer mask and outcome: degrees x degree masks, and for each degree its
+// majors x masks of its major questions.
+struct TrainingCounts
+{
+    std::vector<std::uint64_t> degrees;
+    std::vector<std::vector<std::uint64_t>> majors;
+    std::uint64_t records = 0;
+    std::uint64_t skipped = 0;
+
+    void Reset(const TrainingContext& context)
+    {
+        degrees.assign(degreeAnswerCount * context.weights->DegreeCount(), 0);
+        majors.resize(context.degreeMajors.size());
+        for (std::size_t d = 0; d < majors.size(); ++d) {
+            const std::size_t majorCount = context.degreeMajors[d].second - context.degreeMajors[d].first;
+            majors[d].assign(context.majorQuestionCount[d] ? (std::size_t(1) << context.majorQuestionCount[d]) * majorCount : 0, 0);
+        }
+        records = 0;
+        skipped = 0;
+    }
+
+    void Add(const TrainingCounts& other)
+    {
+        for (std::size_t i = 0; i < degrees.size(); ++i) {
+            degrees[i] += other.degrees[i];
+        }
+        for (std::size_t d = 0; d < majors.size(); ++d) {
+            for (std::size_t i = 0; i < majors[d].size(); ++i) {
+                majors[d][i] += other.majors[d][i];
+            }
+        }
+        records += other.records;
+        skipped += other.skipped;
+    }
+};
+
+struct TrainingError
+{
+    std::uint64_t line;  // within the chunk, from 0
+    std::string message;
+};
+
+struct TrainingChunk
+{
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::uint64_t lines = 0;
+    std::uint64_t rejected = 0;
+    std::vector<TrainingError> errors;  // the first trainingErrorLimit rejected records
+};
+
+// The field of `line` starting at `next`, unquoted, and where the one after it starts.
+bool ReadTrainingField(std::string_view line, std::size_t& next, std::string& field)
+{
+    std::string_view raw;
+    std::size_t after = 0;
+    if (!SplitCohortId(line.substr(next), raw, after)) {
+        return false;
+    }
+    next = after == std::string_view::npos ? std::string_view::npos : next + after;
+    field.clear();
+    if (raw.empty() || raw.front() != '"') {
+        field.assign(raw);
+        return true;
+    }
+    for (std::size_t i = 1; i + 1 < raw.size(); ++i) {
+        field += raw[i];
+        i += raw[i] == '"';
+    }
+    return true;
+}
+
+// Counts one record; false with `error` set, and nothing counted, if it is malformed.
+bool ParseTrainingRow(const TrainingContext& context, std::string_view line, std::vector<std::uint64_t>& words,
+    TrainingCounts& counts, std::string& error)
+{
+    auto fieldsExpected = [&context]() {
+        return "expected " + std::to_string(context.answerCount + 3) +
+            " fields: the ID, the answers, and the degree and major finished";
+    };
+    std::string_view id;
+    std::size_t next = 0;
+    if (!SplitCohortId(line, id, next)) {
+        error = "unterminated quoted student ID";
+        return false;
+    }
+    std::fill(words.begin(), words.end(), 0);
+    AnswerMask degreeAnswers = 0;
+    for (std::size_t a = 0; a < context.answerCount; ++a) {
+        if (next == std::string_view::npos) {
+            error = fieldsExpected();
+            return false;
+        }
+        const std::size_t comma = line.find(',', next);
+        const std::size_t end = comma == std::string_view::npos ? line.size() : comma;
+        bool yes = false;
+        if (!ParseCohortAnswer(line.substr(next, end - next), yes)) {
+            error = "field " + std::to_string(a + 2) + " is not y, n, 1 or 0";
+            return false;
+        }
+        if (a < static_cast<std::size_t>(degreeQuestionCount)) {
+            degreeAnswers |= static_cast<AnswerMask>(yes) << a;
+        }
+        else {
+            const std::size_t question = a - degreeQuestionCount;
+            words[question / 64] |= static_cast<std::uint64_t>(yes) << (question % 64);
+        }
+        next = comma == std::string_view::npos ? std::string_view::npos : comma + 1;
+    }
+    std::string degreeName;
+    std::string majorName;
+    if (next == std::string_view::npos || !ReadTrainingField(line, next, degreeName) ||
+        next == std::string_view::npos || !ReadTrainingField(line, next, majorName) || next != std::string_view::npos) {
+        error = fieldsExpected();
+        return false;
+    }
+    if (degreeName.empty()) {
+        counts.skipped++;
+        return true;
+    }
+    const DegreeWeights& weights = *context.weights;
+    std::size_t degree = 0;
+    while (degree < weights.DegreeCount() && weights.DegreeName(degree) != degreeName) {
+        degree++;
+    }
+    if (degree == weights.DegreeCount()) {
+        error = "unknown degree \"" + degreeName + "\"";
+        return false;
+    }
+    if (!majorName.empty()) {
+        const auto majors = context.degreeMajors[degree];
+        std::uint16_t major = majors.first;
+        while (major < majors.second && context.ranking->MajorName(major) != majorName) {
+            major++;
+        }
+        if (major == majors.second) {
+            error = "\"" + majorName + "\" is not a major of " + degreeName;
+            return false;
+        }
+        const std::uint32_t first = context.majorQuestionFirst[degree];
+        const std::uint32_t questions = context.majorQuestionCount[degree];
+        if (questions) {
+            const std::uint64_t mask = CohortAnswerRange(words.data(), first, first + questions);
+            counts.majors[degree][mask * (majors.second - majors.first) + (major - majors.first)]++;
+        }
+    }
+    counts.degrees[std::size_t(degreeAnswers) * weights.DegreeCount() + degree]++;
+    counts.records++;
+    return true;
+}
+
+void ParseTrainingChunk(const TrainingContext& context, TrainingChunk& chunk, TrainingCounts& counts)
+{
+    std::vector<std::uint64_t> words(context.ranking->AnswerWords());
+    std::string error;
+    std::size_t offset = chunk.begin;
+    while (offset < chunk.end) {
+        std::size_t end = context.text.find('\n', offset);
+        end = end == std::string_view::npos || end > chunk.end ? chunk.end : end;
+        std::string_view line = context.text.substr(offset, end - offset);
+        offset = end + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        chunk.lines++;
+        if (line.empty() || ParseTrainingRow(context, line, words, counts, error)) {
+            continue;
+        }
+        if (chunk.errors.size() < trainingErrorLimit) {
+            chunk.errors.push_back({ chunk.lines - 1, error });
+        }
+        chunk.rejected++;
+    }
+}
+
+// The problem turned around for the fit: counts and scores are one column per class, and
+// each answer is a column of 0s and 1s over masks, so every loop below runs down a column
+// and vectorizes.
+struct SoftmaxFitter
+{
+    explicit SoftmaxFitter(const SoftmaxProblem& problem)
+        : problem(problem), masks(std::size_t(1) << problem.features), students(0)
+    {
+        const std::size_t classes = problem.classes;
+        counts.assign(classes * masks, 0);
+        totals.assign(masks, 0);
+        for (std::size_t m = 0; m < masks; ++m) {
+            for (std::size_t c = 0; c < classes; ++c) {
+                const double count = static_cast<double>(problem.counts[m * classes + c]);
+                counts[c * masks + m] = count;
+                totals[m] += count;
+            }
+            students += totals[m];
+        }
+        answers.assign(problem.features * masks, 0);
+        for (std::size_t k = 0; k < problem.features; ++k) {
+            for (std::size_t m = 0; m < masks; ++m) {
+                answers[k * masks + m] = static_cast<double>((m >> k) & 1);
+            }
+        }
+        scores.resize(classes * masks);
+        top.resize(masks);
+        sums.resize(masks);
+    }
+
+    // The objective at `weights`, with its gradient.
+    double Evaluate(const std::vector<double>& weights, std::vector<double>& gradient)
+    {
+        const std::size_t classes = problem.classes;
+        std::fill(scores.begin(), scores.end(), 0.0);
+        for (std::size_t c = 0; c < classes; ++c) {
+            double* score = scores.data() + c * masks;
+            for (std::size_t k = 0; k < problem.features; ++k) {
+                const double weight = weights[k * classes + c];
+                const double* answer = answers.data() + k * masks;
+                for (std::size_t m = 0; m < masks; ++m) {
+                    score[m] += answer[m] * weight;
+                }
+            }
+        }
+
+        double loss = 0;
+        std::fill(top.begin(), top.end(), -std::numeric_limits<double>::infinity());
+        for (std::size_t c = 0; c < classes; ++c) {
+            const double* score = scores.data() + c * masks;
+            const double* count = counts.data() + c * masks;
+            for (std::size_t m = 0; m < masks; ++m) {
+                loss -= count[m] * score[m];
+                top[m] = std::max(top[m], score[m]);
+            }
+        }
+        std::fill(sums.begin(), sums.end(), 0.0);
+        for (std::size_t c = 0; c < classes; ++c) {
+            double* score = scores.data() + c * masks;
+            for (std::size_t m = 0; m < masks; ++m) {
+                score[m] = std::exp(score[m] - top[m]);
+                sums[m] += score[m];
+            }
+        }
+        for (std::size_t m = 0; m < masks; ++m) {
+            loss += totals[m] * (top[m] + std::log(sums[m]));
+        }
+        // Each score becomes its residual: students expected in the class less those in it.
+        for (std::size_t c = 0; c < classes; ++c) {
+            double* score = scores.data() + c * masks;
+            const double* count = counts.data() + c * masks;
+            for (std::size_t m = 0; m < masks; ++m) {
+                score[m] = totals[m] * score[m] / sums[m] - count[m];
+            }
+        }
+
+        double penalty = 0;
+        for (std::size_t k = 0; k < problem.features; ++k) {
+            const double* answer = answers.data() + k * masks;
+            for (std::size_t c = 0; c < classes; ++c) {
+                const std::size_t i = k * classes + c;
+                if (!problem.free[i]) {
+                    gradient[i] = 0;
+                    continue;
+                }
+                const double* residual = scores.data() + c * masks;
+                double sum = 0;
+                for (std::size_t m = 0; m < masks; ++m) {
+                    sum += answer[m] * residual[m];
+                }
+                gradient[i] = sum / students + trainingPenalty * weights[i];
+                penalty += weights[i] * weights[i];
+            }
+        }
+        return loss / students + trainingPenalty / 2 * penalty;
+    }
+
+    const SoftmaxProblem& problem;
+    std::size_t masks;
+    double students;
+    std::vector<double> counts;
+    std::vector<double> totals;
+    std::vector<double> answers;
+    std::vector<double> scores;
+    std::vector<double> top;
+    std::vector<double> sums;
+};
+
+double FitSoftmax(const SoftmaxProblem& problem, std::vector<double>& weights, int& iterations)
+{
+    SoftmaxFitter fitter(problem);
+    const std::size_t size = problem.features * problem.classes;
+    weights.assign(size, 0);
+    iterations = 0;
+    if (fitter.students == 0) {
+        return 0;
+    }
+    std::vector<double> gradient(size);
+    std::vector<double> nextWeights(size);
+    std::vector<double> nextGradient(size);
+    double loss = fitter.Evaluate(weights, gradient);
+    double step = 1;
+    // Gradient descent with Barzilai-Borwein steps, halved until the loss falls enough.
+    for (; iterations < softmaxIterationLimit; ++iterations) {
+        double norm = 0;
+        for (const double g : gradient) {
+            norm += g * g;
+        }
+        if (std::sqrt(norm) < softmaxTolerance) {
+            break;
+        }
+        double nextLoss = 0;
+        while (true) {
+            for (std::size_t i = 0; i < size; ++i) {
+                nextWeights[i] = weights[i] - step * gradient[i];
+            }
+            nextLoss = fitter.Evaluate(nextWeights, nextGradient);
+            if (nextLoss <= loss - 1e-4 * step * norm || step < 1e-12) {
+                break;
+            }
+            step /= 2;
+        }
+        double moved = 0;
+        double curvature = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            const double s = nextWeights[i] - weights[i];
+            moved += s * s;
+            curvature += s * (nextGradient[i] - gradient[i]);
+        }
+        step = curvature > 0 ? moved / curvature : 1;
+        weights.swap(nextWeights);
+        gradient.swap(nextGradient);
+        loss = nextLoss;
+    }
+    return loss;
+}
+
+// The share of students whose recommendation is the degree they finished; a fallback
+// matches none.
+double DegreeAgreement(const DegreeWeights& weights, const std::vector<std::uint64_t>& counts, std::uint64_t records)
+{
+    std::uint64_t matched = 0;
+    for (std::size_t mask = 0; mask < degreeAnswerCount; ++mask) {
+        const DegreeOutcome& outcome = weights.Outcome(static_cast<AnswerMask>(mask));
+        if (outcome.fallback == OutcomeFallback::None) {
+            matched += counts[mask * weights.DegreeCount() + outcome.recommended];
+        }
+    }
+    return records ? 100.0 * matched / records : 0.0;
+}
+
+double MajorAgreement(const MajorRanking& ranking, std::pair<std::uint16_t, std::uint16_t> majors,
+    std::uint32_t questions, const std::vector<std::uint64_t>& counts, std::uint64_t records)
+{
+    const std::size_t majorCount = majors.second - majors.first;
+    std::uint64_t matched = 0;
+    for (std::uint64_t mask = 0; mask < (std::uint64_t(1) << questions); ++mask) {
+        const MajorOutcome outcome = ranking.Outcome(majors, mask);
+        if (outcome.fallback == OutcomeFallback::None) {
+            matched += counts[mask * majorCount + (outcome.major - majors.first)];
+        }
+    }
+    return records ? 100.0 * matched / records : 0.0;
+}
+
+// `weights` scaled so the largest in magnitude is trainedWeightScale, and rounded.
+std::vector<long long> ScaleTrainedWeights(const std::vector<double>& weights)
+{
+    double largest = 0;
+    for (const double weight : weights) {
+        largest = std::max(largest, std::abs(weight));
+    }
+    std::vector<long long> scaled;
+    for (const double weight : weights) {
+        scaled.push_back(largest > 0 ? std::llround(weight / largest * trainedWeightScale) : 0);
+    }
+    return scaled;
+}
+
+bool SaveTrainedWeights(const std::string& path, const std::string& text, std::string& error)
+{
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(text.data(), static_cast<std::streamsize>(text.size())) || !file.flush()) {
+            error = "cannot write " + temporary;
+            return false;
+        }
+    }
+    return RenameOver(temporary, path, error);
+}
+
+int TrainWeights(const std::string& recordsPath, const std::string& degreeWeightsPath,
+    const std::string& majorWeightsPath, int threadCount)
+{
+    MappedFile input;
+    std::string error;
+    if (!input.Open(recordsPath, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    TrainingContext context;
+    context.text = input.View();
+    context.weights = &ActiveDegreeWeights();
+    context.ranking = &GetMajorRanking();
+    context.answerCount = degreeQuestionCount + context.ranking->QuestionCount();
+    const DegreeWeights& weights = *context.weights;
+    const MajorRanking& ranking = *context.ranking;
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        const auto majors = ranking.DegreeMajors(weights.CatalogId(d));
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+        if (majors.first != majors.second) {
+            first = ranking.MajorQuestions(majors.first).first;
+            count = ranking.MajorQuestions(static_cast<std::uint16_t>(majors.second - 1)).second - first;
+        }
+        if (count > majorOutcomeQuestionLimit) {
+            std::cerr << weights.DegreeName(d) << " has more than " << majorOutcomeQuestionLimit
+                << " major questions; its major weights are not fitted\n";
+            count = 0;
+        }
+        context.degreeMajors.push_back(majors);
+        context.majorQuestionFirst.push_back(first);
+        context.majorQuestionCount.push_back(count);
+    }
+
+    std::size_t offset = 0;
+    std::uint64_t firstLine = 1;
+    const std::size_t firstEnd = std::min(context.text.find('\n'), context.text.size());
+    if (IsCohortHeader(context.text.substr(0, firstEnd))) {
+        offset = std::min(firstEnd + 1, context.text.size());
+        firstLine++;
+    }
+    std::vector<TrainingChunk> chunks;
+    while (offset < context.text.size()) {
+        TrainingChunk chunk;
+        chunk.begin = offset;
+        chunk.end = std::min(offset + trainingChunkBytes, context.text.size());
+        const std::size_t lineEnd = context.text.find('\n', chunk.end);
+        chunk.end = chunk.end == context.text.size() || lineEnd == std::string_view::npos ?
+            context.text.size() : lineEnd + 1;
+        offset = chunk.end;
+        chunks.push_back(std::move(chunk));
+    }
+
+    threadCount = std::max(1, threadCount);
+    TrainingCounts total;
+    total.Reset(context);
+    std::mutex totalMutex;
+    const auto begin = std::chrono::steady_clock::now();
+    {
+        // Counts add up the same in any order, so chunks need not finish in turn.
+        WorkStealingPool pool(threadCount);
+        for (TrainingChunk& chunk : chunks) {
+            pool.Submit([&context, &chunk, &total, &totalMutex, &input]() {
+                TrainingCounts counts;
+                counts.Reset(context);
+                ParseTrainingChunk(context, chunk, counts);
+                input.Release(chunk.begin, chunk.end - chunk.begin);
+                std::lock_guard<std::mutex> lock(totalMutex);
+                total.Add(counts);
+            });
+        }
+    }
+    const double parseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::uint64_t rejected = 0;
+    std::uint64_t line = firstLine;
+    for (const TrainingChunk& chunk : chunks) {
+        for (const TrainingError& rowError : chunk.errors) {
+            if (rejected++ < trainingErrorLimit) {
+                std::cerr << recordsPath << ":" << line + rowError.line << ": " << rowError.message << "\n";
+            }
+        }
+        rejected += chunk.rejected - chunk.errors.size();
+        line += chunk.lines;
+    }
+    if (rejected > trainingErrorLimit) {
+        std::cerr << rejected - trainingErrorLimit << " more records rejected\n";
+    }
+    std::cout << "records=" << total.records << " skipped=" << total.skipped << " rejected=" << rejected
+        << " chunks=" << chunks.size() << " threads=" << threadCount << std::fixed << std::setprecision(3)
+        << " seconds=" << parseSeconds << " records_per_second=" << std::setprecision(0)
+        << (parseSeconds > 0 ? total.records / parseSeconds : 0.0) << "\n";
+    if (total.records == 0) {
+        std::cerr << "No records with a degree finished\n";
+        return 1;
+    }
+
+    const auto fitBegin = std::chrono::steady_clock::now();
+    std::ostringstream degreeText;
+    std::ostringstream majorText;
+    degreeText << "# Degree weights fitted by --train-weights to " << total.records << " records of " << recordsPath << "\n";
+    majorText << "# Major weights fitted by --train-weights to " << recordsPath << "\n";
+
+    SoftmaxProblem degreeProblem;
+    degreeProblem.features = degreeQuestionCount;
+    degreeProblem.classes = weights.DegreeCount();
+    degreeProblem.free.assign(degreeProblem.features * degreeProblem.classes, 1);
+    degreeProblem.counts = total.degrees;
+    std::vector<double> fitted;
+    int iterations = 0;
+    const double degreeLoss = FitSoftmax(degreeProblem, fitted, iterations);
+    // A question adds the same to every degree's score without changing any softmax, so
+    // each row is shifted to start from 0 and the weights stay positive like the built-in ones.
+    for (int k = 0; k < degreeQuestionCount; ++k) {
+        const auto row = fitted.begin() + k * degreeProblem.classes;
+        const double lowest = *std::min_element(row, row + degreeProblem.classes);
+        std::for_each(row, row + degreeProblem.classes, [lowest](double& weight) { weight -= lowest; });
+    }
+    const std::vector<long long> degreeWeights = ScaleTrainedWeights(fitted);
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        degreeText << (d ? "\t" : "") << weights.DegreeName(d);
+    }
+    degreeText << "\n";
+    for (int k = 0; k < degreeQuestionCount; ++k) {
+        for (std::size_t d = 0; d < degreeProblem.classes; ++d) {
+            degreeText << (d ? "\t" : "") << degreeWeights[k * degreeProblem.classes + d];
+        }
+        degreeText << "\n";
+    }
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(4) << "degrees: " << total.records << " records, " << iterations
+        << " iterations, loss " << degreeLoss << "\n";
+
+    std::vector<std::uint64_t> majorRecords(context.degreeMajors.size(), 0);
+    for (std::size_t d = 0; d < context.degreeMajors.size(); ++d) {
+        for (const std::uint64_t count : total.majors[d]) {
+            majorRecords[d] += count;
+        }
+        if (majorRecords[d] == 0) {
+            continue;
+        }
+        const auto majors = context.degreeMajors[d];
+        const std::uint32_t first = context.majorQuestionFirst[d];
+        SoftmaxProblem problem;
+        problem.features = context.majorQuestionCount[d];
+        problem.classes = majors.second - majors.first;
+        problem.free.assign(problem.features * problem.classes, 0);
+        for (std::uint16_t m = majors.first; m < majors.second; ++m) {
+            const auto questions = ranking.MajorQuestions(m);
+            for (std::uint32_t q = questions.first; q < questions.second; ++q) {
+                problem.free[(q - first) * problem.classes + (m - majors.first)] = 1;
+            }
+        }
+        problem.counts = total.majors[d];
+        const double loss = FitSoftmax(problem, fitted, iterations);
+        const std::vector<long long> scaled = ScaleTrainedWeights(fitted);
+        for (std::uint16_t m = majors.first; m < majors.second; ++m) {
+            const auto questions = ranking.MajorQuestions(m);
+            majorText << ranking.MajorName(m);
+            for (std::uint32_t q = questions.first; q < questions.second; ++q) {
+                majorText << "\t" << scaled[(q - first) * problem.classes + (m - majors.first)];
+            }
+            majorText << "\n";
+        }
+        report << weights.DegreeName(d) << " majors: " << majorRecords[d] << " records, " << iterations
+            << " iterations, loss " << loss << "\n";
+    }
+    const double fitSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - fitBegin).count();
+
+    if (!SaveTrainedWeights(degreeWeightsPath, degreeText.str(), error) ||
+        !SaveTrainedWeights(majorWeightsPath, majorText.str(), error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    // Load what was written, as --weights and --major-weights would, and see how often
+    // each set of weights recommends what the students went on to finish.
+    DegreeWeights fittedDegrees;
+    MajorRanking fittedMajors = ranking;
+    if (!fittedDegrees.Load(degreeWeightsPath, error) || !fittedMajors.LoadWeights(majorWeightsPath, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    std::cout << report.str() << std::fixed << std::setprecision(3) << "fit_seconds=" << fitSeconds << "\n";
+    std::cout << "Recommendations matching what was finished, weights in use -> fitted:\n" << std::setprecision(1);
+    std::cout << "  degrees: " << DegreeAgreement(weights, total.degrees, total.records) << "% -> "
+        << DegreeAgreement(fittedDegrees, total.degrees, total.records) << "%\n";
+    for (std::size_t d = 0; d < context.degreeMajors.size(); ++d) {
+        if (majorRecords[d] == 0) {
+            continue;
+        }
+        const auto majors = context.degreeMajors[d];
+        const std::uint32_t questions = context.majorQuestionCount[d];
+        std::cout << "  " << weights.DegreeName(d) << " majors: "
+            << MajorAgreement(ranking, majors, questions, total.majors[d], majorRecords[d]) << "% -> "
+            << MajorAgreement(fittedMajors, majors, questions, total.majors[d], majorRecords[d]) << "%\n";
+    }
+    std::cout << "Wrote " << degreeWeightsPath << " and " << majorWeightsPath << "\n";
+    return rejected == 0 ? 0 : 1;
+}
+
+// Draws an index from the softmax of `scores`.
+std::size_t DrawSoftmax(const int* scores, std::size_t count, std::mt19937_64& random, std::vector<double>& weights)
+{
+    const int top = *std::max_element(scores, scores + count);
+    weights.resize(count);
+    double sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        weights[i] = std::exp(static_cast<double>(scores[i] - top));
+        sum += weights[i];
+    }
+    double draw = static_cast<double>(random() >> 11) * 0x1.0p-53 * sum;
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        if (draw < weights[i]) {
+            return i;
+        }
+        draw -= weights[i];
+    }
+    return count - 1;
+}
+
+int MakeTrainingRecords(const std::string& path, std::uint64_t rows, std::uint64_t seed)
+{
+    const DegreeWeights& weights = ActiveDegreeWeights();
+    const MajorRanking& ranking = GetMajorRanking();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Cannot write " << path << "\n";
+        return 1;
+    }
+    std::string buffer = "student_id";
+    for (int k = 0; k < degreeQuestionCount; ++k) {
+        buffer += ",degree_q" + std::to_string(k + 1);
+    }
+    for (std::uint32_t q = 0; q < ranking.QuestionCount(); ++q) {
+        buffer += ",major_q" + std::to_string(q + 1);
+    }
+    buffer += ",degree,major\n";
+
+    std::vector<std::string> degreeFields;
+    for (std::size_t d = 0; d < weights.DegreeCount(); ++d) {
+        degreeFields.emplace_back();
+        AppendCsvField(degreeFields.back(), weights.DegreeName(d));
+    }
+    std::vector<std::string> majorFields;
+    for (std::uint16_t m = 0; m < ranking.MajorCount(); ++m) {
+        majorFields.emplace_back();
+        AppendCsvField(majorFields.back(), ranking.MajorName(m));
+    }
+    std::mt19937_64 random(seed);
+    const std::size_t answers = degreeQuestionCount + ranking.QuestionCount();
+    std::vector<std::uint64_t> words(ranking.AnswerWords());
+    std::vector<int> degreeScores(weights.Stride());
+    std::vector<int> majorScores(ranking.MajorCount());
+    std::vector<double> drawWeights;
+    for (std::uint64_t n = 0; n < rows; ++n) {
+        AppendCohortId(buffer, n);
+        AnswerMask mask = 0;
+        std::fill(words.begin(), words.end(), 0);
+        std::uint64_t bits = 0;
+        for (std::size_t a = 0; a < answers; ++a) {
+            if (a % 64 == 0) {
+                bits = random();
+            }
+            const std::uint64_t yes = (bits >> (a % 64)) & 1;
+            if (a < static_cast<std::size_t>(degreeQuestionCount)) {
+                mask |= static_cast<AnswerMask>(yes << a);
+            }
+            else {
+                words[(a - degreeQuestionCount) / 64] |= yes << ((a - degreeQuestionCount) % 64);
+            }
+            buffer += yes ? ",y" : ",n";
+        }
+        weights.Score(mask, degreeScores.data());
+        const std::size_t degree = DrawSoftmax(degreeScores.data(), weights.DegreeCount(), random, drawWeights);
+        buffer += ',';
+        buffer += degreeFields[degree];
+        buffer += ',';
+        const auto majors = ranking.DegreeMajors(weights.CatalogId(degree));
+        if (majors.first != majors.second) {
+            ranking.Score(words.data(), majorScores.data());
+            buffer += majorFields[majors.first +
+                DrawSoftmax(majorScores.data() + majors.first, majors.second - majors.first, random, drawWeights)];
+        }
+        buffer += '\n';
+        if (buffer.size() >= trainingChunkBytes) {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    if (!file) {
+        std::cerr << "Cannot write " << path << "\n";
+        return 1;
+    }
+    return 0;
+}
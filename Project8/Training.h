@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Fits the degree and major question weights to records of what students went on to
+// finish, by multinomial logistic regression.
+//
+// A record is a cohort row (see Cohort.h) followed by two more fields: the degree the
+// student finished, named as in the degree weights in use, and the major they finished,
+// which may be left empty. Records with an empty degree are skipped.
+//
+// The model is the scorer's own: a degree's score is the sum of the weights of the
+// questions answered "yes", and the chance of finishing each degree is the softmax of the
+// scores; likewise for majors among their degree's majors, each question weighing for its
+// own major only. Only the number of students per answer mask and outcome then matters,
+// so the records are parsed into those counts a chunk per task on a WorkStealingPool, and
+// the fit runs over the few thousand distinct masks, not the rows.
+//
+// The fitted weights are written as integers, scaled so the largest is trainedWeightScale:
+// degree weights in the --weights format, each question's row shifted so its smallest
+// weight is 0 (which leaves every softmax as it was), and major weights in the
+// --major-weights format, for the majors of every degree some record finished.
+const int trainedWeightScale = 100;
+// L2 penalty on the weights, added to the mean loss per student; it keeps them finite when
+// an answer always goes with the same outcome.
+const double trainingPenalty = 1e-4;
+
+// A softmax model over `features` yes/no answers and `classes` outcomes: the score of
+// class c is the sum of weights[k * classes + c] over the answers k that are "yes".
+// Weights whose `free` entry is 0 stay 0.
+struct SoftmaxProblem
+{
+    std::size_t features = 0;
+    std::size_t classes = 0;
+    std::vector<std::uint8_t> free;     // features x classes
+    std::vector<std::uint64_t> counts;  // (1 << features) x classes: students per mask and outcome
+};
+
+// Minimises the mean negative log-likelihood plus the penalty; returns it, with the
+// iterations taken.
+double FitSoftmax(const SoftmaxProblem& problem, std::vector<double>& weights, int& iterations);
+
+int TrainWeights(const std::string& recordsPath, const std::string& degreeWeightsPath,
+    const std::string& majorWeightsPath, int threadCount);
+
+// Writes `rows` records with made-up answers, the degree and major drawn from the softmax
+// of the weights in use, so a fit of them should give those weights back in proportion.
+int MakeTrainingRecords(const std::string& path, std::uint64_t rows, std::uint64_t seed);
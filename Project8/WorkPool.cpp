@@ -0,0 +1,107 @@
+#include "WorkPool.h"
+
+#include <algorithm>
+#include <utility>
+
+// The pool and index of the worker running on this thread, if any.
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local std::size_t currentWorker = 0;
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : nextQueue(0), queued(0), stopping(false)
+{
+    const std::size_t count = static_cast<std::size_t>(std::max(1, threadCount));
+    for (std::size_t w = 0; w < count; ++w) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (std::size_t w = 0; w < count; ++w) {
+        workers.emplace_back([this, w]() { WorkerLoop(w); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::Submit(std::function<void()> task)
+{
+    const std::size_t worker = currentPool == this ? currentWorker : nextQueue++ % queues.size();
+    // Counted before it can be taken, so a worker that takes it at once never brings
+    // `queued` below zero; until it is pushed, a worker woken for it just retries.
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queued++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[worker]->mutex);
+        queues[worker]->tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+std::size_t WorkStealingPool::ThreadCount() const
+{
+    return workers.size();
+}
+
+// The newest task of the worker's own queue, or else the oldest of the next queue that
+// has one.
+bool WorkStealingPool::TakeTask(std::size_t worker, std::function<void()>& task)
+{
+    {
+        WorkerQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (std::size_t i = 1; i < queues.size(); ++i) {
+        WorkerQueue& other = *queues[(worker + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::WorkerLoop(std::size_t worker)
+{
+    currentPool = this;
+    currentWorker = worker;
+    std::function<void()> task;
+    while (true) {
+        {
+            // A task is counted in `queued` until someone takes it, so a worker only
+            // sleeps when every queue is empty.
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [&]() { return stopping || queued > 0; });
+            if (queued == 0) {
+                return;
+            }
+        }
+        if (!TakeTask(worker, task)) {
+            // Another worker got there first.
+            std::this_thread::yield();
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued--;
+        }
+        task();
+        task = nullptr;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads, each with its own queue of tasks. A worker runs the
+// newest task of its own queue first, which is the one whose data is most likely still in
+// its cache; when that is empty it takes the oldest task of another worker's queue, so a
+// worker stuck on slow tasks does not leave the rest idle. Tasks submitted by a worker go
+// to its own queue; tasks submitted from outside are dealt out in turn.
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(int threadCount);
+    // Runs every task already submitted, then stops the workers.
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void Submit(std::function<void()> task);
+    std::size_t ThreadCount() const;
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool TakeTask(std::size_t worker, std::function<void()>& task);
+    void WorkerLoop(std::size_t worker);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> nextQueue;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::size_t queued;  // tasks in any queue; guarded by sleepMutex
+    bool stopping;
+};